@@ -52,6 +52,7 @@
 #include "dbLockPvt.h"
 #include "dbNotify.h"
 #include "dbScan.h"
+#include "dbSeqlockPvt.h"
 #include "dbServer.h"
 #include "dbStaticLib.h"
 #include "dbStaticPvt.h"
@@ -809,6 +810,39 @@ int dbLoadRecords(const char* file, const char* subs)
     return status;
 }
 
+int dbLoadSnapshot(const char *snapshot, const char* file, const char* subs)
+{
+    long status;
+
+    if (!snapshot) {
+        printf("Usage: dbLoadSnapshot \"snapshot\", \"file\", \"subs\"\n");
+        return -1;
+    }
+    status = dbReadSnapshot(pdbbase, snapshot);
+    if (status == 0) {
+        if (dbLoadRecordsHook)
+            dbLoadRecordsHook(snapshot, NULL);
+        return 0;
+    }
+    if (status == -2) {
+        fprintf(stderr, ERL_ERROR " Records cannot be loaded after iocInit!\n");
+        return -2;
+    }
+    if (status != S_dbLib_badSnapshot) {
+        /* Some records were created, loading the file on top could fail */
+        fprintf(stderr, ERL_ERROR " failed to load snapshot '%s'\n", snapshot);
+        return -1;
+    }
+
+    if (!file) {
+        fprintf(stderr, ERL_ERROR " failed to load snapshot '%s'\n", snapshot);
+        return -1;
+    }
+    /* Snapshot missing or out of date, load the original database */
+    printf("dbLoadSnapshot: Loading '%s' instead of '%s'\n", file, snapshot);
+    return dbLoadRecords(file, subs);
+}
+
 
 static long getLinkValue(DBADDR *paddr, short dbrType,
     char *pbuf, long *nRequest)
@@ -896,6 +930,10 @@ long dbGetField(DBADDR *paddr,short dbrType,
     dbCommon *precord = paddr->precord;
     long status = 0;
 
+    if (!pflin && dbRec2Pvt(precord)->seqlock &&
+        !dbSeqlockGetField(paddr, dbrType, pbuffer, options, nRequest))
+        return 0;
+
     dbScanLock(precord);
     status = dbGet(paddr, dbrType, pbuffer, options, nRequest, pflin);
     dbScanUnlock(precord);
@@ -1394,6 +1432,7 @@ long dbPut(DBADDR *paddr, short dbrType,
      */
     if (precord->mlis.count && pfldDes->prop)
         db_post_events(precord, NULL, DBE_PROPERTY);
+    dbSeqlockUpdate(precord);
 done:
     paddr->pfield = pfieldsave;
     return status;
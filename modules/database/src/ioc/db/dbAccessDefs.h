@@ -29,6 +29,7 @@ extern "C" {
 DBCORE_API extern struct dbBase *pdbbase;
 DBCORE_API extern volatile int interruptAccept;
 DBCORE_API extern int dbAccessDebugPUTF;
+DBCORE_API extern int dbSeqlockReads;
 
 /*  The database field and request types are defined in dbFldTypes.h*/
 /* Data Base Request Options    */
@@ -274,6 +275,8 @@ DBCORE_API int  dbLoadDatabase(
     const char *filename, const char *path, const char *substitutions);
 DBCORE_API int dbLoadRecords(
     const char* filename, const char* substitutions);
+DBCORE_API int dbLoadSnapshot(const char *snapshot,
+    const char* filename, const char* substitutions);
 
 #ifdef __cplusplus
 }
@@ -25,8 +25,10 @@
 #include "epicsAssert.h"
 #include "epicsEvent.h"
 #include "epicsExit.h"
+#include "epicsExport.h"
 #include "epicsMutex.h"
 #include "epicsPrint.h"
+#include "epicsStdio.h"
 #include "epicsString.h"
 #include "epicsThread.h"
 #include "epicsAtomic.h"
@@ -61,18 +63,20 @@
 extern void dbServiceIOInit();
 extern int dbServiceIsolate;
 
-static ELLLIST workList = ELLLIST_INIT;    /* Work list for dbCaTask */
-static epicsMutexId workListLock; /*Mutual exclusions semaphores for workList*/
-static epicsEventId workListEvent; /*wakeup event for dbCaTask*/
-static int removesOutstanding = 0;
+/* Number of dbCa worker threads, <0 means one per CPU */
+int dbCaLinkWorkers = 1;
+epicsExportAddress(int, dbCaLinkWorkers);
+
+/* Links are shared between the workers by a hash of their target name */
+caWorker *dbCaWorkerList;
+unsigned dbCaNumWorkers;
 #define removesOutstandingWarning 10000
 
 static volatile enum dbCaCtl_t {
     ctlInit, ctlRun, ctlPause, ctlExit
 } dbCaCtl;
-static epicsEventId startStopEvent;
-static epicsThreadId dbCaWorker;
 
+/* The CA client context of the first worker */
 struct ca_client_context * dbCaClientContext;
 
 /* Forward declarations */
@@ -84,15 +88,15 @@ static lset dbCa_lset;
     errlogPrintf("%s has DB CA link to %s\n",\
         pcaLink->plink->precord->name, pcaLink->pvname)
 
-static int dbca_chan_count;
-
 /* caLink locking
  *
  * Lock ordering:
  *  dbScanLock -> caLink.lock -> workListLock
  *
  * workListLock:
- *   Guards access to workList.
+ *   Guards access to the workList of one caWorker. A caLink is assigned
+ *   to one worker when it's created and never moves, and no thread holds
+ *   more than one workListLock at once.
  *
  * dbScanLock:
  *   All dbCa* functions operating on a single link may only be called when
@@ -110,7 +114,7 @@ static int dbca_chan_count;
  * caLink.lock:
  *   Guards the caLink structure (but not the struct DBLINK)
  *
- * The dbCaTask only locks caLink, and must not lock the record (a violation of lock order).
+ * The dbCaTask threads only lock caLink, and must not lock the record (a violation of lock order).
  *
  * During link modification or IOC shutdown the pca->plink pointer (guarded by caLink.lock)
  * is used as a flag to indicate that a link is no longer active.
@@ -130,9 +134,10 @@ static int dbca_chan_count;
 
 static void addAction(caLink *pca, short link_action)
 {
+    caWorker *pw = pca->worker;
     int callAdd;
 
-    epicsMutexMustLock(workListLock);
+    epicsMutexMustLock(pw->workListLock);
     callAdd = (pca->link_action == 0);
     if (pca->link_action & CA_CLEAR_CHANNEL) {
         errlogPrintf("dbCa::addAction %d with CA_CLEAR_CHANNEL set\n",
@@ -141,22 +146,22 @@ static void addAction(caLink *pca, short link_action)
         link_action = 0;
     }
     if (link_action & CA_CLEAR_CHANNEL) {
-        if (++removesOutstanding >= removesOutstandingWarning) {
+        if (++pw->removesOutstanding >= removesOutstandingWarning) {
             errlogPrintf("dbCa::addAction pausing, %d channels to clear\n",
-                removesOutstanding);
+                pw->removesOutstanding);
         }
-        while (removesOutstanding >= removesOutstandingWarning) {
-            epicsMutexUnlock(workListLock);
+        while (pw->removesOutstanding >= removesOutstandingWarning) {
+            epicsMutexUnlock(pw->workListLock);
             epicsThreadSleep(1.0);
-            epicsMutexMustLock(workListLock);
+            epicsMutexMustLock(pw->workListLock);
         }
     }
     pca->link_action |= link_action;
     if (callAdd)
-        ellAdd(&workList, &pca->node);
-    epicsMutexUnlock(workListLock);
+        ellAdd(&pw->workList, &pca->node);
+    epicsMutexUnlock(pw->workListLock);
     if (callAdd)
-        epicsEventSignal(workListEvent);
+        epicsEventSignal(pw->workListEvent);
 }
 
 static void caLinkInc(caLink *pca)
@@ -178,7 +183,7 @@ static void caLinkDec(caLink *pca)
 
     if (pca->chid) {
         ca_clear_channel(pca->chid);
-        --dbca_chan_count;
+        epicsAtomicDecrIntT(&pca->worker->chanCount);
     }
     callback = pca->putCallback;
     if (callback) {
@@ -267,10 +272,7 @@ void testdbCaWaitForUpdateCount(DBLINK *plink, unsigned long cnt)
     testdbCaWaitForEvent(plink, cnt, testEventCount);
 }
 
-/* Block until worker thread has processed all previously queued actions.
- * Does not prevent additional actions from being queued.
- */
-void dbCaSync(void)
+static void workerSync(caWorker *pw)
 {
     epicsEventId wake;
     caLink templink;
@@ -281,6 +283,7 @@ void dbCaSync(void)
      */
     memset(&templink, 0, sizeof(templink));
     templink.refcount = 1;
+    templink.worker = pw;
 
     wake = epicsEventMustCreate(epicsEventEmpty);
     templink.lock = epicsMutexMustCreate();
@@ -294,12 +297,23 @@ void dbCaSync(void)
      * we hold workListLock to ensure worker call to
      * epicsEventMustTrigger() returns before we destroy the event.
      */
-    epicsMutexMustLock(workListLock);
+    epicsMutexMustLock(pw->workListLock);
     assert(templink.refcount==1);
 
     epicsMutexDestroy(templink.lock);
     epicsEventDestroy(wake);
-    epicsMutexUnlock(workListLock);
+    epicsMutexUnlock(pw->workListLock);
+}
+
+/* Block until the worker threads have processed all previously queued
+ * actions. Does not prevent additional actions from being queued.
+ */
+void dbCaSync(void)
+{
+    unsigned i;
+
+    for (i = 0; i < dbCaNumWorkers; i++)
+        workerSync(&dbCaWorkerList[i]);
 }
 
 void dbCaCallbackProcess(void *userPvt)
@@ -309,20 +323,55 @@ void dbCaCallbackProcess(void *userPvt)
     dbLinkAsyncComplete(plink);
 }
 
+static void signalWorkers(void)
+{
+    unsigned i;
+
+    for (i = 0; i < dbCaNumWorkers; i++)
+        epicsEventSignal(dbCaWorkerList[i].workListEvent);
+}
+
 void dbCaShutdown(void)
 {
     enum dbCaCtl_t cur = dbCaCtl;
+    unsigned i;
+
     assert(cur == ctlRun || cur == ctlPause);
     dbCaCtl = ctlExit;
-    epicsEventSignal(workListEvent);
-    epicsEventMustWait(startStopEvent);
-    if(dbCaWorker)
-        epicsThreadMustJoin(dbCaWorker);
+    signalWorkers();
+    for (i = 0; i < dbCaNumWorkers; i++) {
+        caWorker *pw = &dbCaWorkerList[i];
+
+        epicsEventMustWait(pw->startStopEvent);
+        if (pw->thread)
+            epicsThreadMustJoin(pw->thread);
+        pw->thread = NULL;
+    }
+}
+
+static void freeWorkers(void)
+{
+    unsigned i;
+
+    for (i = 0; i < dbCaNumWorkers; i++) {
+        caWorker *pw = &dbCaWorkerList[i];
+
+        assert(!pw->thread && ellCount(&pw->workList) == 0);
+        epicsMutexDestroy(pw->workListLock);
+        epicsEventDestroy(pw->workListEvent);
+        epicsEventDestroy(pw->startStopEvent);
+    }
+    free(dbCaWorkerList);
+    dbCaWorkerList = NULL;
+    dbCaNumWorkers = 0;
 }
 
 static void dbCaLinkInitImpl(int isolate)
 {
     epicsThreadOpts opts = EPICS_THREAD_OPTS_INIT;
+    unsigned nworkers = dbCaLinkWorkers > 0 ? dbCaLinkWorkers :
+        dbCaLinkWorkers < 0 ? epicsThreadGetCPUs() : 1;
+    unsigned i;
 
     opts.stackSize = epicsThreadGetStackSize(epicsThreadStackBig);
     opts.priority = epicsThreadPriorityMedium;
@@ -331,18 +380,35 @@ static void dbCaLinkInitImpl(int isolate)
     dbServiceIsolate = isolate;
     dbServiceIOInit();
 
-    if (!workListLock)
-        workListLock = epicsMutexMustCreate();
-    if (!workListEvent)
-        workListEvent = epicsEventMustCreate(epicsEventEmpty);
+    if (dbCaNumWorkers != nworkers) {
+        freeWorkers();
+        dbCaWorkerList = dbCalloc(nworkers, sizeof(caWorker));
+        for (i = 0; i < nworkers; i++) {
+            caWorker *pw = &dbCaWorkerList[i];
 
-    if(!startStopEvent)
-        startStopEvent = epicsEventMustCreate(epicsEventEmpty);
+            pw->index = i;
+            pw->workListLock = epicsMutexMustCreate();
+            pw->workListEvent = epicsEventMustCreate(epicsEventEmpty);
+            pw->startStopEvent = epicsEventMustCreate(epicsEventEmpty);
+        }
+        dbCaNumWorkers = nworkers;
+    }
     dbCaCtl = ctlPause;
 
-    dbCaWorker = epicsThreadCreateOpt("dbCaLink", dbCaTask, NULL, &opts);
-    /* wait for worker to startup and initialize dbCaClientContext */
-    epicsEventMustWait(startStopEvent);
+    for (i = 0; i < nworkers; i++) {
+        caWorker *pw = &dbCaWorkerList[i];
+        char name[20];
+
+        if (nworkers == 1)
+            strcpy(name, "dbCaLink");
+        else
+            epicsSnprintf(name, sizeof(name), "dbCaLink%u", i);
+        pw->thread = epicsThreadCreateOpt(name, dbCaTask, pw, &opts);
+    }
+    /* wait for workers to startup and create their CA contexts */
+    for (i = 0; i < nworkers; i++)
+        epicsEventMustWait(dbCaWorkerList[i].startStopEvent);
+    dbCaClientContext = dbCaWorkerList[0].context;
 }
 
 void dbCaLinkInitIsolated(void)
@@ -359,7 +425,7 @@ void dbCaRun(void)
 {
     if (dbCaCtl == ctlPause) {
         dbCaCtl = ctlRun;
-        epicsEventSignal(workListEvent);
+        signalWorkers();
     }
 }
 
@@ -367,7 +433,7 @@ void dbCaPause(void)
 {
     if (dbCaCtl == ctlRun) {
         dbCaCtl = ctlPause;
-        epicsEventSignal(workListEvent);
+        signalWorkers();
     }
 }
 
@@ -383,6 +449,9 @@ void dbCaAddLinkCallback(struct link *plink,
     pca->lock = epicsMutexMustCreate();
     pca->plink = plink;
     pca->pvname = epicsStrDup(plink->value.pv_link.pvname);
+    assert(dbCaNumWorkers > 0);
+    pca->worker = &dbCaWorkerList[
+        epicsStrHash(pca->pvname, 0) % dbCaNumWorkers];
     pca->connect = connect;
     pca->monitor = monitor;
     pca->userPvt = userPvt;
@@ -1119,33 +1188,34 @@ static void getAttribEventCallback(struct event_handler_args arg)
 
 static void dbCaTask(void *arg)
 {
+    caWorker *pw = (caWorker *)arg;
     epicsEventId requestSync = NULL;
     taskwdInsert(0, NULL, NULL);
     SEVCHK(ca_context_create(ca_enable_preemptive_callback),
         "dbCaTask calling ca_context_create");
-    dbCaClientContext = ca_current_context ();
+    pw->context = ca_current_context ();
     SEVCHK(ca_add_exception_event(exceptionCallback,NULL),
         "ca_add_exception_event");
-    epicsEventSignal(startStopEvent);
+    epicsEventSignal(pw->startStopEvent);
 
     /* channel access event loop */
     while (TRUE){
         do {
-            epicsEventMustWait(workListEvent);
+            epicsEventMustWait(pw->workListEvent);
         } while (dbCaCtl == ctlPause);
         while (TRUE) { /* process all requests in workList*/
             caLink *pca;
             short  link_action;
             int    status;
 
-            epicsMutexMustLock(workListLock);
-            if (!(pca = (caLink *)ellGet(&workList))){  /* Take off list head */
+            epicsMutexMustLock(pw->workListLock);
+            if (!(pca = (caLink *)ellGet(&pw->workList))){  /* Take off list head */
                 if(requestSync) {
                     /* dbCaSync() requires workListLock to be held here */
                     epicsEventMustTrigger(requestSync);
                     requestSync = NULL;
                 }
-                epicsMutexUnlock(workListLock);
+                epicsMutexUnlock(pw->workListLock);
                 if (dbCaCtl == ctlExit) goto shutdown;
                 break; /* workList is empty */
             }
@@ -1155,10 +1225,11 @@ static void dbCaTask(void *arg)
                 requestSync = pca->userPvt;
             }
             pca->link_action = 0;
-            if (link_action & CA_CLEAR_CHANNEL) --removesOutstanding;
-            epicsMutexUnlock(workListLock);         /* Give back immediately */
+            if (link_action & CA_CLEAR_CHANNEL) --pw->removesOutstanding;
+            epicsMutexUnlock(pw->workListLock);     /* Give back immediately */
             if (link_action&CA_SYNC)
                 continue;
+            pw->nActions++;
             if (link_action & CA_CLEAR_CHANNEL) {   /* This must be first */
                 caLinkDec(pca);
                 /* No alarm is raised. Since link is changing so what? */
@@ -1174,7 +1245,7 @@ static void dbCaTask(void *arg)
                     printLinks(pca);
                     continue;
                 }
-                dbca_chan_count++;
+                epicsAtomicIncrIntT(&pw->chanCount);
                 status = ca_replace_access_rights_event(pca->chid,
                     accessRightsCallback);
                 if (status != ECA_NORMAL) {
@@ -1278,9 +1349,10 @@ static void dbCaTask(void *arg)
     }
 shutdown:
     taskwdRemove(0);
-    if (dbca_chan_count == 0)
+    if (pw->chanCount == 0)
         ca_context_destroy();
     else
-        fprintf(stderr, "dbCa: chan_count = %d at shutdown\n", dbca_chan_count);
-    epicsEventSignal(startStopEvent);
+        fprintf(stderr, "dbCa: chan_count = %d at shutdown\n", pw->chanCount);
+    pw->context = NULL;
+    epicsEventSignal(pw->startStopEvent);
 }
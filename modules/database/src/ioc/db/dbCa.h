@@ -47,6 +47,10 @@ DBCORE_API long dbCaPutLink(struct link *plink,short dbrType,
 
 extern struct ca_client_context * dbCaClientContext;
 
+/* Number of dbCa worker threads to start, <0 means one per CPU.
+ * Must be set before iocInit. */
+DBCORE_API extern int dbCaLinkWorkers;
+
 #ifdef EPICS_DBCA_PRIVATE_API
 /* Wait CA link work queue to become empty.  eg. after from dbPut() to OUT */
 DBCORE_API void dbCaSync(void);
@@ -18,7 +18,9 @@
 
 #include "dbCa.h"
 #include "ellLib.h"
+#include "epicsEvent.h"
 #include "epicsMutex.h"
+#include "epicsThread.h"
 #include "epicsTypes.h"
 #include "link.h"
 
@@ -35,10 +37,30 @@
 #define CA_PUT          0x1
 #define CA_PUT_CALLBACK 0x2
 
+/* A dbCa worker thread with its own CA client context */
+typedef struct caWorker
+{
+    ELLLIST         workList;       /* caLinks with actions pending */
+    epicsMutexId    workListLock;
+    epicsEventId    workListEvent;  /* wakeup event for dbCaTask */
+    epicsEventId    startStopEvent;
+    epicsThreadId   thread;
+    struct ca_client_context *context;
+    unsigned        index;
+    int             removesOutstanding;
+    int             chanCount;
+    /* The following are for dbcar*/
+    unsigned long   nActions;       /* link actions processed */
+}caWorker;
+
+extern caWorker *dbCaWorkerList;
+extern unsigned dbCaNumWorkers;
+
 typedef struct caLink
 {
     ELLNODE         node;
     int             refcount;
+    caWorker        *worker;
     epicsMutexId    lock;
     struct link     *plink;
     char            *pvname;
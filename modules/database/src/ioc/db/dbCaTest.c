@@ -21,6 +21,7 @@
 #include <string.h>
 #include <errno.h>
 
+#include "cantProceed.h"
 #include "dbDefs.h"
 #include "epicsEvent.h"
 #include "epicsPrint.h"
@@ -68,6 +69,9 @@ long dbcar(char *precordname, int level)
     unsigned long       nNoWrite=0;
     caLink              *pca;
     int                 j;
+    unsigned            i;
+    int                 *wlinks = NULL;     /* per worker */
+    int                 *wconnected = NULL;
 
     if (!precordname || precordname[0] == '\0' || !strcmp(precordname, "*")) {
         precordname = NULL;
@@ -75,6 +79,10 @@ long dbcar(char *precordname, int level)
     } else {
         printf("CA links in record named '%s'\n\n", precordname);
     }
+    if (dbCaNumWorkers > 1) {
+        wlinks = callocMustSucceed(2 * dbCaNumWorkers, sizeof(int), "dbcar");
+        wconnected = wlinks + dbCaNumWorkers;
+    }
     dbInitEntry(pdbbase,pdbentry);
     status = dbFirstRecordType(pdbentry);
     while (!status) {
@@ -92,10 +100,14 @@ long dbcar(char *precordname, int level)
                     if (plink->type == CA_LINK) {
                         ncalinks++;
                         pca = (caLink *)plink->value.pv_link.pvt;
+                        if (wlinks && pca)
+                            wlinks[pca->worker->index]++;
                         if (pca
                         && pca->chid
                         && (ca_field_type(pca->chid) != TYPENOTCONN)) {
                             nconnected++;
+                            if (wconnected)
+                                wconnected[pca->worker->index]++;
                             nDisconnect += pca->nDisconnect;
                             nNoWrite += pca->nNoWrite;
                             if (!ca_read_access(pca->chid)) noReadAccess++;
@@ -154,8 +166,27 @@ done:
            nDisconnect, nNoWrite);
     dbFinishEntry(pdbentry);
 
-    if ( level > 2  && dbCaClientContext != 0 ) {
-        ca_context_status ( dbCaClientContext, level - 2 );
+    for (i = 0; wlinks && i < dbCaNumWorkers; i++) {
+        caWorker *pw = &dbCaWorkerList[i];
+        int queued;
+
+        epicsMutexMustLock(pw->workListLock);
+        queued = ellCount(&pw->workList);
+        epicsMutexUnlock(pw->workListLock);
+        printf("Worker %u: %d CA link%s, %d connected, %d queued,"
+               " %lu actions done\n", i,
+               wlinks[i], (wlinks[i] != 1) ? "s" : "",
+               wconnected[i], queued, pw->nActions);
+    }
+    if (wlinks) printf("\n");
+    free(wlinks);
+
+    for (i = 0; level > 2 && i < dbCaNumWorkers; i++) {
+        if (dbCaWorkerList[i].context) {
+            if (dbCaNumWorkers > 1)
+                printf("Worker %u:\n", i);
+            ca_context_status(dbCaWorkerList[i].context, level - 2);
+        }
     }
 
     return(0);
@@ -202,3 +233,53 @@ void dbcaStats(int *pchans, int *pdiscon)
     if (pchans)  *pchans  = ncalinks;
     if (pdiscon) *pdiscon = ncalinks - nconnected;
 }
+
+unsigned dbcaWorkerStats(unsigned nmax, int *pchans, int *pdiscon)
+{
+    DBENTRY     dbentry;
+    DBENTRY     *pdbentry = &dbentry;
+    long        status;
+    unsigned    i;
+
+    for (i = 0; i < nmax; i++) {
+        if (pchans)  pchans[i] = 0;
+        if (pdiscon) pdiscon[i] = 0;
+    }
+
+    dbInitEntry(pdbbase,pdbentry);
+    status = dbFirstRecordType(pdbentry);
+    while (!status) {
+        dbRecordType *pdbRecordType = pdbentry->precordType;
+
+        status = dbFirstRecord(pdbentry);
+        while (!status) {
+            dbCommon *precord = (dbCommon *)pdbentry->precnode->precord;
+            int j;
+
+            if (!dbIsAlias(pdbentry)) {
+                dbScanLock(precord);
+                for (j=0; j<pdbRecordType->no_links; j++) {
+                    int k = pdbRecordType->link_ind[j];
+                    dbFldDes *pdbFldDes = pdbRecordType->papFldDes[k];
+                    DBLINK *plink = (DBLINK *)((char *)precord + pdbFldDes->offset);
+                    caLink *pca;
+
+                    if (plink->type != CA_LINK)
+                        continue;
+                    pca = (caLink *)plink->value.pv_link.pvt;
+                    if (!pca || pca->worker->index >= nmax)
+                        continue;
+                    if (pchans)
+                        pchans[pca->worker->index]++;
+                    if (pdiscon && !dbCaIsLinkConnected(plink))
+                        pdiscon[pca->worker->index]++;
+                }
+                dbScanUnlock(precord);
+            }
+            status = dbNextRecord(pdbentry);
+        }
+        status = dbNextRecordType(pdbentry);
+    }
+    dbFinishEntry(pdbentry);
+    return dbCaNumWorkers;
+}
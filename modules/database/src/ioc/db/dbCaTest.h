@@ -19,6 +19,9 @@ extern "C" {
 
 DBCORE_API long dbcar(char *recordname,int level);
 DBCORE_API void dbcaStats(int *pchans, int *pdiscon);
+/* Fills in per-worker counts for the first nmax dbCa worker threads,
+ * returns the number of workers. */
+DBCORE_API unsigned dbcaWorkerStats(unsigned nmax, int *pchans, int *pdiscon);
 
 #ifdef __cplusplus
 }
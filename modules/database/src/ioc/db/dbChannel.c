@@ -22,6 +22,7 @@
 
 #include "cantProceed.h"
 #include "epicsAssert.h"
+#include "epicsMutex.h"
 #include "epicsString.h"
 #include "epicsStdio.h"
 #include "errlog.h"
@@ -35,16 +36,51 @@
 #include "dbCommon.h"
 #include "dbEvent.h"
 #include "dbLock.h"
+#include "dbSeqlockPvt.h"
 #include "dbStaticLib.h"
 #include "link.h"
 #include "recSup.h"
 #include "special.h"
 #include "alarm.h"
+#include "epicsExport.h"
+
+/* Parser events, recorded so they can be replayed for a cached name */
+typedef enum {
+    chfOpNull, chfOpBoolean, chfOpInteger, chfOpDouble, chfOpString,
+    chfOpStartMap, chfOpMapKey, chfOpEndMap, chfOpStartArray, chfOpEndArray
+} chfOpType;
+
+typedef struct chfOp {
+    chfOpType type;
+    size_t len;
+    union {
+        int b;
+        long long i;
+        double d;
+        char *s;
+    } val;
+} chfOp;
+
+/* The parsed form of a channel name */
+typedef struct chCacheEntry {
+    ELLNODE node;       /* in cacheList, most recently used first */
+    char *name;
+    unsigned generation;
+    dbRecordNode *precnode;
+    dbFldDes *pflddes;
+    void *pfield;
+    int dollar;
+    int failed;         /* recording is incomplete */
+    int nops;
+    int maxops;
+    chfOp *ops;
+} chCacheEntry;
 
 typedef struct parseContext {
     dbChannel *chan;
     chFilter *filter;
     int depth;
+    chCacheEntry *record;
 } parseContext;
 
 #define CALLIF(rtn) !rtn ? parse_stop : rtn
@@ -52,8 +88,29 @@ typedef struct parseContext {
 static void *dbChannelFreeList;
 static void *chFilterFreeList;
 
+int dbChannelCacheSize = 1024;
+epicsExportAddress(int, dbChannelCacheSize);
+
+static epicsMutexId cacheLock;
+static ELLLIST cacheList = ELLLIST_INIT;
+static struct gphPvt *cacheHash;
+static dbBase *cacheBase;
+static unsigned cacheGeneration;
+static dbChannelCacheStats cacheStats;
+
+static void cacheFlush(void);
+
 void dbChannelExit(void)
 {
+    if (cacheLock) {
+        epicsMutexMustLock(cacheLock);
+        cacheFlush();
+        gphFreeMem(cacheHash);
+        cacheHash = NULL;
+        epicsMutexUnlock(cacheLock);
+        epicsMutexDestroy(cacheLock);
+        cacheLock = NULL;
+    }
     freeListCleanup(dbChannelFreeList);
     freeListCleanup(chFilterFreeList);
     dbChannelFreeList = chFilterFreeList = NULL;
@@ -67,6 +124,59 @@ void dbChannelInit (void)
     freeListInitPvt(&dbChannelFreeList,  sizeof(dbChannel), 128);
     freeListInitPvt(&chFilterFreeList,  sizeof(chFilter), 64);
     db_init_event_freelists();
+    cacheLock = epicsMutexMustCreate();
+    gphInitPvt(&cacheHash, 1024);
+}
+
+static chfOp * chf_record(chCacheEntry *pce, chfOpType type)
+{
+    chfOp *op;
+
+    if (!pce || pce->failed)
+        return NULL;
+
+    if (pce->nops == pce->maxops) {
+        int maxops = pce->maxops ? 2 * pce->maxops : 16;
+        chfOp *ops = realloc(pce->ops, maxops * sizeof(chfOp));
+
+        if (!ops) {
+            pce->failed = 1;
+            return NULL;
+        }
+        pce->ops = ops;
+        pce->maxops = maxops;
+    }
+    op = &pce->ops[pce->nops++];
+    op->type = type;
+    op->len = 0;
+    op->val.s = NULL;
+    return op;
+}
+
+static void chf_record_string(chCacheEntry *pce, chfOpType type,
+    const char *str, size_t len)
+{
+    char *copy;
+    chfOp *op;
+
+    if (!pce || pce->failed)
+        return;
+
+    copy = malloc(len + 1);
+    if (!copy) {
+        pce->failed = 1;
+        return;
+    }
+    memcpy(copy, str, len);
+    copy[len] = 0;
+
+    op = chf_record(pce, type);
+    if (!op) {
+        free(copy);
+        return;
+    }
+    op->val.s = copy;
+    op->len = len;
 }
 
 static void chf_value(parseContext *parser, parse_result *presult)
@@ -91,6 +201,7 @@ static int chf_null(void * ctx)
     chFilter *filter = parser->filter;
     parse_result result;
 
+    chf_record(parser->record, chfOpNull);
     assert(filter);
     result = CALLIF(filter->plug->fif->parse_null)(filter );
     chf_value(parser, &result);
@@ -102,7 +213,10 @@ static int chf_boolean(void * ctx, int boolVal)
     parseContext *parser = (parseContext *) ctx;
     chFilter *filter = parser->filter;
     parse_result result;
+    chfOp *op = chf_record(parser->record, chfOpBoolean);
 
+    if (op)
+        op->val.b = boolVal;
     assert(filter);
     result = CALLIF(filter->plug->fif->parse_boolean)(filter , boolVal);
     chf_value(parser, &result);
@@ -114,7 +228,10 @@ static int chf_integer(void * ctx, long long integerVal)
     parseContext *parser = (parseContext *) ctx;
     chFilter *filter = parser->filter;
     parse_result result;
+    chfOp *op = chf_record(parser->record, chfOpInteger);
 
+    if (op)
+        op->val.i = integerVal;
     assert(filter);
     result = CALLIF(filter->plug->fif->parse_integer)(filter , integerVal);
     chf_value(parser, &result);
@@ -126,7 +243,10 @@ static int chf_double(void * ctx, double doubleVal)
     parseContext *parser = (parseContext *) ctx;
     chFilter *filter = parser->filter;
     parse_result result;
+    chfOp *op = chf_record(parser->record, chfOpDouble);
 
+    if (op)
+        op->val.d = doubleVal;
     assert(filter);
     result = CALLIF(filter->plug->fif->parse_double)(filter , doubleVal);
     chf_value(parser, &result);
@@ -140,6 +260,8 @@ static int chf_string(void * ctx, const unsigned char * stringVal,
     chFilter *filter = parser->filter;
     parse_result result;
 
+    chf_record_string(parser->record, chfOpString,
+        (const char *) stringVal, stringLen);
     assert(filter);
     result = CALLIF(filter->plug->fif->parse_string)(filter , (const char *) stringVal, stringLen);
     chf_value(parser, &result);
@@ -151,6 +273,7 @@ static int chf_start_map(void * ctx)
     parseContext *parser = (parseContext *) ctx;
     chFilter *filter = parser->filter;
 
+    chf_record(parser->record, chfOpStartMap);
     if (!filter) {
         assert(parser->depth == 0);
         return parse_continue; /* Opening '{' */
@@ -168,6 +291,8 @@ static int chf_map_key(void * ctx, const unsigned char * key,
     const chFilterPlugin *plug;
     parse_result result;
 
+    chf_record_string(parser->record, chfOpMapKey, (const char *) key,
+        stringLen);
     if (filter) {
         assert(parser->depth > 0);
         return CALLIF(filter->plug->fif->parse_map_key)(filter , (const char *) key, stringLen);
@@ -205,6 +330,7 @@ static int chf_end_map(void * ctx)
     chFilter *filter = parser->filter;
     parse_result result;
 
+    chf_record(parser->record, chfOpEndMap);
     if (!filter) {
         assert(parser->depth == 0);
         return parse_continue; /* Final closing '}' */
@@ -223,6 +349,7 @@ static int chf_start_array(void * ctx)
     parseContext *parser = (parseContext *) ctx;
     chFilter *filter = parser->filter;
 
+    chf_record(parser->record, chfOpStartArray);
     assert(filter);
     ++parser->depth;
     return CALLIF(filter->plug->fif->parse_start_array)(filter );
@@ -234,6 +361,7 @@ static int chf_end_array(void * ctx)
     chFilter *filter = parser->filter;
     parse_result result;
 
+    chf_record(parser->record, chfOpEndArray);
     assert(filter);
     result = CALLIF(filter->plug->fif->parse_end_array)(filter );
     --parser->depth;
@@ -263,10 +391,11 @@ static void chf_free(void *ctx, void *ptr)
 static yajl_alloc_funcs chf_alloc =
     { chf_malloc, chf_realloc, chf_free };
 
-static long chf_parse(dbChannel *chan, const char **pjson)
+static long chf_parse(dbChannel *chan, const char **pjson,
+    chCacheEntry *pce)
 {
     parseContext parser =
-        { chan, NULL, 0 };
+        { chan, NULL, 0, pce };
     yajl_handle yh = yajl_alloc(&chf_callbacks, &chf_alloc, &parser);
     const char *json = *pjson;
     size_t jlen = strlen(json), ylen;
@@ -308,6 +437,63 @@ static long chf_parse(dbChannel *chan, const char **pjson)
     return status;
 }
 
+/* Configure the filters of a new channel from a recording */
+static long chf_replay(dbChannel *chan, const chCacheEntry *pce)
+{
+    parseContext parser =
+        { chan, NULL, 0, NULL };
+    int result = parse_continue;
+    int i;
+
+    for (i = 0; i < pce->nops && result == parse_continue; i++) {
+        const chfOp *op = &pce->ops[i];
+
+        switch (op->type) {
+        case chfOpNull:
+            result = chf_null(&parser);
+            break;
+        case chfOpBoolean:
+            result = chf_boolean(&parser, op->val.b);
+            break;
+        case chfOpInteger:
+            result = chf_integer(&parser, op->val.i);
+            break;
+        case chfOpDouble:
+            result = chf_double(&parser, op->val.d);
+            break;
+        case chfOpString:
+            result = chf_string(&parser, (const unsigned char *) op->val.s,
+                op->len);
+            break;
+        case chfOpStartMap:
+            result = chf_start_map(&parser);
+            break;
+        case chfOpMapKey:
+            result = chf_map_key(&parser, (const unsigned char *) op->val.s,
+                op->len);
+            break;
+        case chfOpEndMap:
+            result = chf_end_map(&parser);
+            break;
+        case chfOpStartArray:
+            result = chf_start_array(&parser);
+            break;
+        case chfOpEndArray:
+            result = chf_end_array(&parser);
+            break;
+        }
+    }
+
+    if (result == parse_continue)
+        return 0;
+
+    if (parser.filter) {
+        parser.filter->plug->fif->parse_abort(parser.filter);
+        freeListFree(chFilterFreeList, parser.filter);
+    }
+    return S_db_notFound;
+}
+
 static long pvNameLookup(DBENTRY *pdbe, const char **ppname)
 {
     long status;
@@ -348,7 +534,18 @@ if (Func) { \
     if (result != parse_continue) goto failure; \
 }
 
-static long parseArrayRange(dbChannel* chan, const char *pname, const char **ppnext) {
+static void recordArrayKey(chCacheEntry *pce, const char *key, long long val)
+{
+    chfOp *op;
+
+    chf_record_string(pce, chfOpMapKey, key, 1);
+    op = chf_record(pce, chfOpInteger);
+    if (op)
+        op->val.i = val;
+}
+
+static long parseArrayRange(dbChannel* chan, const char *pname, const char **ppnext,
+    chCacheEntry *pce) {
     epicsInt32 start = 0;
     epicsInt32 end = -1;
     epicsInt32 incr = 1;
@@ -435,6 +632,21 @@ static long parseArrayRange(dbChannel* chan, const char *pname, const char **ppn
     TRY(filter->plug->fif->parse_end, (filter));
 
     ellAdd(&chan->filters, &filter->list_node);
+
+    /* Recorded as the equivalent JSON {"arr":{...}} */
+    if (pce) {
+        chf_record(pce, chfOpStartMap);
+        chf_record_string(pce, chfOpMapKey, "arr", 3);
+        chf_record(pce, chfOpStartMap);
+        if (start != 0)
+            recordArrayKey(pce, "s", start);
+        if (incr != 1)
+            recordArrayKey(pce, "i", incr);
+        if (end != -1)
+            recordArrayKey(pce, "e", end);
+        chf_record(pce, chfOpEndMap);
+        chf_record(pce, chfOpEndMap);
+    }
     return 0;
 
     failure:
@@ -445,73 +657,94 @@ static long parseArrayRange(dbChannel* chan, const char *pname, const char **ppn
     return status;
 }
 
-dbChannel * dbChannelCreate(const char *name)
+static dbChannel * channelAlloc(const char *name)
+{
+    dbChannel *chan = freeListCalloc(dbChannelFreeList);
+    char *cname;
+
+    if (!chan)
+        return NULL;
+    cname = malloc(strlen(name) + 1);
+    if (!cname) {
+        freeListFree(dbChannelFreeList, chan);
+        return NULL;
+    }
+
+    strcpy(cname, name);
+    chan->name = cname;
+    ellInit(&chan->filters);
+    ellInit(&chan->pre_chain);
+    ellInit(&chan->post_chain);
+    return chan;
+}
+
+/* Some field types can be accessed as char arrays */
+static long applyDollar(dbAddr *paddr)
+{
+    short dbfType = paddr->field_type;
+
+    if (dbfType == DBF_STRING) {
+        paddr->no_elements = paddr->field_size;
+        paddr->field_type = DBF_CHAR;
+        paddr->field_size = 1;
+        paddr->dbr_field_type = DBR_CHAR;
+    }
+    else if (dbfType >= DBF_INLINK && dbfType <= DBF_FWDLINK) {
+        /* Clients see a char array, but keep original dbfType */
+        paddr->no_elements = PVLINK_STRINGSZ;
+        paddr->field_size = 1;
+        paddr->dbr_field_type = DBR_CHAR;
+    }
+    else
+        return S_dbLib_fieldNotFound;
+    return 0;
+}
+
+/* Parse the name, recording the result in pce if it's not NULL */
+static dbChannel * channelParse(const char *name, chCacheEntry *pce)
 {
     const char *pname = name;
     DBENTRY dbEntry;
     dbChannel *chan = NULL;
-    char *cname;
     dbAddr *paddr;
     long status;
 
-    if (!name || !*name || !pdbbase)
-        return NULL;
-
     status = pvNameLookup(&dbEntry, &pname);
     if (status)
         goto finish;
 
-    chan = freeListCalloc(dbChannelFreeList);
+    chan = channelAlloc(name);
     if (!chan)
         goto finish;
-    cname = malloc(strlen(name) + 1);
-    if (!cname)
-        goto finish;
-
-    strcpy(cname, name);
-    chan->name = cname;
-    ellInit(&chan->filters);
-    ellInit(&chan->pre_chain);
-    ellInit(&chan->post_chain);
 
     paddr = &chan->addr;
     status = dbEntryToAddr(&dbEntry, paddr);
     if (status)
         goto finish;
 
+    if (pce) {
+        pce->precnode = dbEntry.precnode;
+        pce->pflddes = dbEntry.pflddes;
+        pce->pfield = dbEntry.pfield;
+    }
+
     /* Handle field modifiers */
     if (*pname) {
-        short dbfType = paddr->field_type;
-
         if (*pname == '$') {
-            /* Some field types can be accessed as char arrays */
-            if (dbfType == DBF_STRING) {
-                paddr->no_elements = paddr->field_size;
-                paddr->field_type = DBF_CHAR;
-                paddr->field_size = 1;
-                paddr->dbr_field_type = DBR_CHAR;
-            }
-            else if (dbfType >= DBF_INLINK && dbfType <= DBF_FWDLINK) {
-                /* Clients see a char array, but keep original dbfType */
-                paddr->no_elements = PVLINK_STRINGSZ;
-                paddr->field_size = 1;
-                paddr->dbr_field_type = DBR_CHAR;
-            }
-            else {
-                status = S_dbLib_fieldNotFound;
-                goto finish;
-            }
+            status = applyDollar(paddr);
+            if (status) goto finish;
+            if (pce) pce->dollar = 1;
             pname++;
         }
 
         if (*pname == '[') {
-            status = parseArrayRange(chan, pname, &pname);
+            status = parseArrayRange(chan, pname, &pname, pce);
             if (status) goto finish;
         }
 
         /* JSON may follow */
         if (*pname == '{') {
-            status = chf_parse(chan, &pname);
+            status = chf_parse(chan, &pname, pce);
             if (status) goto finish;
         }
 
@@ -531,6 +764,194 @@ finish:
     return chan;
 }
 
+static void cacheEntryFree(chCacheEntry *pce)
+{
+    int i;
+
+    for (i = 0; i < pce->nops; i++) {
+        if (pce->ops[i].type == chfOpString || pce->ops[i].type == chfOpMapKey)
+            free(pce->ops[i].val.s);
+    }
+    free(pce->ops);
+    free(pce->name);
+    free(pce);
+}
+
+/* Caller must hold cacheLock for the cache functions below */
+static void cacheRemove(chCacheEntry *pce)
+{
+    ellDelete(&cacheList, &pce->node);
+    gphDelete(cacheHash, pce->name, &cacheList);
+    cacheEntryFree(pce);
+}
+
+static void cacheFlush(void)
+{
+    chCacheEntry *pce;
+
+    while ((pce = (chCacheEntry *) ellFirst(&cacheList)))
+        cacheRemove(pce);
+}
+
+/* Names may no longer refer to the records they did */
+static void cacheCheckNames(void)
+{
+    if (cacheBase == pdbbase && cacheGeneration == pdbbase->nameGeneration)
+        return;
+
+    if (ellCount(&cacheList)) {
+        cacheFlush();
+        cacheStats.flushes++;
+    }
+    cacheBase = pdbbase;
+    cacheGeneration = pdbbase->nameGeneration;
+}
+
+static dbChannel * cacheInstantiate(const char *name, const chCacheEntry *pce)
+{
+    DBENTRY dbEntry;
+    dbChannel *chan;
+    long status;
+
+    chan = channelAlloc(name);
+    if (!chan)
+        return NULL;
+
+    dbInitEntry(pdbbase, &dbEntry);
+    dbEntry.precordType = pce->pflddes->pdbRecordType;
+    dbEntry.precnode = pce->precnode;
+    dbEntry.pflddes = pce->pflddes;
+    dbEntry.pfield = pce->pfield;
+    status = dbEntryToAddr(&dbEntry, &chan->addr);
+    dbFinishEntry(&dbEntry);
+
+    if (!status && pce->dollar)
+        status = applyDollar(&chan->addr);
+    if (!status)
+        status = chf_replay(chan, pce);
+    if (status) {
+        dbChannelDelete(chan);
+        chan = NULL;
+    }
+    return chan;
+}
+
+static void cacheInsert(chCacheEntry *pce)
+{
+    GPHENTRY *pgph;
+
+    cacheCheckNames();
+    if (pce->generation != cacheGeneration) {
+        cacheEntryFree(pce);
+        return;
+    }
+
+    pgph = gphAdd(cacheHash, pce->name, &cacheList);
+    if (!pgph) {
+        /* Already added by another thread */
+        cacheEntryFree(pce);
+        return;
+    }
+    pgph->userPvt = pce;
+    ellInsert(&cacheList, NULL, &pce->node);
+
+    while (ellCount(&cacheList) > dbChannelCacheSize) {
+        cacheRemove((chCacheEntry *) ellLast(&cacheList));
+        cacheStats.evictions++;
+    }
+}
+
+dbChannel * dbChannelCreate(const char *name)
+{
+    chCacheEntry *pce = NULL;
+    dbChannel *chan;
+
+    if (!name || !*name || !pdbbase)
+        return NULL;
+
+    if (cacheLock && dbChannelCacheSize > 0) {
+        GPHENTRY *pgph;
+
+        epicsMutexMustLock(cacheLock);
+        cacheCheckNames();
+        pgph = gphFind(cacheHash, name, &cacheList);
+        if (pgph) {
+            pce = pgph->userPvt;
+            ellDelete(&cacheList, &pce->node);
+            ellInsert(&cacheList, NULL, &pce->node);
+            cacheStats.hits++;
+            chan = cacheInstantiate(name, pce);
+            epicsMutexUnlock(cacheLock);
+            return chan;
+        }
+        cacheStats.misses++;
+        epicsMutexUnlock(cacheLock);
+
+        pce = calloc(1, sizeof(chCacheEntry));
+        if (pce) {
+            pce->name = epicsStrDup(name);
+            pce->generation = pdbbase->nameGeneration;
+        }
+    }
+
+    chan = channelParse(name, pce);
+
+    if (pce) {
+        if (chan && !pce->failed) {
+            epicsMutexMustLock(cacheLock);
+            cacheInsert(pce);
+            epicsMutexUnlock(cacheLock);
+        }
+        else
+            cacheEntryFree(pce);
+    }
+    return chan;
+}
+
+void dbChannelCacheGetStats(dbChannelCacheStats *pstats)
+{
+    if (!cacheLock) {
+        memset(pstats, 0, sizeof(*pstats));
+        return;
+    }
+    epicsMutexMustLock(cacheLock);
+    *pstats = cacheStats;
+    pstats->entries = ellCount(&cacheList);
+    epicsMutexUnlock(cacheLock);
+}
+
+void dbChannelCacheFlush(int resetStats)
+{
+    if (!cacheLock)
+        return;
+    epicsMutexMustLock(cacheLock);
+    cacheFlush();
+    if (resetStats)
+        memset(&cacheStats, 0, sizeof(cacheStats));
+    epicsMutexUnlock(cacheLock);
+}
+
+void dbChannelCacheShow(int level)
+{
+    chCacheEntry *pce;
+
+    if (!cacheLock) {
+        printf("Channel name cache not initialized\n");
+        return;
+    }
+    epicsMutexMustLock(cacheLock);
+    printf("Channel name cache: %d of %d entries, %lu hits, %lu misses, "
+        "%lu evictions, %lu flushes\n",
+        ellCount(&cacheList), dbChannelCacheSize, cacheStats.hits,
+        cacheStats.misses, cacheStats.evictions, cacheStats.flushes);
+    if (level > 0) {
+        for (pce = (chCacheEntry *) ellFirst(&cacheList); pce;
+             pce = (chCacheEntry *) ellNext(&pce->node))
+            printf("    %s (%d parser events)\n", pce->name, pce->nops);
+    }
+    epicsMutexUnlock(cacheLock);
+}
+
 db_field_log* dbChannelRunPreChain(dbChannel *chan, db_field_log *pLogIn) {
     chFilter *filter;
     ELLNODE *node;
@@ -636,6 +1057,10 @@ long dbChannelGetField(dbChannel *chan, short dbrType, void *pbuffer,
     dbCommon *precord = chan->addr.precord;
     long status = 0;
 
+    if (!pfl && dbRec2Pvt(precord)->seqlock &&
+        !dbSeqlockGetField(&chan->addr, dbrType, pbuffer, options, nRequest))
+        return 0;
+
     dbScanLock(precord);
     status = dbChannelGet(chan, dbrType, pbuffer, options, nRequest, pfl);
     dbScanUnlock(precord);
@@ -68,6 +68,8 @@ struct evSubscrip {
     char                callBackInProgress;
     /* this node added to dbCommon::mlis */
     char                enabled;
+    /* node in the per-field list of the record's subscription index */
+    ELLNODE             fieldNode;
 };
 #endif
 
@@ -360,11 +362,53 @@ DBCORE_API long dbChannelTest(const char *name);
 
 /** \brief Create a dbChannel object for the given PV name.
  *
+ * The results of parsing recently created names are cached, see
+ * dbChannelCacheSize.
  * \param name Channel name.
  * \return Pointer to dbChannel object, or NULL if invalid.
  */
 DBCORE_API dbChannel * dbChannelCreate(const char *name);
 
+/** \brief Maximum number of parsed channel names to cache.
+ *
+ * dbChannelCreate() remembers the record, field and field modifiers of
+ * this many recently created names, and the sequence of parser events
+ * which configured their filters. Creating a channel with a cached name
+ * skips the record lookup and JSON parsing; each filter still gets its
+ * own instance data. Set to 0 to disable the cache.
+ * @since UNRELEASED
+ */
+DBCORE_API extern int dbChannelCacheSize;
+
+/** \brief Channel name cache statistics.
+ * @since UNRELEASED
+ */
+typedef struct dbChannelCacheStats {
+    size_t entries;             /**< \brief Names currently cached */
+    unsigned long hits;         /**< \brief Creations using a cached name */
+    unsigned long misses;       /**< \brief Creations which parsed the name */
+    unsigned long evictions;    /**< \brief Least recently used names dropped */
+    unsigned long flushes;      /**< \brief Cache emptied by name changes */
+} dbChannelCacheStats;
+
+/** \brief Read the channel name cache statistics.
+ * @since UNRELEASED
+ */
+DBCORE_API void dbChannelCacheGetStats(dbChannelCacheStats *pstats);
+
+/** \brief Empty the channel name cache and optionally reset its statistics.
+ * @since UNRELEASED
+ */
+DBCORE_API void dbChannelCacheFlush(int resetStats);
+
+/** \brief Print the channel name cache statistics.
+ *
+ * \param level Interest level; above 0 also lists the cached names, most
+ * recently used first.
+ * @since UNRELEASED
+ */
+DBCORE_API void dbChannelCacheShow(int level);
+
 /** \brief Open a dbChannel for doing I/O.
  *
  * \param chan Pointer to the dbChannel object.
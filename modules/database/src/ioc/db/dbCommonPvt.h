@@ -6,6 +6,8 @@
 #include "dbCommon.h"
 
 struct epicsThreadOSD;
+struct dbSeqlock;
+struct evFieldIndex;
 
 /** Base internal additional information for every record
  */
@@ -15,6 +17,17 @@ typedef struct dbCommonPvt {
     /* Thread which is currently processing this record */
     struct epicsThreadOSD* procThread;
 
+    /* Copy of VAL and alarm/time state for unlocked reads, see dbSeqlockPvt.h */
+    struct dbSeqlock *seqlock;
+
+    /* Enabled subscriptions indexed by field, see dbEvent.c */
+    struct evFieldIndex *evFields;
+
+    /* Set while a scanOnce() request without callback is queued */
+    int oncePending;
+    /* 1 + index of the scanOnce thread for this record, 0 until used */
+    int onceThread;
+
     struct dbCommon common;
 } dbCommonPvt;
 
@@ -60,22 +60,43 @@ static void copyNoConvert(const void *pfrom,
 #define COPYNOCONVERT(N, FROM, TO, NREQ, NO_ELEM, OFFSET) \
     copyNoConvert(FROM, TO, (N)*(NREQ), (N)*(NO_ELEM), (N)*(OFFSET))
 
+/* As epicsConvertDoubleToFloat(), inline for the common in-range case */
+static EPICS_ALWAYS_INLINE epicsFloat32 doubleToFloat(epicsFloat64 value)
+{
+    epicsFloat64 mag = fabs(value);
+
+    if (mag > FLT_MIN && mag < FLT_MAX)
+        return (epicsFloat32) value;
+    return epicsConvertDoubleToFloat(value);
+}
+
+/* Number of elements from offset before a circular buffer wraps */
+static long beforeWrap(long nRequest, long no_elements, long offset)
+{
+    if (offset < no_elements && offset + nRequest > no_elements)
+        return no_elements - offset;
+    return nRequest;
+}
+
+/* The array conversions run as at most two straight loops, one each
+ * side of the wrap, which the compiler can vectorize.
+ */
 #define GET(typea, typeb) (const dbAddr *paddr, \
     void *pto, long nRequest, long no_elements, long offset) \
 { \
-    typea *psrc = (typea *) paddr->pfield; \
+    const typea *psrc = (const typea *) paddr->pfield; \
     typeb *pdst = (typeb *) pto; \
+    long i, n; \
     \
     if (nRequest==1 && offset==0) { \
         *pdst = (typeb) *psrc; \
         return 0; \
     } \
-    psrc += offset; \
-    while (nRequest--) { \
-        *pdst++ = (typeb) *psrc++; \
-        if (++offset == no_elements) \
-            psrc = (typea *) paddr->pfield; \
-    } \
+    n = beforeWrap(nRequest, no_elements, offset); \
+    for (i = 0; i < n; i++) \
+        pdst[i] = (typeb) psrc[offset + i]; \
+    for (; i < nRequest; i++) \
+        pdst[i] = (typeb) psrc[i - n]; \
     return 0; \
 }
 
@@ -98,17 +119,17 @@ static void copyNoConvert(const void *pfrom,
 { \
     const typea *psrc = (const typea *) pfrom; \
     typeb *pdst = (typeb *) paddr->pfield; \
+    long i, n; \
     \
     if (nRequest==1 && offset==0) { \
         *pdst = (typeb) *psrc; \
         return 0; \
     } \
-    pdst += offset; \
-    while (nRequest--) { \
-        *pdst++ = (typeb) *psrc++; \
-        if (++offset == no_elements) \
-            pdst = (typeb *) paddr->pfield; \
-    } \
+    n = beforeWrap(nRequest, no_elements, offset); \
+    for (i = 0; i < n; i++) \
+        pdst[offset + i] = (typeb) psrc[i]; \
+    for (; i < nRequest; i++) \
+        pdst[i - n] = (typeb) psrc[i]; \
     return 0; \
 }
 
@@ -810,20 +831,19 @@ static long getDoubleUInt64 GET(epicsFloat64, epicsUInt64)
 static long getDoubleFloat(const dbAddr *paddr,
     void *pto, long nRequest, long no_elements, long offset)
 {
-    epicsFloat64 *psrc = (epicsFloat64 *) paddr->pfield;
+    const epicsFloat64 *psrc = (const epicsFloat64 *) paddr->pfield;
     epicsFloat32 *pdst = (epicsFloat32 *) pto;
+    long i, n;
 
     if (nRequest==1 && offset==0) {
         *pdst = epicsConvertDoubleToFloat(*psrc);
         return 0;
     }
-    psrc += offset;
-    while (nRequest--) {
-        *pdst = epicsConvertDoubleToFloat(*psrc);
-        ++psrc; ++pdst;
-        if (++offset == no_elements)
-            psrc = (epicsFloat64 *) paddr->pfield;
-    }
+    n = beforeWrap(nRequest, no_elements, offset);
+    for (i = 0; i < n; i++)
+        pdst[i] = doubleToFloat(psrc[offset + i]);
+    for (; i < nRequest; i++)
+        pdst[i] = doubleToFloat(psrc[i - n]);
     return 0;
 }
 
@@ -1641,17 +1661,17 @@ static long putDoubleFloat(dbAddr *paddr,
 {
     const epicsFloat64 *psrc = (const epicsFloat64 *) pfrom;
     epicsFloat32 *pdst = (epicsFloat32 *) paddr->pfield;
+    long i, n;
 
     if (nRequest==1 && offset==0) {
         *pdst = epicsConvertDoubleToFloat(*psrc);
         return 0;
     }
-    pdst += offset;
-    while (nRequest--) {
-        *pdst++ = epicsConvertDoubleToFloat(*psrc++);
-        if (++offset == no_elements)
-            pdst = (epicsFloat32 *) paddr->pfield;
-    }
+    n = beforeWrap(nRequest, no_elements, offset);
+    for (i = 0; i < n; i++)
+        pdst[offset + i] = doubleToFloat(psrc[i]);
+    for (; i < nRequest; i++)
+        pdst[i - n] = doubleToFloat(psrc[i]);
     return 0;
 }
 
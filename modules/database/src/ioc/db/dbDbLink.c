@@ -85,6 +85,29 @@ static long processTarget(dbCommon *psrc, dbCommon *pdst);
 
 #define linkChannel(plink) ((dbChannel *) (plink)->value.pv_link.pvt)
 
+/* Build the fetch plan for a new link target. Simple scalars without
+ * filters are read straight from the source field by a conversion
+ * routine which is looked up again only when the requested type changes.
+ * The *Final* type has no additional information for these, and using
+ * dbChannelFieldType() correctly handles DBF_MENU fields, which become
+ * DBF_ENUM during the probe of dbChannelOpen().
+ */
+static void dbDbBuildPlan(struct link *plink, dbChannel *chan)
+{
+    struct pv_link *ppv_link = &plink->value.pv_link;
+
+    ppv_link->getCvt = NULL;
+    ppv_link->lastGetdbrType = 0;
+    if (dbChannelFinalElements(chan) == 1
+            && dbChannelSpecial(chan) != SPC_DBADDR
+            && dbChannelSpecial(chan) != SPC_ATTRIBUTE
+            && dbChannelFieldType(chan) <= DBF_DEVICE
+            && ellCount(&chan->filters) == 0)
+        ppv_link->pfield = dbChannelField(chan);
+    else
+        ppv_link->pfield = NULL;
+}
+
 long dbDbInitLink(struct link *plink, short dbfType)
 {
     long status;
@@ -103,6 +126,7 @@ long dbDbInitLink(struct link *plink, short dbfType)
     plink->lset = &dbDb_lset;
     plink->type = DB_LINK;
     plink->value.pv_link.pvt = chan;
+    dbDbBuildPlan(plink, chan);
     ellAdd(&precord->bklnk, &plink->value.pv_link.backlinknode);
     /* merging into the same lockset is deferred to the caller.
      * cf. initPVLinks()
@@ -118,6 +142,7 @@ void dbDbAddLink(struct dbLocker *locker, struct link *plink, short dbfType,
     plink->lset = &dbDb_lset;
     plink->type = DB_LINK;
     plink->value.pv_link.pvt = chan;
+    dbDbBuildPlan(plink, chan);
     ellAdd(&dbChannelRecord(chan)->bklnk, &plink->value.pv_link.backlinknode);
 
     /* target record is already locked in dbPutFieldLink() */
@@ -137,6 +162,7 @@ static void dbDbRemoveLink(struct dbLocker *locker, struct link *plink)
         plink->value.pv_link.getCvt = 0;
         plink->value.pv_link.pvlMask = 0;
         plink->value.pv_link.lastGetdbrType = 0;
+        plink->value.pv_link.pfield = NULL;
         ellDelete(&precord->bklnk, &plink->value.pv_link.backlinknode);
         dbLockSetSplit(locker, plink->precord, precord);
     }
@@ -178,34 +204,24 @@ static long dbDbGetValue(struct link *plink, short dbrType, void *pbuffer,
             return status;
     }
 
-    if (ppv_link->getCvt && ppv_link->lastGetdbrType == dbrType)
+    if (ppv_link->pfield && (!pnRequest || *pnRequest >= 1))
     {
-        /* shortcut: scalar with known conversion, no filter */
-        status = ppv_link->getCvt(dbChannelField(chan), pbuffer, paddr);
-    }
-    else if (dbChannelFinalElements(chan) == 1 && (!pnRequest || *pnRequest == 1)
-                && dbChannelSpecial(chan) != SPC_DBADDR
-                && dbChannelSpecial(chan) != SPC_ATTRIBUTE
-                && ellCount(&chan->filters) == 0)
-    {
-        /* Simple scalar w/o filters, so *Final* type has no additional information.
-         * Needed to correctly handle DBF_MENU fields, which become DBF_ENUM during
-         * probe of dbChannelOpen().
-         */
-        unsigned short dbfType = dbChannelFieldType(chan);
-
-        if (dbrType < 0 || dbrType > DBR_ENUM || dbfType > DBF_DEVICE)
-            return S_db_badDbrtype;
-
-        ppv_link->getCvt = dbFastGetConvertRoutine[dbfType][dbrType];
-        ppv_link->lastGetdbrType = dbrType;
-        status = ppv_link->getCvt(dbChannelField(chan), pbuffer, paddr);
+        /* scalar with fetch plan */
+        if (!ppv_link->getCvt || ppv_link->lastGetdbrType != dbrType) {
+            if (dbrType < 0 || dbrType > DBR_ENUM)
+                return S_db_badDbrtype;
+
+            ppv_link->getCvt =
+                dbFastGetConvertRoutine[dbChannelFieldType(chan)][dbrType];
+            ppv_link->lastGetdbrType = dbrType;
+        }
+        status = ppv_link->getCvt(ppv_link->pfield, pbuffer, paddr);
+        if (pnRequest)
+            *pnRequest = 1;
     }
     else
     {
         /* filter, array, or special */
-        ppv_link->getCvt = NULL;
-
         if (ellCount(&chan->filters)) {
             /* If filters are involved in a read, create field log and run filters */
             pfl = db_create_read_log(chan);
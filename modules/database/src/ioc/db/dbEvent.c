@@ -43,10 +43,12 @@
 #include "dbBase.h"
 #include "dbChannel.h"
 #include "dbCommon.h"
+#include "dbCommonPvt.h"
 #include "dbEvent.h"
 #include "db_field_log.h"
 #include "dbFldTypes.h"
 #include "dbLock.h"
+#include "dbSeqlockPvt.h"
 #include "link.h"
 #include "special.h"
 
@@ -144,6 +146,154 @@ static unsigned short ringSpace ( const struct event_que *pevq )
     return 0;
 }
 
+/*
+ * Per-record index of the enabled subscriptions, so db_post_events()
+ * for one field only visits the subscriptions on that field instead of
+ * the whole of dbCommon::mlis.  Entries are kept sorted by field address.
+ * The index is only an optimization; if it can't be allocated it is
+ * dropped and db_post_events() walks mlis instead.  Guarded by LOCKREC.
+ */
+typedef struct evField {
+    void                *pfield;
+    ELLLIST             subs;           /* evSubscrip::fieldNode */
+} evField;
+
+typedef struct evFieldIndex {
+    unsigned            count;
+    unsigned            size;
+    evField             fields[1];
+} evFieldIndex;
+
+/* Returns the position of pfield, or where it should be inserted */
+static unsigned evFieldSearch ( const evFieldIndex *pidx, const void *pfield )
+{
+    unsigned lo = 0, hi = pidx->count;
+
+    while ( lo < hi ) {
+        unsigned mid = lo + ( hi - lo ) / 2;
+
+        if ( (const char *) pidx->fields[mid].pfield < (const char *) pfield ) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static ELLLIST * evFieldFind ( const evFieldIndex *pidx, const void *pfield )
+{
+    unsigned pos = evFieldSearch ( pidx, pfield );
+
+    if ( pos < pidx->count && pidx->fields[pos].pfield == pfield ) {
+        return (ELLLIST *) & pidx->fields[pos].subs;
+    }
+    return NULL;
+}
+
+static void evFieldIndexFree ( struct dbCommon *prec )
+{
+    dbCommonPvt *ppvt = dbRec2Pvt ( prec );
+
+    free ( ppvt->evFields );
+    ppvt->evFields = NULL;
+}
+
+/* Insert into the index, which must already have room */
+static void evFieldInsert ( evFieldIndex *pidx, struct evSubscrip *pevent )
+{
+    void *pfield = dbChannelField ( pevent->chan );
+    unsigned pos = evFieldSearch ( pidx, pfield );
+
+    if ( pos == pidx->count || pidx->fields[pos].pfield != pfield ) {
+        memmove ( & pidx->fields[pos + 1], & pidx->fields[pos],
+            ( pidx->count - pos ) * sizeof ( evField ) );
+        pidx->fields[pos].pfield = pfield;
+        ellInit ( & pidx->fields[pos].subs );
+        pidx->count++;
+    }
+    ellAdd ( & pidx->fields[pos].subs, & pevent->fieldNode );
+}
+
+/* Called after pevent has been added to mlis */
+static void evFieldAdd ( struct dbCommon *prec, struct evSubscrip *pevent )
+{
+    dbCommonPvt *ppvt = dbRec2Pvt ( prec );
+    evFieldIndex *pidx = ppvt->evFields;
+
+    if ( pidx && pidx->count == pidx->size ) {
+        unsigned size = pidx->size * 2;
+
+        pidx = realloc ( pidx, sizeof ( evFieldIndex ) +
+            ( size - 1 ) * sizeof ( evField ) );
+        if ( ! pidx ) {
+            evFieldIndexFree ( prec );
+            return;
+        }
+        pidx->size = size;
+        ppvt->evFields = pidx;
+    }
+
+    if ( pidx ) {
+        evFieldInsert ( pidx, pevent );
+    }
+    else {
+        /* (re)build from mlis, which may be larger than one entry
+         * if an earlier allocation failed */
+        unsigned size = 4;
+        struct evSubscrip *pnext;
+
+        while ( size < (unsigned) ellCount ( & prec->mlis ) ) {
+            size *= 2;
+        }
+        pidx = malloc ( sizeof ( evFieldIndex ) +
+            ( size - 1 ) * sizeof ( evField ) );
+        if ( ! pidx ) {
+            return;
+        }
+        pidx->count = 0;
+        pidx->size = size;
+        for ( pnext = (struct evSubscrip *) ellFirst ( & prec->mlis );
+            pnext; pnext = (struct evSubscrip *) ellNext ( & pnext->node ) ) {
+            evFieldInsert ( pidx, pnext );
+        }
+        ppvt->evFields = pidx;
+    }
+}
+
+/* Called after pevent has been removed from mlis */
+static void evFieldRemove ( struct dbCommon *prec, struct evSubscrip *pevent )
+{
+    evFieldIndex *pidx = dbRec2Pvt ( prec )->evFields;
+    void *pfield = dbChannelField ( pevent->chan );
+    unsigned pos;
+
+    if ( ! pidx ) {
+        return;
+    }
+    if ( ellCount ( & prec->mlis ) == 0 ) {
+        evFieldIndexFree ( prec );
+        return;
+    }
+
+    pos = evFieldSearch ( pidx, pfield );
+    if ( pos == pidx->count || pidx->fields[pos].pfield != pfield ) {
+        /* dbChannelField() moved since the subscription was enabled */
+        for ( pos = 0; pos < pidx->count; pos++ ) {
+            if ( ellFind ( & pidx->fields[pos].subs, & pevent->fieldNode ) >= 0 )
+                break;
+        }
+        assert ( pos < pidx->count );
+    }
+    ellDelete ( & pidx->fields[pos].subs, & pevent->fieldNode );
+    if ( ellCount ( & pidx->fields[pos].subs ) == 0 ) {
+        pidx->count--;
+        memmove ( & pidx->fields[pos], & pidx->fields[pos + 1],
+            ( pidx->count - pos ) * sizeof ( evField ) );
+    }
+}
+
 int db_event_list ( const char *pname, unsigned level )
 {
     return dbel ( pname, level );
@@ -511,6 +661,7 @@ void db_event_enable (dbEventSubscription event)
     LOCKREC (precord);
     if ( ! pevent->enabled ) {
         ellAdd (&precord->mlis, &pevent->node);
+        evFieldAdd (precord, pevent);
         pevent->enabled = TRUE;
     }
     UNLOCKREC (precord);
@@ -527,6 +678,7 @@ void db_event_disable (dbEventSubscription event)
     LOCKREC (precord);
     if ( pevent->enabled ) {
         ellDelete(&precord->mlis, &pevent->node);
+        evFieldRemove (precord, pevent);
         pevent->enabled = FALSE;
     }
     UNLOCKREC (precord);
@@ -738,6 +890,7 @@ db_field_log* db_create_event_log (struct evSubscrip *pevent)
     if (pLog) {
         pLog->mask = pevent->select;
         pLog->ctx  = dbfl_context_event;
+        pLog->sub  = pevent;
     }
     return pLog;
 }
@@ -856,6 +1009,16 @@ static void db_queue_event_log (evSubscrip *pevent, db_field_log *pLog)
     }
 }
 
+static void db_post_event_log (struct evSubscrip *pevent,
+    unsigned int caEventMask)
+{
+    db_field_log *pLog = db_create_event_log(pevent);
+    if(pLog)
+        pLog->mask = caEventMask & pevent->select;
+    pLog = dbChannelRunPreChain(pevent->chan, pLog);
+    if (pLog) db_queue_event_log(pevent, pLog);
+}
+
 /*
  *  DB_POST_EVENTS()
  *
@@ -869,26 +1032,42 @@ unsigned int    caEventMask
 )
 {
     struct dbCommon   * const prec = (struct dbCommon *) pRecord;
+    dbSeqlock *psl = dbRec2Pvt(prec)->seqlock;
+    evFieldIndex *pidx;
     struct evSubscrip *pevent;
 
+    /* Keep the copy for unlocked readers current */
+    if (psl && pField == psl->pfield)
+        dbSeqlockPublish(prec);
+
     if (prec->mlis.count == 0) return DB_EVENT_OK;       /* no monitors set */
 
     LOCKREC (prec);
 
-    for (pevent = (struct evSubscrip *) prec->mlis.node.next;
-        pevent; pevent = (struct evSubscrip *) pevent->node.next){
+    pidx = dbRec2Pvt(prec)->evFields;
+    if (pField && pidx) {
+        /* Only the subscriptions on this field */
+        ELLLIST *psubs = evFieldFind(pidx, pField);
+        ELLNODE *pnode = psubs ? ellFirst(psubs) : NULL;
 
-        /*
-         * Only send event msg if they are waiting on the field which
-         * changed or pval==NULL, and are waiting on matching event
-         */
-        if ( (dbChannelField(pevent->chan) == (void *)pField || pField==NULL) &&
-            (caEventMask & pevent->select)) {
-            db_field_log *pLog = db_create_event_log(pevent);
-            if(pLog)
-                pLog->mask = caEventMask & pevent->select;
-            pLog = dbChannelRunPreChain(pevent->chan, pLog);
-            if (pLog) db_queue_event_log(pevent, pLog);
+        for (; pnode; pnode = ellNext(pnode)) {
+            pevent = CONTAINER(pnode, struct evSubscrip, fieldNode);
+            if (caEventMask & pevent->select)
+                db_post_event_log(pevent, caEventMask);
+        }
+    }
+    else {
+        for (pevent = (struct evSubscrip *) prec->mlis.node.next;
+            pevent; pevent = (struct evSubscrip *) pevent->node.next){
+
+            /*
+             * Only send event msg if they are waiting on the field which
+             * changed or pval==NULL, and are waiting on matching event
+             */
+            if ( (dbChannelField(pevent->chan) == (void *)pField || pField==NULL) &&
+                (caEventMask & pevent->select)) {
+                db_post_event_log(pevent, caEventMask);
+            }
         }
     }
 
@@ -897,6 +1076,39 @@ unsigned int    caEventMask
 
 }
 
+/*
+ *  DB_POST_SUBSCRIPTION_EVENTS()
+ *
+ *  Post an event to one subscription made through chan, for filters
+ *  which hold back updates and release them later.  The subscription
+ *  is only dereferenced if it is still enabled, so this may be called
+ *  with one which has since been cancelled; DB_EVENT_ERROR is returned
+ *  in that case.  With a caEventMask of 0 nothing is posted.
+ *
+ *  NOTE: This assumes that the db scan lock is already applied
+ *
+ */
+int db_post_subscription_events (struct evSubscrip *psub,
+    struct dbChannel *chan, unsigned caEventMask)
+{
+    struct dbCommon * const prec = dbChannelRecord(chan);
+    struct evSubscrip *pevent;
+
+    LOCKREC (prec);
+
+    for (pevent = (struct evSubscrip *) prec->mlis.node.next;
+        pevent; pevent = (struct evSubscrip *) pevent->node.next) {
+        if (pevent == psub && pevent->chan == chan)
+            break;
+    }
+    if (pevent && (caEventMask & pevent->select))
+        db_post_event_log(pevent, caEventMask);
+
+    UNLOCKREC (prec);
+
+    return pevent ? DB_EVENT_OK : DB_EVENT_ERROR;
+}
+
 /*
  *  DB_POST_SINGLE_EVENT()
  */
@@ -38,6 +38,8 @@ DBCORE_API int dbel (
     const char *name, unsigned level);
 DBCORE_API int db_post_events (
     void *pRecord, void *pField, unsigned caEventMask );
+DBCORE_API int db_post_subscription_events (
+    struct evSubscrip *psub, struct dbChannel *chan, unsigned caEventMask );
 
 typedef void * dbEventCtx;
 
@@ -26,6 +26,28 @@
 #include "dbAddr.h"
 #include "dbExtractArray.h"
 
+/* Strided gather of one element type.  Each pass copies the run of
+ * elements up to the wrap-around point with a plain indexed loop.
+ */
+#define EXTRACT_STRIDED(TYPE) \
+    { \
+        const TYPE *src = (const TYPE *) pfrom; \
+        TYPE *dst = (TYPE *) pto; \
+        while (nRequest > 0) { \
+            long n = (no_elements - offset + increment - 1) / increment; \
+            long i; \
+            if (n > nRequest) \
+                n = nRequest; \
+            for (i = 0; i < n; i++) \
+                dst[i] = src[offset + i * increment]; \
+            dst += n; \
+            nRequest -= n; \
+            offset = (offset + n * increment) % no_elements; \
+        } \
+    }
+
+#define IS_ALIGNED(p, size) (((size_t) (p) & ((size) - 1)) == 0)
+
 void dbExtractArray(const void *pfrom, void *pto, short field_size,
     long nRequest, long no_elements, long offset, long increment)
 {
@@ -46,6 +68,14 @@ void dbExtractArray(const void *pfrom, void *pto, short field_size,
         if (nRequest > nUpperPart)
             memcpy(pdst + (field_size * nUpperPart), psrc,
                 field_size * (nRequest - nUpperPart));
+    } else if (field_size == 8 && IS_ALIGNED(psrc, 8) && IS_ALIGNED(pdst, 8)) {
+        EXTRACT_STRIDED(epicsUInt64)
+    } else if (field_size == 4 && IS_ALIGNED(psrc, 4) && IS_ALIGNED(pdst, 4)) {
+        EXTRACT_STRIDED(epicsUInt32)
+    } else if (field_size == 2 && IS_ALIGNED(psrc, 2) && IS_ALIGNED(pdst, 2)) {
+        EXTRACT_STRIDED(epicsUInt16)
+    } else if (field_size == 1) {
+        EXTRACT_STRIDED(epicsUInt8)
     } else {
         for (; nRequest > 0; nRequest--, pdst += field_size, offset += increment) {
             offset %= no_elements;
@@ -17,6 +17,7 @@
 #include "dbStaticPvt.h"
 #include "dbBkpt.h"
 #include "dbCaTest.h"
+#include "dbChannel.h"
 #include "dbEvent.h"
 #include "dbIocRegister.h"
 #include "dbJLink.h"
@@ -68,6 +69,25 @@ static void dbLoadRecordsCallFunc(const iocshArgBuf *args)
     iocshSetError(dbLoadRecords(args[0].sval,args[1].sval));
 }
 
+/* dbLoadSnapshot */
+static const iocshArg dbLoadSnapshotArg0 = { "snapshot file",iocshArgStringPath};
+static const iocshArg * const dbLoadSnapshotArgs[3] =
+    {&dbLoadSnapshotArg0,&dbLoadRecordsArg0,&dbLoadRecordsArg1};
+static const iocshFuncDef dbLoadSnapshotFuncDef = {
+    "dbLoadSnapshot",
+    3,
+    dbLoadSnapshotArgs,
+    "Load records from a snapshot written by dbWriteSnapshot.\n\n"
+    "If the snapshot is missing, corrupt or was made with different record type\n"
+    "definitions, load the given .db file with the given substitutions instead.\n"
+    "There is no fallback if the snapshot fails after creating some records.\n\n"
+    "Example: dbLoadSnapshot db/ioc.snap db/myRecords.db 'user=myself'\n",
+};
+static void dbLoadSnapshotCallFunc(const iocshArgBuf *args)
+{
+    iocshSetError(dbLoadSnapshot(args[0].sval,args[1].sval,args[2].sval));
+}
+
 /* dbb */
 static const iocshArg dbbArg0 = { "record name",iocshArgStringRecord};
 static const iocshArg * const dbbArgs[1] = {&dbbArg0};
@@ -361,6 +381,18 @@ static const iocshFuncDef dbtpnFuncDef = {"dbtpn",2,dbtpnArgs,
 static void dbtpnCallFunc(const iocshArgBuf *args)
 { dbtpn(args[0].sval,args[1].sval);}
 
+/* dbChannelCacheShow */
+static const iocshArg dbChannelCacheShowArg0 = { "interest level",iocshArgInt};
+static const iocshArg * const dbChannelCacheShowArgs[1] =
+    {&dbChannelCacheShowArg0};
+static const iocshFuncDef dbChannelCacheShowFuncDef = {"dbChannelCacheShow",1,
+    dbChannelCacheShowArgs,
+    "Report statistics of the cache of parsed channel names.\n"
+    "interest level 0 - Show statistics only.\n"
+    "               1 - Also list the cached names, most recently used first.\n"};
+static void dbChannelCacheShowCallFunc(const iocshArgBuf *args)
+{ dbChannelCacheShow(args[0].ival);}
+
 /* dbNotifyDump */
 static const iocshFuncDef dbNotifyDumpFuncDef = {"dbNotifyDump",0,0,
                                                  "Report status of any active async processing with completion notification.\n"};
@@ -426,6 +458,19 @@ static void scanOnceSetQueueSizeCallFunc(const iocshArgBuf *args)
     scanOnceSetQueueSize(args[0].ival);
 }
 
+/* scanOnceSetThreads */
+static const iocshArg scanOnceSetThreadsArg0 = { "count",iocshArgInt};
+static const iocshArg * const scanOnceSetThreadsArgs[1] =
+    {&scanOnceSetThreadsArg0};
+static const iocshFuncDef scanOnceSetThreadsFuncDef = {"scanOnceSetThreads",1,scanOnceSetThreadsArgs,
+                                                       "Set the number of Scan once threads.\n"
+                                                       "Records are assigned to a thread by lock set.\n"
+                                                       "Must be called before iocInit().\n"};
+static void scanOnceSetThreadsCallFunc(const iocshArgBuf *args)
+{
+    iocshSetError(scanOnceSetThreads(args[0].ival));
+}
+
 /* scanOnceQueueShow */
 static const iocshArg scanOnceQueueShowArg0 = { "reset",iocshArgInt};
 static const iocshArg * const scanOnceQueueShowArgs[1] =
@@ -583,6 +628,7 @@ void dbIocRegister(void)
 
     iocshRegister(&dbLoadDatabaseFuncDef,dbLoadDatabaseCallFunc);
     iocshRegister(&dbLoadRecordsFuncDef,dbLoadRecordsCallFunc);
+    iocshRegister(&dbLoadSnapshotFuncDef,dbLoadSnapshotCallFunc);
 
     iocshRegister(&dbaFuncDef,dbaCallFunc);
     iocshRegister(&dblFuncDef,dblCallFunc);
@@ -601,6 +647,7 @@ void dbIocRegister(void)
     iocshRegister(&gftFuncDef,gftCallFunc);
     iocshRegister(&pftFuncDef,pftCallFunc);
     iocshRegister(&dbtpnFuncDef,dbtpnCallFunc);
+    iocshRegister(&dbChannelCacheShowFuncDef,dbChannelCacheShowCallFunc);
     iocshRegister(&dbNotifyDumpFuncDef,dbNotifyDumpCallFunc);
     iocshRegister(&dbPutAttrFuncDef,dbPutAttrCallFunc);
     iocshRegister(&tpnFuncDef,tpnCallFunc);
@@ -608,6 +655,7 @@ void dbIocRegister(void)
     iocshRegister(&dbLockShowLockedFuncDef,dbLockShowLockedCallFunc);
 
     iocshRegister(&scanOnceSetQueueSizeFuncDef,scanOnceSetQueueSizeCallFunc);
+    iocshRegister(&scanOnceSetThreadsFuncDef,scanOnceSetThreadsCallFunc);
     iocshRegister(&scanOnceQueueShowFuncDef,scanOnceQueueShowCallFunc);
     iocshRegister(&scanpplFuncDef,scanpplCallFunc);
     iocshRegister(&scanpelFuncDef,scanpelCallFunc);
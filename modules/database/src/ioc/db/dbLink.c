@@ -339,6 +339,35 @@ long dbGetLink(struct link *plink, short dbrType, void *pbuffer,
     return status;
 }
 
+long dbGetLinks(struct link *plinks, int nlinks, short dbrType, void *pvalues)
+{
+    char *pvalue = pvalues;
+    long size = dbValueSize(dbrType);
+    long status = 0;
+    int i;
+
+    for (i = 0; i < nlinks; i++, pvalue += size) {
+        struct link *plink = &plinks[i];
+        lset *plset = plink->lset;
+        long newStatus;
+
+        /* Constant links only supply their value at initialization */
+        if (plink->type == CONSTANT)
+            continue;
+
+        if (!plset || !plset->getValue)
+            newStatus = -1;
+        else {
+            newStatus = plset->getValue(plink, dbrType, pvalue, NULL);
+            if (newStatus)
+                setLinkAlarm(plink);
+        }
+        if (!status)
+            status = newStatus;
+    }
+    return status;
+}
+
 long dbGetControlLimits(const struct link *plink, double *low, double *high)
 {
     lset *plset = plink->lset;
@@ -429,6 +429,18 @@ DBCORE_API long dbTryGetLink(struct link *, short dbrType, void *pbuffer,
 /** see dbTryGetLink() */
 DBCORE_API long dbGetLink(struct link *, short dbrType, void *pbuffer,
         long *options, long *nRequest);
+/** \brief Fetch scalar values from consecutive input links.
+ * \param plinks First of \p nlinks adjacent link fields, e.g. INPA..INPL
+ * \param dbrType Database DBR code for all values
+ * \param pvalues Destination array of \p nlinks elements of \p dbrType
+ * \return The first non-zero status from any link, or 0
+ *
+ * Equivalent to calling dbGetLink() for each link in turn, so all links are
+ * read even after one fails.  Constant links are skipped.
+ * @since UNRELEASED
+ */
+DBCORE_API long dbGetLinks(struct link *plinks, int nlinks, short dbrType,
+        void *pvalues);
 DBCORE_API long dbGetControlLimits(const struct link *plink, double *low,
         double *high);
 DBCORE_API long dbGetGraphicLimits(const struct link *plink, double *low,
@@ -18,11 +18,13 @@
 #include "ellLib.h"
 #include "epicsAssert.h"
 #include "epicsAtomic.h"
+#include "epicsExit.h"
 #include "epicsMutex.h"
 #include "epicsPrint.h"
 #include "epicsSpin.h"
 #include "epicsStdio.h"
 #include "epicsThread.h"
+#include "errlog.h"
 #include "errMdef.h"
 
 #include "dbAccessDefs.h"
@@ -56,10 +58,29 @@ static epicsMutexId lockSetsGuard;
 static size_t recomputeCnt;
 #endif
 
+/* Per-thread state of dbLockSetBatchBegin()/dbLockSetBatchEnd().
+ * Records whose lockSet may need to be split are remembered
+ * until the outermost batch ends.  Allocated by the first batch
+ * in a thread and kept until the thread exits.
+ */
+typedef struct {
+    unsigned depth;
+    size_t npending, maxpending;
+    dbCommon **pending;
+} lockBatch;
+
+static epicsThreadPrivateId lockBatchId;
+
+/* incremented by each dbLockSetBatchEnd() to mark lockSets
+ * which have already been partitioned.
+ */
+static size_t batchGen;
+
 /*private routines */
 static void dbLockOnce(void* ignore)
 {
     lockSetsGuard = epicsMutexMustCreate();
+    lockBatchId = epicsThreadPrivateCreate();
 }
 
 /* global ID number assigned to each lockSet on creation.
@@ -612,6 +633,13 @@ void dbLockSetMerge(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
     if(A==B)
         return; /* already in the same lockSet */
 
+    /* move the smaller list.  Lockers hold both sets, so either may go. */
+    if(ellCount(&B->lockRecordList) > ellCount(&A->lockRecordList)) {
+        lockSet *T = A;
+        A = B;
+        B = T;
+    }
+
     Nb = ellCount(&B->lockRecordList);
     assert(Nb>0);
 
@@ -662,6 +690,7 @@ void dbLockSetMerge(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
 
     dbLockDecRef(B); /* last ref we hold */
 
+    assert(A==pfirst->lset->plockSet);
     assert(A==psecond->lset->plockSet);
 }
 
@@ -699,6 +728,26 @@ void dbLockSetSplit(dbLocker *locker, dbCommon *pfirst, dbCommon *psecond)
     if(pfirst==psecond)
         return;
 
+    {
+        /* within a batch, leave the lockSet (safely) over-sized
+         * and partition it once in dbLockSetBatchEnd()
+         */
+        lockBatch *batch = epicsThreadPrivateGet(lockBatchId);
+        if(batch && batch->depth) {
+            if(batch->npending==0 || batch->pending[batch->npending-1]!=pfirst) {
+                if(batch->npending==batch->maxpending) {
+                    batch->maxpending = batch->maxpending ? 2*batch->maxpending : 16;
+                    batch->pending = realloc(batch->pending,
+                                             batch->maxpending*sizeof(*batch->pending));
+                    if(!batch->pending)
+                        cantProceed("dbLockSetSplit() no memory for batch");
+                }
+                batch->pending[batch->npending++] = pfirst;
+            }
+            return;
+        }
+    }
+
     /* at least 1 ref for each lockRecord,
      * and one for the locker
      */
@@ -869,6 +918,215 @@ nosplit:
     }
 }
 
+typedef struct {
+    lockRecord *lr;
+    size_t parent;
+    size_t size;
+    lockSet *set;
+} partNode;
+
+static size_t partFind(partNode *nodes, size_t i)
+{
+    while(nodes[i].parent!=i) {
+        nodes[i].parent = nodes[nodes[i].parent].parent;
+        i = nodes[i].parent;
+    }
+    return i;
+}
+
+/* Split the locked lockSet ls into its connected components.
+ * The largest component stays in ls.  New lockSets are
+ * locked and added to the locker, as with dbLockSetSplit().
+ */
+static void dbLockSetPartition(dbLocker *locker, lockSet *ls, size_t gen)
+{
+    size_t n = ellCount(&ls->lockRecordList), i, keep;
+    unsigned ncomp = 0;
+    partNode *nodes;
+    ELLNODE *cur;
+
+    ls->batchgen = gen;
+    if(n<2)
+        return;
+
+    nodes = mallocMustSucceed(n*sizeof(*nodes), "dbLockSetPartition");
+
+    for(cur=ellFirst(&ls->lockRecordList), i=0; cur; cur=ellNext(cur), i++) {
+        lockRecord *lr = CONTAINER(cur, lockRecord, node);
+        nodes[i].lr = lr;
+        nodes[i].parent = i;
+        nodes[i].size = 1;
+        nodes[i].set = NULL;
+        lr->compflag = i+1;
+    }
+
+    /* union along every DB link.  Each link is the forward link of
+     * exactly one member, so back links need not be visited.
+     */
+    for(i=0; i<n; i++) {
+        dbCommon *prec = nodes[i].lr->precord;
+        dbRecordType *rtype = prec->rdes;
+        size_t j;
+
+        for(j=0; j<rtype->no_links; j++) {
+            dbFldDes *pdesc = rtype->papFldDes[rtype->link_ind[j]];
+            DBLINK *plink = (DBLINK*)((char*)prec + pdesc->offset);
+            lockRecord *lr;
+            size_t a, b;
+
+            if(plink->type!=DB_LINK)
+                continue;
+
+            lr = dbChannelRecord((dbChannel*)plink->value.pv_link.pvt)->lset;
+            assert(lr->plockSet==ls && lr->compflag>0);
+
+            a = partFind(nodes, i);
+            b = partFind(nodes, lr->compflag-1);
+            if(a==b)
+                continue;
+            if(nodes[a].size < nodes[b].size) {
+                size_t t = a;
+                a = b;
+                b = t;
+            }
+            nodes[b].parent = a;
+            nodes[a].size += nodes[b].size;
+        }
+    }
+
+    keep = partFind(nodes, 0);
+    for(i=0; i<n; i++) {
+        if(nodes[i].parent!=i)
+            continue;
+        ncomp++;
+        if(nodes[i].size > nodes[keep].size)
+            keep = i;
+    }
+
+    for(i=0; i<n; i++) {
+        lockRecord *lr = nodes[i].lr;
+        size_t root = partFind(nodes, i);
+        lockSet *splitset;
+
+        lr->compflag = 0; /* reset for next time */
+
+        if(ncomp==1 || root==keep)
+            continue;
+
+        splitset = nodes[root].set;
+        if(!splitset) {
+            splitset = nodes[root].set = makeSet(); /* reference for locker->locked */
+
+            epicsMutexMustLock(splitset->lock);
+
+            assert(splitset->ownerlocker==NULL);
+            ellAdd(&locker->locked, &splitset->lockernode);
+            splitset->ownerlocker = locker;
+            splitset->batchgen = gen;
+#ifdef LOCKSET_DEBUG
+            splitset->owner = ls->owner;
+            splitset->ownercount = 1;
+#endif
+        }
+
+        assert(lr->plockSet == ls);
+        ellDelete(&ls->lockRecordList, &lr->node);
+        ellAdd(&splitset->lockRecordList, &lr->node);
+
+        epicsSpinLock(lr->spin);
+        lr->plockSet = splitset;
+#ifndef LOCKSET_NOCNT
+        epicsAtomicIncrSizeT(&recomputeCnt);
+#endif
+        epicsSpinUnlock(lr->spin);
+
+        /* ls keeps the locker's reference, so can't go to zero */
+        epicsAtomicDecrIntT(&ls->refcount);
+        epicsAtomicIncrIntT(&splitset->refcount);
+    }
+
+    assert(ellCount(&ls->lockRecordList)==(int)nodes[keep].size);
+    assert(epicsAtomicGetIntT(&ls->refcount)>=ellCount(&ls->lockRecordList)+1);
+
+    free(nodes);
+}
+
+/* Partition the lockSets of the records remembered by a batch */
+static void dbLockBatchFinish(lockBatch *batch)
+{
+    size_t gen, i;
+
+    /* splits made from here on are done immediately */
+    batch->depth = 0;
+
+    gen = epicsAtomicIncrSizeT(&batchGen);
+
+    for(i=0; i<batch->npending; i++) {
+        dbCommon *prec = batch->pending[i];
+        dbLocker locker;
+
+        memset(&locker, 0, sizeof(locker));
+        dbLockerPrepare(&locker, &prec, 1);
+        dbScanLockMany(&locker);
+
+        /* skip lockSets already partitioned, or created, by this batch */
+        if(prec->lset->plockSet->batchgen!=gen)
+            dbLockSetPartition(&locker, prec->lset->plockSet, gen);
+
+        dbScanUnlockMany(&locker);
+        dbLockerFinalize(&locker);
+    }
+    batch->npending = 0;
+}
+
+/* A thread which exits inside a batch has its batch ended for it */
+static void dbLockBatchAtThreadExit(void *raw)
+{
+    lockBatch *batch = raw;
+
+    if(batch->depth) {
+        errlogPrintf("Thread %s exiting without dbLockSetBatchEnd()\n",
+                     epicsThreadGetNameSelf());
+        dbLockBatchFinish(batch);
+    }
+    epicsThreadPrivateSet(lockBatchId, NULL);
+    free(batch->pending);
+    free(batch);
+}
+
+void dbLockSetBatchBegin(void)
+{
+    lockBatch *batch;
+
+    epicsThreadOnce(&dbLockOnceInit, &dbLockOnce, NULL);
+
+    batch = epicsThreadPrivateGet(lockBatchId);
+    if(!batch) {
+        batch = callocMustSucceed(1, sizeof(*batch), "dbLockSetBatchBegin");
+        if(epicsAtThreadExit(&dbLockBatchAtThreadExit, batch))
+            cantProceed("dbLockSetBatchBegin() can't register thread exit");
+        epicsThreadPrivateSet(lockBatchId, batch);
+    }
+    batch->depth++;
+}
+
+void dbLockSetBatchEnd(void)
+{
+    lockBatch *batch;
+
+    epicsThreadOnce(&dbLockOnceInit, &dbLockOnce, NULL);
+
+    batch = epicsThreadPrivateGet(lockBatchId);
+    if(!batch || !batch->depth) {
+        errlogPrintf("dbLockSetBatchEnd() called without dbLockSetBatchBegin()\n");
+        return;
+    }
+    if(--batch->depth)
+        return;
+
+    dbLockBatchFinish(batch);
+}
+
 static const char *msstring[4]={"NMS","MS","MSI","MSS"};
 
 long dblsr(char *recordname,int level)
@@ -87,6 +87,26 @@ DBCORE_API void dbScanUnlockMany(dbLocker*);
 DBCORE_API unsigned long dbLockGetLockId(
     struct dbCommon *precord);
 
+/** @brief Begin a batch of link changes.
+ *
+ * Until the matching dbLockSetBatchEnd(), lock sets which may need to be
+ * split because a DB link made by this thread was removed or re-targeted
+ * are left merged, and are partitioned once when the batch ends.
+ * Lock sets are still merged immediately, so records are never under-locked.
+ * Batches may be nested, and only affect the calling thread.
+ * Each call must be matched by a dbLockSetBatchEnd(); if an EPICS thread
+ * exits inside a batch the batch is ended for it, with an error message.
+ * @since UNRELEASED
+ */
+DBCORE_API void dbLockSetBatchBegin(void);
+/** @brief End a batch of link changes.
+ *
+ * Ending the outermost batch splits each lock set touched during the batch
+ * into its connected components.  Must not be called with any record locked.
+ * @since UNRELEASED
+ */
+DBCORE_API void dbLockSetBatchEnd(void);
+
 DBCORE_API void dbLockInitRecords(struct dbBase *pdbbase);
 DBCORE_API void dbLockCleanupRecords(struct dbBase *pdbbase);
 
@@ -39,6 +39,8 @@ typedef struct dbLockSet {
     dbLocker           *ownerlocker;
     ELLNODE             lockernode;
 
+    size_t              batchgen; /* last dbLockSetBatchEnd() partition */
+
     int                 trace; /*For field TPRO*/
 } lockSet;
 
@@ -61,7 +63,7 @@ typedef struct lockRecord {
     dbCommon    *precord;
     epicsSpinId spin;
 
-    /* temp used during lockset split.
+    /* temp used during lockset split and partition.
      * lockSet must be locked for access
      */
     ELLNODE     compnode;
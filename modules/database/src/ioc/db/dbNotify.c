@@ -25,6 +25,7 @@
 #include "dbDefs.h"
 #include "ellLib.h"
 #include "epicsAssert.h"
+#include "epicsAtomic.h"
 #include "epicsEvent.h"
 #include "epicsMutex.h"
 #include "epicsString.h"
@@ -75,6 +76,12 @@ typedef struct notifyPvt {
     short        userCallbackWait;
     epicsEventId cancelEvent;
     epicsEventId userCallbackEvent;
+    /* Set while the thread which called dbProcess() for this
+     * processNotify still holds the record lock.  A completion on
+     * that thread is synchronous, and is finished in-line.
+     */
+    epicsThreadId processThread;
+    short        syncDone;
 } notifyPvt;
 
 /* processNotify groups can span locksets if links are dynamically modified*/
@@ -84,6 +91,18 @@ typedef struct notifyGlobal {
     ELLLIST      freeList;
 } notifyGlobal;
 
+/* Number of processNotify with a notifyPvt, from notifyInit() until
+ * notifyCleanup().  Updated under the global lock but read without it.
+ */
+static size_t notifyOutstanding;
+
+/* Statistics, updated without the global lock */
+static size_t notifyRequests;
+static size_t notifySyncDone;
+static size_t notifyCallbackDone;
+static size_t notifyRestarts;
+static size_t notifyCancels;
+
 static notifyGlobal *pnotifyGlobal = 0;
 
 static void notifyCallback(epicsCallback *pcallback);
@@ -134,7 +153,10 @@ static void notifyInit(processNotify *ppn)
     ppn->wasProcessed = 0;
     pnotifyPvt->state = notifyNotActive;
     pnotifyPvt->cancelWait = pnotifyPvt->userCallbackWait = 0;
+    pnotifyPvt->processThread = NULL;
+    pnotifyPvt->syncDone = 0;
     ppn->pnotifyPvt = pnotifyPvt;
+    epicsAtomicIncrSizeT(&notifyOutstanding);
 }
 
 static void notifyCleanup(processNotify *ppn)
@@ -144,6 +166,12 @@ static void notifyCleanup(processNotify *ppn)
     pnotifyPvt->state = notifyNotActive;
     ellAdd(&pnotifyGlobal->freeList, &pnotifyPvt->node);
     ppn->pnotifyPvt = 0;
+    epicsAtomicDecrSizeT(&notifyOutstanding);
+}
+
+size_t dbNotifyOutstanding(void)
+{
+    return epicsAtomicGetSizeT(&notifyOutstanding);
 }
 
 static void restartCheck(processNotifyRecord *ppnr)
@@ -166,6 +194,7 @@ static void restartCheck(processNotifyRecord *ppnr)
     precord->ppn = pfirst;
     /* request callback for pfirst */
     pnotifyPvt->state = notifyRestartCallbackRequested;
+    epicsAtomicIncrSizeT(&notifyRestarts);
     callbackRequest(&pnotifyPvt->callback);
 }
 
@@ -257,8 +286,21 @@ static void processNotifyCommon(processNotify *ppn, dbCommon *precord, int first
         precord->ppn = ppn;
         ellSafeAdd(&pnotifyPvt->waitList, &precord->ppnr->waitNode);
         pnotifyPvt->state = notifyProcessInProgress;
+        pnotifyPvt->processThread = epicsThreadGetIdSelf();
         epicsMutexUnlock(pnotifyGlobal->lock);
         dbProcess(precord);
+        epicsMutexMustLock(pnotifyGlobal->lock);
+        /* Nothing else can complete or cancel while the record is locked */
+        pnotifyPvt->processThread = NULL;
+        if (pnotifyPvt->syncDone) {
+            /* Synchronous completion, skip the callback hop */
+            pnotifyPvt->syncDone = 0;
+            pnotifyPvt->state = notifyUserCallbackActive;
+            epicsAtomicIncrSizeT(&notifySyncDone);
+            callDone(precord, ppn);
+            return;
+        }
+        epicsMutexUnlock(pnotifyGlobal->lock);
         dbScanUnlock(precord);
         return;
     }
@@ -301,6 +343,7 @@ static void notifyCallback(epicsCallback *pcallback)
     /* All done. Clean up and call userCallback */
     pnotifyPvt->state = notifyUserCallbackActive;
     assert(precord->ppn!=ppn);
+    epicsAtomicIncrSizeT(&notifyCallbackDone);
     callDone(precord, ppn);
 }
 
@@ -332,6 +375,7 @@ void dbProcessNotify(processNotify *ppn)
      * Only dbPutField will change link fields.
      * Also the record is not processed as a result
     */
+    epicsAtomicIncrSizeT(&notifyRequests);
     ppn->status = notifyOK;
     ppn->wasProcessed = 0;
     if (dbfType>=DBF_INLINK && dbfType<=DBF_FWDLINK) {
@@ -388,6 +432,7 @@ void dbNotifyCancel(processNotify *ppn)
     notifyState state;
     notifyPvt *pnotifyPvt;
 
+    epicsAtomicIncrSizeT(&notifyCancels);
     dbScanLock(precord);
     epicsMutexMustLock(pnotifyGlobal->lock);
     ppn->status = notifyCanceled;
@@ -463,7 +508,10 @@ void dbNotifyCompletion(dbCommon *precord)
     else if (pnotifyPvt->state == notifyProcessInProgress) {
         pnotifyPvt->state = notifyUserCallbackRequested;
         restartCheck(precord->ppnr);
-        callbackRequest(&pnotifyPvt->callback);
+        if (pnotifyPvt->processThread == epicsThreadGetIdSelf())
+            pnotifyPvt->syncDone = 1; /* finished by processNotifyCommon() */
+        else
+            callbackRequest(&pnotifyPvt->callback);
     }
     else if(pnotifyPvt->state == notifyRestartInProgress) {
         pnotifyPvt->state = notifyRestartCallbackRequested;
@@ -684,6 +732,14 @@ int dbNotifyDump(void)
     }
     if (lockStatus == epicsMutexLockOK)
         epicsMutexUnlock(pnotifyGlobal->lock);
+    printf("%lu outstanding, %lu requests, %lu completed in-line, "
+        "%lu by callback, %lu restarts, %lu cancels\n",
+        (unsigned long) epicsAtomicGetSizeT(&notifyOutstanding),
+        (unsigned long) epicsAtomicGetSizeT(&notifyRequests),
+        (unsigned long) epicsAtomicGetSizeT(&notifySyncDone),
+        (unsigned long) epicsAtomicGetSizeT(&notifyCallbackDone),
+        (unsigned long) epicsAtomicGetSizeT(&notifyRestarts),
+        (unsigned long) epicsAtomicGetSizeT(&notifyCancels));
     return 0;
 }
 
@@ -12,6 +12,8 @@
 #ifndef INCdbNotifyh
 #define INCdbNotifyh
 
+#include <stddef.h>
+
 #include "dbCoreAPI.h"
 #include "ellLib.h"
 
@@ -97,6 +99,11 @@ DBCORE_API long dbtpn(char *recordname,char *value);
 /* dbNotifyDump is an INVASIVE debug utility. Don't use this needlessly*/
 DBCORE_API int dbNotifyDump(void);
 
+/* Number of dbProcessNotify requests not yet finished, including any whose
+ * doneCallback is running.  Takes no locks, so may be called at any time.
+ */
+DBCORE_API size_t dbNotifyOutstanding(void);
+
 /* This module provides code to handle process notify.
  * client code semantics are:
  * 1) The client code allocates storage for a processNotify structure.
@@ -109,6 +116,9 @@ DBCORE_API int dbNotifyDump(void);
  *    doneCallback - Must be set
  *    usrPvt - For exclusive use of client. dbNotify does not access this field
  * 2) The client calls dbProcessNotify.
+ *    The callbacks below may be called by the thread calling
+ *    dbProcessNotify, before it returns, so the client MUST NOT hold
+ *    any lock while calling dbProcessNotify which its callbacks take.
  * 3) putCallback is called after dbNotify has claimed the record instance
  *    but before a potential process is requested.
  *    The putCallback MUST issue the correct put request
@@ -119,8 +129,15 @@ DBCORE_API int dbNotifyDump(void);
  *    The getCallback MUST issue the correct get request
  *    specified by notifyGetType
  * 5) doneCallback is called when dbNotify has released the record.
- *    The client can issue a new dbProcessNotify request from
- *    doneCallback or anytime after doneCallback returns.
+ *    If no record processed by the request completes asynchronously,
+ *    both getCallback and doneCallback are called by the thread that
+ *    called dbProcessNotify before it returns. Otherwise they are called
+ *    from a callback thread once the last asynchronous record completes.
+ *    The client can issue a new dbProcessNotify request with the same
+ *    processNotify anytime after doneCallback returns, but MUST NOT do
+ *    so from inside doneCallback, which would wait forever for that
+ *    doneCallback to return. Another processNotify may be used from
+ *    doneCallback.
  * 6) The client can call dbNotifyCancel at any time.
  *    If a dbProcessNotify is active, dbNotifyCancel will not return until
  *    the dbNotifyRequest is actually canceled. The client must be prepared
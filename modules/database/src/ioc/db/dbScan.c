@@ -17,6 +17,7 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <limits.h>
 #include <math.h>
@@ -27,6 +28,7 @@
 #include "ellLib.h"
 #include "epicsAtomic.h"
 #include "epicsEvent.h"
+#include "epicsInterrupt.h"
 #include "epicsMutex.h"
 #include "epicsPrint.h"
 #include "epicsRingBytes.h"
@@ -42,6 +44,7 @@
 #include "dbAddr.h"
 #include "dbBase.h"
 #include "dbCommon.h"
+#include "dbCommonPvt.h"
 #include "dbFldTypes.h"
 #include "dbLock.h"
 #include "dbScan.h"
@@ -61,11 +64,22 @@ static volatile enum ctl scanCtl;
 
 /* SCAN ONCE */
 
+/* Each once thread has a queue per PRIO level, and services the highest
+ * priority queue first.  Records are assigned to a thread by their lock
+ * set when first requested, and keep that thread so their requests stay
+ * in order when lock sets are split or merged later.
+ */
+typedef struct once_thread {
+    epicsThreadId       id;
+    epicsEventId        sem;
+    epicsRingBytesId    queue[NUM_CALLBACK_PRIORITIES];
+} once_thread;
+
 static int onceQueueSize = 1000;
-static epicsEventId onceSem;
-static epicsRingBytesId onceQ;
-static int onceQOverruns = 0;
-static epicsThreadId onceTaskId;
+static int onceThreadCount = 1;
+static once_thread *onceThreads;
+static int onceQOverruns[NUM_CALLBACK_PRIORITIES];
+static int onceCoalesced;
 static void *exitOnce;
 
 
@@ -119,9 +133,38 @@ static epicsMutexId event_lock;
 
 /* IO_EVENT*/
 
+/* Latency from scanIoRequest() to the end of a pass, in bins of
+ * 1, 2, 4, ... usec.  The last bin holds everything longer.
+ */
+#define IOSCAN_LATENCY_BINS 24
+
+struct io_scan_list;
+
+/* A slice of the record snapshot of a chunked io_scan_list */
+typedef struct io_scan_chunk {
+    epicsCallback callback;
+    struct io_scan_list *piosl;
+    size_t first, last;
+} io_scan_chunk;
+
 typedef struct io_scan_list {
     epicsCallback callback;
     scan_list scan_list;
+    struct ioscan_head *piosh;
+
+    /* chunked dispatch and latency bookkeeping, guarded by chunkLock */
+    epicsMutexId chunkLock;
+    int pending;            /* chunks of the current pass not yet done */
+    int again;              /* request arrived during the current pass */
+    struct dbCommon **snap; /* records of the current pass */
+    size_t maxsnap;
+    io_scan_chunk *chunks;
+    size_t maxchunks;
+    epicsUInt64 passStart;
+
+    epicsUInt64 requested;  /* time of first request not yet served */
+    size_t latency[IOSCAN_LATENCY_BINS];
+    epicsUInt64 maxLatency;
 } io_scan_list;
 
 typedef struct ioscan_head {
@@ -129,6 +172,7 @@ typedef struct ioscan_head {
     struct io_scan_list iosl[NUM_CALLBACK_PRIORITIES];
     io_scan_complete cb;
     void *arg;
+    unsigned chunkSize;
 } ioscan_head;
 
 static ioscan_head *pioscan_list = NULL;
@@ -137,6 +181,8 @@ static epicsMutexId ioscan_lock;
 /* Private routines */
 static void onceTask(void *);
 static void initOnce(void);
+static void stopOnce(once_thread *pthr);
+static void deleteOnce(void);
 static void periodicTask(void *arg);
 static void initPeriodic(void);
 static void deletePeriodic(void);
@@ -144,8 +190,12 @@ static void spawnPeriodic(int ind);
 static void eventCallback(epicsCallback *pcallback);
 static void ioscanInit(void);
 static void ioscanCallback(epicsCallback *pcallback);
+static io_scan_chunk * ioscanChunk(io_scan_chunk *pchunk);
+static void ioscanChunkCallback(epicsCallback *pcallback);
+static io_scan_chunk * ioscanDispatch(io_scan_list *piosl);
 static void ioscanDestroy(void);
 static void printList(scan_list *psl, char *message);
+static void printLatency(io_scan_list *piosl);
 static void scanList(scan_list *psl);
 static void buildScanLists(void);
 static void addToList(struct dbCommon *precord, scan_list *psl);
@@ -172,9 +222,9 @@ void scanStop(void)
         epicsThreadMustJoin(periodicTaskId[i]);
     }
 
-    scanOnce((dbCommon *)&exitOnce);
-    epicsEventWait(startStopEvent);
-    epicsThreadMustJoin(onceTaskId);
+    for (i = 0; i < onceThreadCount; i++) {
+        stopOnce(&onceThreads[i]);
+    }
 }
 
 void scanCleanup(void)
@@ -183,7 +233,7 @@ void scanCleanup(void)
     deletePeriodic();
     ioscanDestroy();
 
-    epicsRingBytesDelete(onceQ);
+    deleteOnce();
 
     free(periodicTaskId);
     papPeriodic = NULL;
@@ -427,6 +477,35 @@ int scanpel(const char* eventname)   /* print event list */
     return 0;
 }
 
+static void printLatency(io_scan_list *piosl)
+{
+    size_t total = 0;
+    epicsUInt64 maxLatency;
+    int i;
+
+    for (i = 0; i < IOSCAN_LATENCY_BINS; i++)
+        total += epicsAtomicGetSizeT(&piosl->latency[i]);
+    if (!total)
+        return;
+
+    epicsMutexMustLock(piosl->chunkLock);
+    maxLatency = piosl->maxLatency;
+    epicsMutexUnlock(piosl->chunkLock);
+
+    printf("    Latency: %lu passes, max %.1f usec\n", (unsigned long)total,
+        maxLatency * 1e-3);
+    for (i = 0; i < IOSCAN_LATENCY_BINS; i++) {
+        size_t count = epicsAtomicGetSizeT(&piosl->latency[i]);
+
+        if (!count)
+            continue;
+        if (i < IOSCAN_LATENCY_BINS - 1)
+            printf("      < %8lu usec: %lu\n", 1ul << i, (unsigned long)count);
+        else
+            printf("      >=%8lu usec: %lu\n", 1ul << (i - 1), (unsigned long)count);
+    }
+}
+
 int scanpiol(void)                  /* print pioscan_list */
 {
     ioscan_head *piosh;
@@ -442,9 +521,14 @@ int scanpiol(void)                  /* print pioscan_list */
             io_scan_list *piosl = &piosh->iosl[prio];
             char message[80];
 
-            sprintf(message, "IO Event %p: Priority %s",
-                piosh, priorityName[prio]);
+            if (piosh->chunkSize)
+                sprintf(message, "IO Event %p: Priority %s, chunks of %u",
+                    piosh, priorityName[prio], piosh->chunkSize);
+            else
+                sprintf(message, "IO Event %p: Priority %s",
+                    piosh, priorityName[prio]);
             printList(&piosl->scan_list, message);
+            printLatency(piosl);
         }
         piosh = piosh->next;
     }
@@ -576,8 +660,13 @@ static void ioscanDestroy(void)
         int prio;
 
         for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
-            epicsMutexDestroy(piosh->iosl[prio].scan_list.lock);
-            ellFree(&piosh->iosl[prio].scan_list.list);
+            io_scan_list *piosl = &piosh->iosl[prio];
+
+            epicsMutexDestroy(piosl->scan_list.lock);
+            ellFree(&piosl->scan_list.list);
+            epicsMutexDestroy(piosl->chunkLock);
+            free(piosl->snap);
+            free(piosl->chunks);
         }
         free(piosh);
         piosh = pnext;
@@ -598,6 +687,8 @@ void scanIoInit(IOSCANPVT *pioscanpvt)
         callbackSetUser(piosh, &piosl->callback);
         ellInit(&piosl->scan_list.list);
         piosl->scan_list.lock = epicsMutexMustCreate();
+        piosl->piosh = piosh;
+        piosl->chunkLock = epicsMutexMustCreate();
     }
     epicsMutexMustLock(ioscan_lock);
     piosh->next = pioscan_list;
@@ -608,21 +699,32 @@ void scanIoInit(IOSCANPVT *pioscanpvt)
 
 /* Return a bit mask indicating each priority level
  * in which a callback request was successfully queued.
+ * Requests made from interrupt context are not timed.
  */
 unsigned int scanIoRequest(IOSCANPVT piosh)
 {
     int prio;
     unsigned int queued = 0;
+    int timed;
 
     if (scanCtl != ctlRun)
         return 0;
 
+    timed = !epicsInterruptIsInterruptContext();
+
     for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
         io_scan_list *piosl = &piosh->iosl[prio];
 
-        if (ellCount(&piosl->scan_list.list) > 0)
+        if (ellCount(&piosl->scan_list.list) > 0) {
+            if (timed) {
+                epicsMutexMustLock(piosl->chunkLock);
+                if (!piosl->requested)
+                    piosl->requested = epicsMonotonicGet();
+                epicsMutexUnlock(piosl->chunkLock);
+            }
             if (!callbackRequest(&piosl->callback))
                 queued |= 1 << prio;
+        }
     }
 
     return queued;
@@ -657,6 +759,12 @@ void scanIoSetComplete(IOSCANPVT piosh, io_scan_complete cb, void *arg)
     piosh->arg = arg;
 }
 
+/* May not be called while a scan request is queued or running */
+void scanIoSetChunkSize(IOSCANPVT piosh, unsigned size)
+{
+    piosh->chunkSize = size;
+}
+
 int scanOnce(struct dbCommon *precord) {
     return scanOnceCallback(precord, NULL, NULL);
 }
@@ -667,41 +775,90 @@ typedef struct {
     void *usr;
 } onceEntry;
 
-int scanOnceCallback(struct dbCommon *precord, once_complete cb, void *usr)
+static int oncePut(once_thread *pthr, int prio, const onceEntry *pent)
 {
     static int newOverflow = TRUE;
-    onceEntry ent;
-    int pushOK;
-
-    ent.prec = precord;
-    ent.cb = cb;
-    ent.usr = usr;
-
-    pushOK = epicsRingBytesPut(onceQ, (void*)&ent, sizeof(ent));
+    int pushOK = epicsRingBytesPut(pthr->queue[prio], (void*)pent, sizeof(*pent));
 
     if (!pushOK) {
         if (newOverflow) errlogPrintf("scanOnce: Ring buffer overflow\n");
         newOverflow = FALSE;
-        epicsAtomicIncrIntT(&onceQOverruns);
+        epicsAtomicIncrIntT(&onceQOverruns[prio]);
     } else {
         newOverflow = TRUE;
     }
-    epicsEventSignal(onceSem);
+    epicsEventSignal(pthr->sem);
+
+    return pushOK;
+}
+
+static once_thread * onceThreadOf(struct dbCommon *precord)
+{
+    dbCommonPvt *ppvt = dbRec2Pvt(precord);
+    int slot = epicsAtomicGetIntT(&ppvt->onceThread);
+
+    if (!slot) {
+        int old;
+
+        slot = 1 + (int) (dbLockGetLockId(precord) % onceThreadCount);
+        old = epicsAtomicCmpAndSwapIntT(&ppvt->onceThread, 0, slot);
+        if (old)
+            slot = old;
+    }
+    return &onceThreads[slot - 1];
+}
+
+int scanOnceCallback(struct dbCommon *precord, once_complete cb, void *usr)
+{
+    dbCommonPvt *ppvt = dbRec2Pvt(precord);
+    once_thread *pthr = onceThreads;
+    onceEntry ent;
+    int prio = precord->prio;
+
+    /* A plain request for a record which is already queued, and has not
+     * yet been taken by its once thread, is satisfied by that entry.
+     */
+    if (!cb && epicsAtomicCmpAndSwapIntT(&ppvt->oncePending, 0, 1)) {
+        epicsAtomicIncrIntT(&onceCoalesced);
+        return 0;
+    }
+
+    if (prio < 0 || prio >= NUM_CALLBACK_PRIORITIES)
+        prio = priorityLow;
+    if (onceThreadCount > 1)
+        pthr = onceThreadOf(precord);
 
-    return !pushOK;
+    ent.prec = precord;
+    ent.cb = cb;
+    ent.usr = usr;
+
+    if (oncePut(pthr, prio, &ent))
+        return 0;
+
+    if (!cb)
+        epicsAtomicSetIntT(&ppvt->oncePending, 0);
+    return 1;
 }
 
 static void onceTask(void *arg)
 {
+    once_thread *pthr = (once_thread *)arg;
+
     taskwdInsert(0, NULL, NULL);
     epicsEventSignal(startStopEvent);
 
     while (TRUE) {
 
-        epicsEventMustWait(onceSem);
+        epicsEventMustWait(pthr->sem);
         while(1) {
             onceEntry ent;
-            int bytes = epicsRingBytesGet(onceQ, (void*)&ent, sizeof(ent));
+            int prio, bytes = 0;
+
+            for (prio = NUM_CALLBACK_PRIORITIES - 1; prio >= 0; prio--) {
+                bytes = epicsRingBytesGet(pthr->queue[prio], (void*)&ent, sizeof(ent));
+                if (bytes)
+                    break;
+            }
             if(bytes==0)
                 break;
             if(bytes!=sizeof(ent)) {
@@ -710,6 +867,10 @@ static void onceTask(void *arg)
                 continue; /* what to do? */
             } else if (ent.prec == (void*)&exitOnce) goto shutdown;
 
+            /* requests made from here on need another pass */
+            if (!ent.cb)
+                epicsAtomicSetIntT(&dbRec2Pvt(ent.prec)->oncePending, 0);
+
             dbScanLock(ent.prec);
             dbProcess(ent.prec);
             dbScanUnlock(ent.prec);
@@ -723,62 +884,178 @@ shutdown:
     epicsEventSignal(startStopEvent);
 }
 
+/* Queued behind all other low priority requests */
+static void stopOnce(once_thread *pthr)
+{
+    onceEntry ent;
+
+    ent.prec = (dbCommon *)&exitOnce;
+    ent.cb = NULL;
+    ent.usr = NULL;
+    while (!oncePut(pthr, priorityLow, &ent))
+        epicsThreadSleep(0.1);
+    epicsEventWait(startStopEvent);
+    epicsThreadMustJoin(pthr->id);
+}
+
+static void deleteOnce(void)
+{
+    int i, prio;
+
+    for (i = 0; i < onceThreadCount; i++) {
+        for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++)
+            epicsRingBytesDelete(onceThreads[i].queue[prio]);
+        epicsEventDestroy(onceThreads[i].sem);
+    }
+    free(onceThreads);
+    onceThreads = NULL;
+}
+
 int scanOnceSetQueueSize(int size)
 {
     onceQueueSize = size;
     return 0;
 }
 
+int scanOnceSetThreads(int count)
+{
+    if (onceThreads) {
+        fprintf(stderr, "scanOnce system already initialized\n");
+        return -1;
+    }
+    if (count < 1)
+        count = 1;
+    onceThreadCount = count;
+    return 0;
+}
+
+static void onceQueueStatus(const int reset, int prio, scanOnceQueueStats *result)
+{
+    int i;
+
+    result->size = result->numUsed = result->maxUsed = 0;
+    for (i = 0; i < onceThreadCount; i++) {
+        epicsRingBytesId q = onceThreads[i].queue[prio];
+
+        result->size += epicsRingBytesSize(q) / sizeof(onceEntry);
+        result->numUsed += epicsRingBytesUsedBytes(q) / sizeof(onceEntry);
+        result->maxUsed += epicsRingBytesHighWaterMark(q) / sizeof(onceEntry);
+        if (reset)
+            epicsRingBytesResetHighWaterMark(q);
+    }
+    result->numOverflow = epicsAtomicGetIntT(&onceQOverruns[prio]);
+}
+
+/* Usage of the fullest queue; each queue holds up to onceQueueSize
+ * entries, as the single queue did before.
+ */
 int scanOnceQueueStatus(const int reset, scanOnceQueueStats *result)
 {
-    int ret;
-    if (!onceQ) return -1;
+    int i, prio, ret = -2;
+
+    if (!onceThreads) return -1;
     if (result) {
-        result->size = epicsRingBytesSize(onceQ) / sizeof(onceEntry);
-        result->numUsed = epicsRingBytesUsedBytes(onceQ) / sizeof(onceEntry);
-        result->maxUsed = epicsRingBytesHighWaterMark(onceQ) / sizeof(onceEntry);
-        result->numOverflow = epicsAtomicGetIntT(&onceQOverruns);
+        memset(result, 0, sizeof(*result));
+        result->size = onceQueueSize;
         ret = 0;
-    } else {
-        ret = -2;
     }
-    if (reset) {
-        epicsRingBytesResetHighWaterMark(onceQ);
+    for (i = 0; i < onceThreadCount; i++) {
+        for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
+            epicsRingBytesId q = onceThreads[i].queue[prio];
+
+            if (result) {
+                int used = epicsRingBytesUsedBytes(q) / sizeof(onceEntry);
+                int maxUsed = epicsRingBytesHighWaterMark(q) / sizeof(onceEntry);
+
+                if (used > result->numUsed)
+                    result->numUsed = used;
+                if (maxUsed > result->maxUsed)
+                    result->maxUsed = maxUsed;
+            }
+            if (reset)
+                epicsRingBytesResetHighWaterMark(q);
+        }
+    }
+    if (result) {
+        for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++)
+            result->numOverflow += epicsAtomicGetIntT(&onceQOverruns[prio]);
     }
     return ret;
 }
 
-void scanOnceQueueShow(const int reset)
+/* Totals over the queues of one priority in all threads */
+int scanOnceQueueStatusPrio(int prio, const int reset,
+    scanOnceQueueStats *result)
 {
     scanOnceQueueStats stats;
-    if (scanOnceQueueStatus(reset, &stats) == -1) {
+
+    if (!onceThreads) return -1;
+    if (prio < 0 || prio >= NUM_CALLBACK_PRIORITIES) return -1;
+    onceQueueStatus(reset, prio, result ? result : &stats);
+    return result ? 0 : -2;
+}
+
+void scanOnceQueueShow(const int reset)
+{
+    if (!onceThreads) {
         fprintf(stderr, "scanOnce system not initialized, yet. Please run "
             "iocInit before using this command.\n");
     } else {
-        double qusage = 100.0 * stats.numUsed / stats.size;
+        int prio;
+
         printf("PRIORITY  HIGH-WATER MARK  ITEMS IN Q  Q SIZE  %% USED  Q OVERFLOWS\n");
-        printf("%8s  %15d  %10d  %6d  %6.1f  %11d\n", "scanOnce", stats.maxUsed,
-               stats.numUsed, stats.size, qusage,
-               epicsAtomicGetIntT(&onceQOverruns));
+        for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
+            scanOnceQueueStats stats;
+            double qusage;
+
+            onceQueueStatus(reset, prio, &stats);
+            qusage = 100.0 * stats.numUsed / stats.size;
+            printf("%8s  %15d  %10d  %6d  %6.1f  %11d\n", priorityName[prio],
+                   stats.maxUsed, stats.numUsed, stats.size, qusage,
+                   stats.numOverflow);
+        }
+        printf("%d scanOnce thread%s, %d requests coalesced\n",
+               onceThreadCount, onceThreadCount == 1 ? "" : "s",
+               epicsAtomicGetIntT(&onceCoalesced));
     }
 }
 
 static void initOnce(void)
 {
     epicsThreadOpts opts = EPICS_THREAD_OPTS_INIT;
+    int i, prio;
+
     opts.joinable = 1;
     opts.priority = epicsThreadPriorityScanLow + nPeriodic;
     opts.stackSize = epicsThreadStackBig;
-    if ((onceQ = epicsRingBytesLockedCreate(sizeof(onceEntry)*onceQueueSize)) == NULL) {
-        cantProceed("initOnce: Ring buffer create failed\n");
-    }
-    if(!onceSem)
-        onceSem = epicsEventMustCreate(epicsEventEmpty);
-    onceTaskId = epicsThreadCreateOpt("scanOnce", onceTask, 0, &opts);
 
-    epicsEventWait(startStopEvent);
+    onceThreads = callocMustSucceed(onceThreadCount, sizeof(once_thread),
+        "initOnce");
+    for (i = 0; i < onceThreadCount; i++) {
+        once_thread *pthr = &onceThreads[i];
+        char name[20];
+
+        for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++) {
+            pthr->queue[prio] =
+                epicsRingBytesLockedCreate(sizeof(onceEntry)*onceQueueSize);
+            if (!pthr->queue[prio])
+                cantProceed("initOnce: Ring buffer create failed\n");
+        }
+        pthr->sem = epicsEventMustCreate(epicsEventEmpty);
+
+        if (i == 0)
+            strcpy(name, "scanOnce");
+        else
+            epicsSnprintf(name, sizeof(name), "scanOnce-%d", i);
+        pthr->id = epicsThreadCreateOpt(name, onceTask, pthr, &opts);
+
+        epicsEventWait(startStopEvent);
+    }
+    epicsAtomicSetIntT(&onceCoalesced, 0);
+    for (prio = 0; prio < NUM_CALLBACK_PRIORITIES; prio++)
+        epicsAtomicSetIntT(&onceQOverruns[prio], 0);
 }
-
+
 static void periodicTask(void *arg)
 {
     periodic_scan_list *ppsl = (periodic_scan_list *)arg;
@@ -952,18 +1229,178 @@ static void spawnPeriodic(int ind)
     epicsEventWait(startStopEvent);
 }
 
+/* Caller must hold piosl->chunkLock */
+static void ioscanLatency(io_scan_list *piosl, epicsUInt64 start)
+{
+    epicsUInt64 lat;
+    int bin = 0;
+
+    if (!start)
+        return; /* scanIoImmediate() */
+    lat = epicsMonotonicGet() - start;
+    while (bin < IOSCAN_LATENCY_BINS - 1 && lat >= (1000ull << bin))
+        bin++;
+    epicsAtomicIncrSizeT(&piosl->latency[bin]);
+    if (lat > piosl->maxLatency)
+        piosl->maxLatency = lat;
+}
+
 static void ioscanCallback(epicsCallback *pcallback)
 {
     ioscan_head *piosh;
+    io_scan_list *piosl;
+    epicsUInt64 start;
     int prio;
 
     callbackGetUser(piosh, pcallback);
     callbackGetPriority(prio, pcallback);
-    scanList(&piosh->iosl[prio].scan_list);
+    piosl = &piosh->iosl[prio];
+
+    if (piosh->chunkSize) {
+        io_scan_chunk *pchunk = ioscanDispatch(piosl);
+
+        while (pchunk)
+            pchunk = ioscanChunk(pchunk);
+        return;
+    }
+
+    epicsMutexMustLock(piosl->chunkLock);
+    start = piosl->requested;
+    piosl->requested = 0;
+    epicsMutexUnlock(piosl->chunkLock);
+    scanList(&piosl->scan_list);
+    epicsMutexMustLock(piosl->chunkLock);
+    ioscanLatency(piosl, start);
+    epicsMutexUnlock(piosl->chunkLock);
     if (piosh->cb)
         piosh->cb(piosh->arg, piosh, prio);
 }
 
+/* Process one slice of the snapshot.  The chunk which finishes a pass
+ * signals completion, and queues the next pass if one was requested
+ * meanwhile.  Returns the first chunk of that pass for the caller to
+ * run only if it could not be queued, otherwise NULL.
+ */
+static io_scan_chunk * ioscanChunk(io_scan_chunk *pchunk)
+{
+    io_scan_list *piosl = pchunk->piosl;
+    ioscan_head *piosh = piosl->piosh;
+    scan_list *psl = &piosl->scan_list;
+    int prio = piosl->callback.priority;
+    size_t i;
+    int again;
+
+    for (i = pchunk->first; i < pchunk->last; i++) {
+        struct dbCommon *precord = piosl->snap[i];
+        scan_element *pse;
+        int member;
+
+        /* skip records removed from this list since the snapshot */
+        epicsMutexMustLock(psl->lock);
+        pse = precord->spvt;
+        member = pse && pse->pscan_list == psl;
+        epicsMutexUnlock(psl->lock);
+        if (!member)
+            continue;
+
+        dbScanLock(precord);
+        dbProcess(precord);
+        dbScanUnlock(precord);
+    }
+
+    /* pchunk may be re-used as soon as pending reaches zero */
+    epicsMutexMustLock(piosl->chunkLock);
+    if (--piosl->pending) {
+        epicsMutexUnlock(piosl->chunkLock);
+        return NULL;
+    }
+    again = piosl->again;
+    piosl->again = FALSE;
+    ioscanLatency(piosl, piosl->passStart);
+    epicsMutexUnlock(piosl->chunkLock);
+
+    if (piosh->cb)
+        piosh->cb(piosh->arg, piosh, prio);
+
+    /* Let this thread return to its queue between passes */
+    if (again && callbackRequest(&piosl->callback))
+        return ioscanDispatch(piosl);
+    return NULL;
+}
+
+static void ioscanChunkCallback(epicsCallback *pcallback)
+{
+    io_scan_chunk *pchunk;
+
+    callbackGetUser(pchunk, pcallback);
+    while (pchunk)
+        pchunk = ioscanChunk(pchunk);
+}
+
+/* Start a chunked pass over a snapshot of the list, or note that
+ * another pass is needed if one is still running.  Returns the chunk
+ * for the caller to run, NULL if no pass was started.
+ */
+static io_scan_chunk * ioscanDispatch(io_scan_list *piosl)
+{
+    ioscan_head *piosh = piosl->piosh;
+    scan_list *psl = &piosl->scan_list;
+    unsigned chunkSize = piosh->chunkSize;
+    size_t n, nchunks, i;
+    scan_element *pse;
+
+    epicsMutexMustLock(piosl->chunkLock);
+    if (piosl->pending) {
+        piosl->again = TRUE;
+        epicsMutexUnlock(piosl->chunkLock);
+        return NULL;
+    }
+    piosl->passStart = piosl->requested;
+    piosl->requested = 0;
+
+    epicsMutexMustLock(psl->lock);
+    n = ellCount(&psl->list);
+    if (n > piosl->maxsnap) {
+        free(piosl->snap);
+        piosl->snap = dbCalloc(n, sizeof(*piosl->snap));
+        piosl->maxsnap = n;
+    }
+    for (pse = (scan_element *)ellFirst(&psl->list), i = 0; pse;
+         pse = (scan_element *)ellNext(&pse->node), i++)
+        piosl->snap[i] = pse->precord;
+    epicsMutexUnlock(psl->lock);
+
+    nchunks = n ? (n + chunkSize - 1) / chunkSize : 1;
+    if (nchunks > piosl->maxchunks) {
+        free(piosl->chunks);
+        piosl->chunks = dbCalloc(nchunks, sizeof(*piosl->chunks));
+        piosl->maxchunks = nchunks;
+    }
+    for (i = 0; i < nchunks; i++) {
+        io_scan_chunk *pchunk = &piosl->chunks[i];
+
+        callbackSetCallback(ioscanChunkCallback, &pchunk->callback);
+        callbackSetPriority(piosl->callback.priority, &pchunk->callback);
+        callbackSetUser(pchunk, &pchunk->callback);
+        pchunk->piosl = piosl;
+        pchunk->first = i * chunkSize;
+        pchunk->last = pchunk->first + chunkSize;
+        if (pchunk->last > n)
+            pchunk->last = n;
+    }
+    piosl->pending = nchunks;
+    epicsMutexUnlock(piosl->chunkLock);
+
+    /* Other callback threads of this priority take the rest.  Chunk 0
+     * is still pending, so none of these can finish the pass.
+     */
+    for (i = 1; i < nchunks; i++) {
+        if (callbackRequest(&piosl->chunks[i].callback))
+            ioscanChunk(&piosl->chunks[i]);
+    }
+    return &piosl->chunks[0];
+}
+
 static void printList(scan_list *psl, char *message)
 {
     scan_element *pse;
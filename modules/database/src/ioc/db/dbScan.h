@@ -65,7 +65,29 @@ DBCORE_API double scanPeriod(int scan);
 DBCORE_API int scanOnce(struct dbCommon *);
 DBCORE_API int scanOnceCallback(struct dbCommon *, once_complete cb, void *usr);
 DBCORE_API int scanOnceSetQueueSize(int size);
+/** @brief Set the number of scanOnce threads.
+ *
+ * Records are assigned to a thread by their lock set when first queued,
+ * and stay with that thread.
+ * Must be called before iocInit().
+ * @since UNRELEASED
+ */
+DBCORE_API int scanOnceSetThreads(int count);
+/** @brief Report the state of the scanOnce queues.
+ *
+ * size is the capacity of one queue. numUsed and maxUsed are the largest
+ * over all queues, and numOverflow counts the requests dropped from all
+ * queues. With one thread and all records at the same PRIO this
+ * describes the one queue in use.
+ */
 DBCORE_API int scanOnceQueueStatus(const int reset, scanOnceQueueStats *result);
+/** @brief Report the scanOnce queues of one PRIO level.
+ *
+ * The values are totals over the queues of that priority in all threads.
+ * @since UNRELEASED
+ */
+DBCORE_API int scanOnceQueueStatusPrio(int prio, const int reset,
+    scanOnceQueueStats *result);
 DBCORE_API void scanOnceQueueShow(const int reset);
 
 /*print periodic lists*/
@@ -81,6 +103,16 @@ DBCORE_API void scanIoInit(IOSCANPVT *ppios);
 DBCORE_API unsigned int scanIoRequest(IOSCANPVT pios);
 DBCORE_API unsigned int scanIoImmediate(IOSCANPVT pios, int prio);
 DBCORE_API void scanIoSetComplete(IOSCANPVT, io_scan_complete, void *usr);
+/** @brief Split I/O Intr scans into chunks of records.
+ *
+ * When size is non-zero, each scanIoRequest() pass over a priority list is
+ * divided into chunks of at most size records, which are queued as separate
+ * callbacks so that callbackParallelThreads() can run them concurrently.
+ * The completion function is called once all chunks of a pass are done.
+ * May not be called while a scan request is queued or running.
+ * @since UNRELEASED
+ */
+DBCORE_API void scanIoSetChunkSize(IOSCANPVT, unsigned size);
 
 #ifdef __cplusplus
 }
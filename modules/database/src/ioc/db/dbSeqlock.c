@@ -0,0 +1,174 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Sequence-locked copies of scalar record values, see dbSeqlockPvt.h
+ *
+ * The writer (holding the record lock) makes the sequence number odd,
+ * copies the fields, then makes it even again.  A reader copies the
+ * fields between two reads of the sequence number and retries if it
+ * was odd or changed in between.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbDefs.h"
+#include "epicsAtomic.h"
+#include "errlog.h"
+
+#include "dbAccessDefs.h"
+#include "dbAddr.h"
+#include "dbBase.h"
+#include "dbCommon.h"
+#include "dbConvertFast.h"
+#include "dbFldTypes.h"
+#include "dbSeqlockPvt.h"
+#include "special.h"
+#include "epicsExport.h"
+
+int dbSeqlockReads = 0;
+epicsExportAddress(int, dbSeqlockReads);
+
+/* Give up and take the lock after this many collisions with a writer */
+#define MAX_RETRIES 100
+
+void dbSeqlockInitRecord(dbCommon *prec)
+{
+    dbFldDes *pflddes = prec->rdes->pvalFldDes;
+    dbSeqlock *psl;
+
+    if (!dbSeqlockReads || !pflddes ||
+        pflddes->field_type > DBF_DEVICE ||
+        pflddes->special == SPC_DBADDR ||
+        pflddes->size > sizeof(psl->val))
+        return;
+
+    psl = calloc(1, sizeof(*psl));
+    if (!psl) {
+        errlogPrintf("dbSeqlockInitRecord: No memory for %s\n", prec->name);
+        return;
+    }
+    psl->field_type = pflddes->field_type;
+    psl->pfield = (char *)prec + pflddes->offset;
+    dbRec2Pvt(prec)->seqlock = psl;
+    dbSeqlockPublish(prec);
+}
+
+void dbSeqlockFreeRecord(dbCommon *prec)
+{
+    dbCommonPvt *ppvt = dbRec2Pvt(prec);
+
+    free(ppvt->seqlock);
+    ppvt->seqlock = NULL;
+}
+
+void dbSeqlockPublish(dbCommon *prec)
+{
+    dbSeqlock *psl = dbRec2Pvt(prec)->seqlock;
+    int seq = psl->seq;
+
+    epicsAtomicSetIntT(&psl->seq, seq + 1);
+    epicsAtomicWriteMemoryBarrier();
+
+    psl->stat = prec->stat;
+    psl->sevr = prec->sevr;
+    psl->acks = prec->acks;
+    psl->ackt = prec->ackt;
+    psl->time = prec->time;
+    memcpy(&psl->val, psl->pfield, prec->rdes->pvalFldDes->size);
+
+    epicsAtomicWriteMemoryBarrier();
+    epicsAtomicSetIntT(&psl->seq, seq + 2);
+}
+
+long dbSeqlockGet(DBADDR *paddr, short dbrType, void *pvalue,
+    dbSeqlockMeta *pmeta)
+{
+    dbSeqlock *psl = dbRec2Pvt(paddr->precord)->seqlock;
+    dbSeqlock copy;
+    DBADDR addr;
+    int tries;
+
+    if (!psl || paddr->pfield != psl->pfield ||
+        paddr->field_type != psl->field_type ||
+        paddr->no_elements != 1 ||
+        INVALID_DB_REQ(dbrType) || dbrType > DBR_ENUM ||
+        /* String conversions may need record support */
+        (dbrType == DBR_STRING && psl->field_type != DBF_STRING))
+        return -1;
+
+    for (tries = 0; tries < MAX_RETRIES; tries++) {
+        int seq = epicsAtomicGetIntT(&psl->seq);
+
+        if (seq & 1)
+            continue;
+        epicsAtomicReadMemoryBarrier();
+        copy = *psl;
+        epicsAtomicReadMemoryBarrier();
+        if (epicsAtomicGetIntT(&psl->seq) == seq)
+            break;
+    }
+    if (tries == MAX_RETRIES)
+        return -1;
+
+    addr = *paddr;
+    addr.pfield = &copy.val;
+    if (dbFastGetConvertRoutine[copy.field_type][dbrType](&copy.val,
+            pvalue, &addr))
+        return -1;
+
+    if (pmeta) {
+        pmeta->stat = copy.stat;
+        pmeta->sevr = copy.sevr;
+        pmeta->acks = copy.acks;
+        pmeta->ackt = copy.ackt;
+        pmeta->time = copy.time;
+    }
+    return 0;
+}
+
+long dbSeqlockGetField(DBADDR *paddr, short dbrType, void *pbuffer,
+    long *options, long *nRequest)
+{
+    long opts = options ? *options : 0;
+    char *pbuf = pbuffer;
+    dbSeqlockMeta meta;
+    void *pvalue;
+
+    if ((opts & ~(DBR_STATUS | DBR_TIME)) ||
+        !nRequest || *nRequest < 1)
+        return -1;
+
+    /* Same layout as getOptions() in dbAccess.c */
+    if (opts & DBR_STATUS)
+        pbuf += 4 * sizeof(epicsUInt16);
+    if (opts & DBR_TIME)
+        pbuf += 2 * sizeof(epicsUInt32);
+    pvalue = pbuf;
+
+    if (dbSeqlockGet(paddr, dbrType, pvalue, &meta))
+        return -1;
+
+    pbuf = pbuffer;
+    if (opts & DBR_STATUS) {
+        epicsUInt16 *pushort = (epicsUInt16 *)pbuf;
+
+        *pushort++ = meta.stat;
+        *pushort++ = meta.sevr;
+        *pushort++ = meta.acks;
+        *pushort++ = meta.ackt;
+        pbuf = (char *)pushort;
+    }
+    if (opts & DBR_TIME) {
+        epicsUInt32 *ptime = (epicsUInt32 *)pbuf;
+
+        *ptime++ = meta.time.secPastEpoch;
+        *ptime++ = meta.time.nsec;
+    }
+    *nRequest = 1;
+    return 0;
+}
@@ -0,0 +1,83 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Sequence-locked copies of scalar record values.
+ *
+ * When dbSeqlockReads is set before iocInit, each record with a scalar
+ * VAL field gets a small structure holding a copy of VAL, STAT, SEVR,
+ * ACKS, ACKT and TIME.  The copy is refreshed by the code paths which
+ * change those fields, all of which run with the record locked.  Readers
+ * which only want the value, alarm status and time stamp can then take
+ * a consistent copy without calling dbScanLock(), retrying if they race
+ * with an update.  Readers fall back to the locked path whenever the
+ * request can't be satisfied from the copy.
+ */
+
+#ifndef INC_dbSeqlockPvt_H
+#define INC_dbSeqlockPvt_H
+
+#include "epicsTime.h"
+#include "epicsTypes.h"
+#include "dbCommonPvt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dbAddr;
+
+typedef struct dbSeqlock {
+    /* odd while an update is in progress */
+    int seq;
+    short field_type;
+    void *pfield;
+    epicsUInt16 stat, sevr, acks, ackt;
+    epicsTimeStamp time;
+    union {
+        double d;
+        epicsUInt64 u64;
+        char s[MAX_STRING_SIZE];
+    } val;
+} dbSeqlock;
+
+/* Alarm and time stamp state read along with the value */
+typedef struct dbSeqlockMeta {
+    epicsUInt16 stat, sevr, acks, ackt;
+    epicsTimeStamp time;
+} dbSeqlockMeta;
+
+/* Called during iocInit and iocShutdown */
+void dbSeqlockInitRecord(dbCommon *prec);
+void dbSeqlockFreeRecord(dbCommon *prec);
+
+/* Writers must hold the record lock */
+void dbSeqlockPublish(dbCommon *prec);
+
+static EPICS_ALWAYS_INLINE
+void dbSeqlockUpdate(dbCommon *prec)
+{
+    if (dbRec2Pvt(prec)->seqlock)
+        dbSeqlockPublish(prec);
+}
+
+/* Read the value converted to dbrType without locking the record.
+ * Returns 0 on success, or -1 if the caller must use the locked path.
+ */
+long dbSeqlockGet(struct dbAddr *paddr, short dbrType, void *pvalue,
+    dbSeqlockMeta *pmeta);
+
+/* As dbGetField() for the DBR_STATUS and DBR_TIME options only.
+ * Returns 0 on success, or -1 if the caller must use the locked path.
+ */
+long dbSeqlockGetField(struct dbAddr *paddr, short dbrType, void *pbuffer,
+    long *options, long *nRequest);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_dbSeqlockPvt_H */
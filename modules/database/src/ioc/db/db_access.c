@@ -41,6 +41,7 @@
 #include "dbEvent.h"
 #include "dbLock.h"
 #include "dbNotify.h"
+#include "dbSeqlockPvt.h"
 #include "dbStaticLib.h"
 #include "recSup.h"
 
@@ -137,6 +138,50 @@ int dbChannel_get(struct dbChannel *chan,
     return result;
 }
 
+/* Plain, STS and TIME requests for a scalar VAL field may be served from
+ * the record's sequence-locked copy without taking the lock.
+ * Returns 0 on success, or -1 if the caller must use the locked path.
+ */
+static int dbChannel_get_seqlock(struct dbChannel *chan, int buffer_type,
+    void *pbuffer, long *nRequest, void *pfl)
+{
+    /* Must match the types used by dbChannel_get_count() below */
+    static const short newType[oldDBR_TIME_DOUBLE + 1] = {
+        DBR_STRING, DBR_SHORT, DBR_FLOAT, DBR_ENUM, DBR_CHAR, DBR_LONG,
+        DBR_DOUBLE,
+        DBR_STRING, DBR_SHORT, DBR_FLOAT, DBR_ENUM, DBR_UCHAR, DBR_LONG,
+        DBR_DOUBLE,
+        DBR_STRING, DBR_SHORT, DBR_FLOAT, DBR_ENUM, DBR_CHAR, DBR_LONG,
+        DBR_DOUBLE
+    };
+    dbSeqlockMeta meta;
+    char *pvalue;
+
+    if (pfl || buffer_type < 0 || buffer_type > oldDBR_TIME_DOUBLE ||
+        *nRequest < 1 || !dbRec2Pvt(dbChannelRecord(chan))->seqlock)
+        return -1;
+
+    /* The value is the last member of each of these structures */
+    pvalue = (char *)pbuffer + dbr_size[buffer_type] -
+        dbr_value_size[buffer_type];
+    if (dbSeqlockGet(&chan->addr, newType[buffer_type], pvalue, &meta))
+        return -1;
+
+    if (buffer_type >= oldDBR_STS_STRING) {
+        struct dbr_sts_string *psts = (struct dbr_sts_string *)pbuffer;
+
+        psts->status = meta.stat;
+        psts->severity = meta.sevr;
+    }
+    if (buffer_type >= oldDBR_TIME_STRING) {
+        struct dbr_time_string *ptime = (struct dbr_time_string *)pbuffer;
+
+        ptime->stamp = meta.time;           /* structure copy */
+    }
+    *nRequest = 1;
+    return 0;
+}
+
 /* Performs the work of the public db_get_field API, but also returns the number
  * of elements actually copied to the buffer.  The caller is responsible for
  * zeroing the remaining part of the buffer. */
@@ -154,6 +199,9 @@ int dbChannel_get_count(
     * in the dbAccess.c dbGet() and getOptions() routines.
     */
 
+    if (!dbChannel_get_seqlock(chan, buffer_type, pbuffer, nRequest, pfl))
+        return 0;
+
     dbScanLock(dbChannelRecord(chan));
 
     switch(buffer_type) {
@@ -60,6 +60,7 @@ union native_value {
  *  an event is triggered.
  */
 struct db_field_log;
+struct evSubscrip;
 typedef void (dbfl_freeFunc)(struct db_field_log *pfl);
 
 /*
@@ -129,6 +130,8 @@ typedef struct db_field_log {
         struct dbfl_val v;
         struct dbfl_ref r;
     } u;
+    /* only for dbfl_context_event */
+    struct evSubscrip  *sub;  /* Subscription being updated */
 } db_field_log;
 
 /*
@@ -42,6 +42,7 @@
 #include "dbLink.h"
 #include "dbNotify.h"
 #include "dbScan.h"
+#include "dbSeqlockPvt.h"
 #include "devSup.h"
 #include "link.h"
 #include "recGbl.h"
@@ -218,6 +219,7 @@ unsigned short recGblResetAlarms(void *precord)
         if (recGblAlarmHook) {
             (*recGblAlarmHook)(pdbc, prev_sevr, prev_stat);
         }
+        dbSeqlockUpdate(pdbc);
     }
     return val_mask;
 }
@@ -283,6 +285,7 @@ void recGblFwdLink(void *precord)
 {
     dbCommon *pdbc = precord;
 
+    dbSeqlockUpdate(pdbc);
     dbScanFwdLink(&pdbc->flnk);
     /*Handle dbPutFieldNotify record completions*/
     if(pdbc->ppn) dbNotifyCompletion(pdbc);
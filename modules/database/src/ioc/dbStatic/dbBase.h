@@ -44,6 +44,7 @@ typedef struct devSup {
     /*Following only available on run time system*/
     dset            *pdset;
     struct dsxt     *pdsxt;       /* Extended device support */
+    int             threadSafeInit; /* init_record() may run in parallel */
 }devSup;
 
 typedef struct linkSup {
@@ -167,8 +168,11 @@ typedef struct dbRecordType {
     /*The following are only available on run time system*/
     rset            *prset;
     int             rec_size;       /*record size in bytes          */
+    struct dbRecDefaults *pdefaults;/*converted field initial values*/
+    int             threadSafeInit; /*init_record() may run in parallel*/
 }dbRecordType;
 
+struct dbRecDefaults;   /* Contents private to dbStaticRun code */
 struct dbPvd;           /* Contents private to dbPvdLib code */
 struct gphPvt;          /* Contents private to gpHashLib code */
 
@@ -192,5 +196,9 @@ typedef struct dbBase {
      *  @since UNRELEASED
      */
     unsigned        no_records;
+    /** Incremented when a record or alias is added, renamed or removed.
+     *  @since UNRELEASED
+     */
+    unsigned        nameGeneration;
 }dbBase;
 #endif
@@ -24,6 +24,7 @@
 #include "dbBase.h"
 #include "dbStaticLib.h"
 #include "dbStaticPvt.h"
+#include "iocInit.h"
 
 typedef struct {
     ELLLIST      list;
@@ -33,6 +34,7 @@ typedef struct {
 typedef struct dbPvd {
     unsigned int size;
     unsigned int mask;
+    unsigned int count;
     dbPvdBucket **buckets;
 } dbPvd;
 
@@ -42,6 +44,13 @@ unsigned int dbPvdHashTableSize = 0;
 #define DEFAULT_SIZE 512
 #define MAX_SIZE 65536
 
+/* While the database is being loaded the table is doubled in size
+ * whenever it holds more than GROW_LOAD entries per bucket on average,
+ * so record creation doesn't slow down as the record count grows.
+ */
+#define GROW_LOAD 4
+#define MAX_GROW_SIZE (1u << 22)
+
 
 int dbPvdTableSize(int size)
 {
@@ -73,6 +82,7 @@ void dbPvdInitPvt(dbBase *pdbbase)
     ppvd = (dbPvd *)dbMalloc(sizeof(dbPvd));
     ppvd->size    = dbPvdHashTableSize;
     ppvd->mask    = dbPvdHashTableSize - 1;
+    ppvd->count   = 0;
     ppvd->buckets = dbCalloc(ppvd->size, sizeof(dbPvdBucket *));
 
     pdbbase->ppvd = ppvd;
@@ -102,6 +112,44 @@ PVDENTRY *dbPvdFind(dbBase *pdbbase, const char *name, size_t lenName)
     return ppvdNode;
 }
 
+/* Rehash into a table twice the size. Only safe when there can't be
+ * any concurrent lookups, i.e. before iocInit.
+ */
+static void dbPvdGrow(dbPvd *ppvd)
+{
+    unsigned int size = ppvd->size * 2;
+    unsigned int mask = size - 1;
+    dbPvdBucket **buckets = dbCalloc(size, sizeof(dbPvdBucket *));
+    unsigned int h;
+
+    for (h = 0; h < ppvd->size; h++) {
+        dbPvdBucket *pbucket = ppvd->buckets[h];
+        PVDENTRY *ppvdNode;
+
+        if (pbucket == NULL) continue;
+        while ((ppvdNode = (PVDENTRY *) ellFirst(&pbucket->list))) {
+            unsigned int hnew =
+                epicsStrHash(ppvdNode->precnode->recordname, 0) & mask;
+            dbPvdBucket *pnew = buckets[hnew];
+
+            if (pnew == NULL) {
+                pnew = dbCalloc(1, sizeof(dbPvdBucket));
+                ellInit(&pnew->list);
+                pnew->lock = epicsMutexCreate();
+                buckets[hnew] = pnew;
+            }
+            ellDelete(&pbucket->list, (ELLNODE *)ppvdNode);
+            ellAdd(&pnew->list, (ELLNODE *)ppvdNode);
+        }
+        epicsMutexDestroy(pbucket->lock);
+        free(pbucket);
+    }
+    free(ppvd->buckets);
+    ppvd->buckets = buckets;
+    ppvd->size = size;
+    ppvd->mask = mask;
+}
+
 PVDENTRY *dbPvdAdd(dbBase *pdbbase, dbRecordType *precordType,
     dbRecordNode *precnode)
 {
@@ -134,6 +182,10 @@ PVDENTRY *dbPvdAdd(dbBase *pdbbase, dbRecordType *precordType,
     ppvdNode->precnode = precnode;
     ellAdd(&pbucket->list, (ELLNODE *)ppvdNode);
     epicsMutexUnlock(pbucket->lock);
+
+    if (++ppvd->count > GROW_LOAD * ppvd->size &&
+        ppvd->size < MAX_GROW_SIZE && getIocState() == iocVoid)
+        dbPvdGrow(ppvd);
     return ppvdNode;
 }
 
@@ -155,6 +207,7 @@ void dbPvdDelete(dbBase *pdbbase, dbRecordNode *precnode)
             strcmp(name, ppvdNode->precnode->recordname) == 0) {
             ellDelete(&pbucket->list, (ELLNODE *)ppvdNode);
             free(ppvdNode);
+            ppvd->count--;
             break;
         }
         ppvdNode = (PVDENTRY *) ellNext((ELLNODE *)ppvdNode);
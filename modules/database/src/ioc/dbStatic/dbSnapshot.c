@@ -0,0 +1,776 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Binary database snapshots.
+ *
+ * A snapshot holds all the record instances, aliases and info items of a
+ * loaded database, so they can be re-created at the next boot without
+ * lexing, parsing and macro-expanding the original .db files. Numeric,
+ * menu and string field values are stored in their binary form and are
+ * copied straight into the new records; link and DTYP fields are stored
+ * as strings and set through dbPutString().
+ *
+ * Binary values are only meaningful to an IOC with exactly the same
+ * record type, field and menu definitions, and the same architecture.
+ * The header carries a checksum of those definitions, and a snapshot
+ * that doesn't match the running IOC is rejected without creating any
+ * records.  The whole image is also checked for truncation, bad indices
+ * and sizes and record name clashes before the first record is created.
+ *
+ * Only the record instances are saved: record types, menus, device, driver
+ * and link support must still be loaded from the .dbd files before the
+ * snapshot is read.  Snapshots can only be written before iocInit, while
+ * the fields still hold the values loaded from the database files.
+ *
+ * File layout (native byte order):
+ *   header:  magic[8], version, byte order mark, pointer size,
+ *            definitions checksum (8 bytes), number of entries
+ *   entries: in original record creation order, each either
+ *     'R' recordtype index (2), visible flag (1), name,
+ *         nfields (2) { field index (2), encoding (1), value },
+ *         ninfo (2) { name, string }
+ *     'A' alias name, record name
+ * Strings and values are stored as a 4 byte length followed by the data.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dbDefs.h"
+#include "ellLib.h"
+#include "epicsStdio.h"
+#include "epicsString.h"
+#include "epicsTypes.h"
+#include "errlog.h"
+#include "gpHash.h"
+
+#include "dbBase.h"
+#include "dbStaticLib.h"
+#include "dbStaticPvt.h"
+#include "iocInit.h"
+
+static const char snapMagic[8] = {'E','P','I','C','S','D','B','S'};
+
+#define SNAP_VERSION 1
+#define SNAP_BOM 0x01020304
+
+#define ENC_BINARY 0
+#define ENC_STRING 1
+
+typedef struct snapHeader {
+    char        magic[8];
+    epicsUInt32 version;
+    epicsUInt32 bom;
+    epicsUInt32 ptrSize;
+    epicsUInt32 nentries;
+    epicsUInt64 checksum;
+} snapHeader;
+
+/* FNV-1a hash, used for the definitions checksum */
+
+#define FNV_OFFSET 14695981039346656037ull
+#define FNV_PRIME 1099511628211ull
+
+static epicsUInt64 hashBytes(epicsUInt64 h, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+
+    while (len--) {
+        h ^= *p++;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static epicsUInt64 hashString(epicsUInt64 h, const char *str)
+{
+    return hashBytes(h, str ? str : "", str ? strlen(str) + 1 : 1);
+}
+
+static epicsUInt64 hashInt(epicsUInt64 h, int val)
+{
+    epicsInt32 v = val;
+
+    return hashBytes(h, &v, sizeof(v));
+}
+
+/* Everything that binary field values in a snapshot depend on */
+static epicsUInt64 definitionsChecksum(DBBASE *pdbbase)
+{
+    epicsUInt64 h = FNV_OFFSET;
+    dbRecordType *prt;
+
+    for (prt = (dbRecordType *)ellFirst(&pdbbase->recordTypeList); prt;
+         prt = (dbRecordType *)ellNext(&prt->node)) {
+        int i;
+
+        h = hashString(h, prt->name);
+        h = hashInt(h, prt->no_fields);
+        h = hashInt(h, prt->rec_size);
+
+        for (i = 0; i < prt->no_fields; i++) {
+            dbFldDes *pflddes = prt->papFldDes[i];
+
+            h = hashString(h, pflddes->name);
+            h = hashInt(h, pflddes->field_type);
+            h = hashInt(h, pflddes->size);
+            h = hashInt(h, pflddes->offset);
+
+            if (pflddes->field_type == DBF_MENU && pflddes->ftPvt) {
+                dbMenu *pmenu = pflddes->ftPvt;
+                int j;
+
+                h = hashString(h, pmenu->name);
+                h = hashInt(h, pmenu->nChoice);
+                for (j = 0; j < pmenu->nChoice; j++)
+                    h = hashString(h, pmenu->papChoiceValue[j]);
+            }
+        }
+    }
+    return h;
+}
+
+/* Writing */
+
+static int putBytes(FILE *fp, const void *data, size_t len)
+{
+    return len && fwrite(data, len, 1, fp) != 1;
+}
+
+static int putU8(FILE *fp, unsigned val)
+{
+    epicsUInt8 v = val;
+
+    return putBytes(fp, &v, sizeof(v));
+}
+
+static int putU16(FILE *fp, unsigned val)
+{
+    epicsUInt16 v = val;
+
+    return putBytes(fp, &v, sizeof(v));
+}
+
+static int putData(FILE *fp, const void *data, size_t len)
+{
+    epicsUInt32 v = (epicsUInt32) len;
+
+    return putBytes(fp, &v, sizeof(v)) || putBytes(fp, data, len);
+}
+
+static int putString(FILE *fp, const char *str)
+{
+    return putData(fp, str, strlen(str));
+}
+
+typedef struct snapNode {
+    dbRecordNode    *precnode;
+    dbRecordType    *precordType;
+    unsigned        typeIndex;
+} snapNode;
+
+static int cmpOrder(const void *a, const void *b)
+{
+    const dbRecordNode *A = ((const snapNode *)a)->precnode;
+    const dbRecordNode *B = ((const snapNode *)b)->precnode;
+
+    return A->order < B->order ? -1 : A->order > B->order;
+}
+
+static int isBinaryField(const dbFldDes *pflddes)
+{
+    switch (pflddes->field_type) {
+    case DBF_STRING:
+    case DBF_CHAR:
+    case DBF_UCHAR:
+    case DBF_SHORT:
+    case DBF_USHORT:
+    case DBF_LONG:
+    case DBF_ULONG:
+    case DBF_INT64:
+    case DBF_UINT64:
+    case DBF_FLOAT:
+    case DBF_DOUBLE:
+    case DBF_ENUM:
+    case DBF_MENU:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* dbIsDefaultValue() ignores link text that hasn't been parsed yet */
+static int isDefault(DBENTRY *pdbentry)
+{
+    switch (pdbentry->pflddes->field_type) {
+    case DBF_DEVICE:
+        return *(epicsEnum16 *)pdbentry->pfield == 0;
+    case DBF_INLINK:
+    case DBF_OUTLINK:
+    case DBF_FWDLINK: {
+            DBLINK *plink = (DBLINK *)pdbentry->pfield;
+
+            return plink->type == CONSTANT && !plink->value.constantStr &&
+                !plink->text;
+        }
+    default:
+        return dbIsDefaultValue(pdbentry);
+    }
+}
+
+static int writeRecord(FILE *fp, DBENTRY *pdbentry, unsigned typeIndex)
+{
+    dbRecordType *prt = pdbentry->precordType;
+    unsigned nfields = 0;
+    unsigned ninfo = 0;
+    long pos, status;
+    int i, err;
+
+    err = putU8(fp, 'R') ||
+          putU16(fp, typeIndex) ||
+          putU8(fp, dbIsVisibleRecord(pdbentry)) ||
+          putString(fp, dbGetRecordName(pdbentry));
+
+    /* count the non-default fields first */
+    for (i = 1; i < prt->no_fields; i++) {
+        pdbentry->pflddes = prt->papFldDes[i];
+        pdbentry->indfield = i;
+        if (pdbentry->pflddes->field_type == DBF_NOACCESS ||
+            dbGetFieldAddress(pdbentry) || isDefault(pdbentry))
+            continue;
+        nfields++;
+    }
+    err = err || putU16(fp, nfields);
+
+    for (i = 1; !err && i < prt->no_fields; i++) {
+        dbFldDes *pflddes = prt->papFldDes[i];
+
+        pdbentry->pflddes = pflddes;
+        pdbentry->indfield = i;
+        if (pflddes->field_type == DBF_NOACCESS ||
+            dbGetFieldAddress(pdbentry) || isDefault(pdbentry))
+            continue;
+
+        err = putU16(fp, i);
+        if (pflddes->field_type == DBF_STRING) {
+            err = err || putU8(fp, ENC_BINARY) ||
+                  putString(fp, (const char *)pdbentry->pfield);
+        }
+        else if (isBinaryField(pflddes)) {
+            err = err || putU8(fp, ENC_BINARY) ||
+                  putData(fp, pdbentry->pfield, pflddes->size);
+        }
+        else {
+            const char *pstr = dbGetString(pdbentry);
+
+            err = err || putU8(fp, ENC_STRING) ||
+                  putString(fp, pstr ? pstr : "");
+        }
+    }
+
+    pos = ftell(fp);
+    err = err || putU16(fp, 0);
+    for (status = dbFirstInfo(pdbentry); !err && !status;
+         status = dbNextInfo(pdbentry)) {
+        err = putString(fp, dbGetInfoName(pdbentry)) ||
+              putString(fp, dbGetInfoString(pdbentry));
+        ninfo++;
+    }
+    if (!err && ninfo) {
+        /* go back and fill in the real count */
+        err = fseek(fp, pos, SEEK_SET) || putU16(fp, ninfo) ||
+              fseek(fp, 0, SEEK_END);
+    }
+    return err;
+}
+
+long dbWriteSnapshot(DBBASE *pdbbase, const char *filename)
+{
+    DBENTRY dbentry;
+    dbRecordType *prt;
+    snapNode *nodes;
+    snapHeader header;
+    size_t nnodes = 0, i;
+    unsigned itype;
+    FILE *fp;
+    int err = 0;
+
+    if (!pdbbase || !filename) {
+        fprintf(stderr, "dbWriteSnapshot: No database or file name\n");
+        return -1;
+    }
+    if (getIocState() != iocVoid) {
+        fprintf(stderr, "dbWriteSnapshot: Must be called before iocInit\n");
+        return -1;
+    }
+
+    for (prt = (dbRecordType *)ellFirst(&pdbbase->recordTypeList); prt;
+         prt = (dbRecordType *)ellNext(&prt->node))
+        nnodes += ellCount(&prt->recList);
+
+    /* Gather all records and aliases to write them in creation order */
+    nodes = dbCalloc(nnodes + 1, sizeof(snapNode));
+    for (nnodes = 0, itype = 0,
+         prt = (dbRecordType *)ellFirst(&pdbbase->recordTypeList); prt;
+         prt = (dbRecordType *)ellNext(&prt->node), itype++) {
+        dbRecordNode *precnode;
+
+        for (precnode = (dbRecordNode *)ellFirst(&prt->recList); precnode;
+             precnode = (dbRecordNode *)ellNext(&precnode->node)) {
+            nodes[nnodes].precnode = precnode;
+            nodes[nnodes].precordType = prt;
+            nodes[nnodes].typeIndex = itype;
+            nnodes++;
+        }
+    }
+    qsort(nodes, nnodes, sizeof(snapNode), cmpOrder);
+
+    fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "dbWriteSnapshot: Can't create '%s'\n", filename);
+        free(nodes);
+        return -1;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, snapMagic, sizeof(header.magic));
+    header.version = SNAP_VERSION;
+    header.bom = SNAP_BOM;
+    header.ptrSize = sizeof(void *);
+    header.nentries = (epicsUInt32) nnodes;
+    header.checksum = definitionsChecksum(pdbbase);
+    err = putBytes(fp, &header, sizeof(header));
+
+    dbInitEntry(pdbbase, &dbentry);
+    for (i = 0; !err && i < nnodes; i++) {
+        dbRecordNode *precnode = nodes[i].precnode;
+
+        if (precnode->flags & DBRN_FLAGS_ISALIAS) {
+            err = putU8(fp, 'A') ||
+                  putString(fp, precnode->recordname) ||
+                  putString(fp, precnode->aliasedRecnode->recordname);
+            continue;
+        }
+        dbentry.precordType = nodes[i].precordType;
+        dbentry.precnode = precnode;
+        err = writeRecord(fp, &dbentry, nodes[i].typeIndex);
+    }
+    dbFinishEntry(&dbentry);
+
+    if (fclose(fp))
+        err = 1;
+    free(nodes);
+
+    if (err) {
+        fprintf(stderr, "dbWriteSnapshot: Error writing '%s'\n", filename);
+        remove(filename);
+        return -1;
+    }
+    return 0;
+}
+
+/* Reading */
+
+typedef struct snapReader {
+    const char  *pos;
+    const char  *end;
+    int         bad;
+} snapReader;
+
+static const void *getBytes(snapReader *prd, size_t len)
+{
+    const char *p = prd->pos;
+
+    if (prd->bad || (size_t)(prd->end - p) < len) {
+        prd->bad = 1;
+        return NULL;
+    }
+    prd->pos += len;
+    return p;
+}
+
+static unsigned getU8(snapReader *prd)
+{
+    const epicsUInt8 *p = getBytes(prd, sizeof(epicsUInt8));
+
+    return p ? *p : 0;
+}
+
+static unsigned getU16(snapReader *prd)
+{
+    const void *p = getBytes(prd, sizeof(epicsUInt16));
+    epicsUInt16 v = 0;
+
+    if (p)
+        memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static const char *getData(snapReader *prd, size_t *plen)
+{
+    const void *p = getBytes(prd, sizeof(epicsUInt32));
+    epicsUInt32 len = 0;
+
+    if (p)
+        memcpy(&len, p, sizeof(len));
+    *plen = len;
+    return getBytes(prd, len);
+}
+
+/* Strings are stored unterminated, copy into a buffer */
+static const char *getString(snapReader *prd, char **pbuf, size_t *pbufSize)
+{
+    size_t len;
+    const char *p = getData(prd, &len);
+
+    if (!p)
+        return NULL;
+    if (len + 1 > *pbufSize) {
+        free(*pbuf);
+        *pbufSize = len + 64;
+        *pbuf = dbMalloc(*pbufSize);
+    }
+    memcpy(*pbuf, p, len);
+    (*pbuf)[len] = '\0';
+    return *pbuf;
+}
+
+/* Checking pass, which creates no records.
+ * names holds each record (userPvt its type) and alias (userPvt NULL)
+ * found earlier in the image.
+ */
+
+static long checkRecord(snapReader *prd, DBENTRY *pdbentry,
+    dbRecordType **types, unsigned ntypes, struct gphPvt *names,
+    char **pbuf, size_t *pbufSize)
+{
+    unsigned itype = getU16(prd);
+    unsigned nfields, ninfo;
+    const char *name;
+    dbRecordType *prt;
+    GPHENTRY *pgph;
+    size_t len;
+
+    getU8(prd);
+    name = getString(prd, pbuf, pbufSize);
+    if (!name || !*name || itype >= ntypes)
+        return S_dbLib_badSnapshot;
+
+    prt = types[itype];
+    if (strlen(name) >= (size_t) prt->papFldDes[0]->size)
+        return S_dbLib_badSnapshot;
+
+    pgph = gphFind(names, name, names);
+    if (pgph ? pgph->userPvt != prt :
+        !dbFindRecord(pdbentry, name) && pdbentry->precordType != prt) {
+        fprintf(stderr, "dbReadSnapshot: Record \"%s\" already exists "
+                "with a different type\n", name);
+        return S_dbLib_badSnapshot;
+    }
+    if (!pgph) {
+        pgph = gphAdd(names, name, names);
+        pgph->userPvt = prt;
+    }
+
+    for (nfields = getU16(prd); !prd->bad && nfields; nfields--) {
+        unsigned ifield = getU16(prd);
+        unsigned enc = getU8(prd);
+        dbFldDes *pflddes;
+
+        if (prd->bad || ifield == 0 || ifield >= (unsigned) prt->no_fields)
+            return S_dbLib_badSnapshot;
+
+        pflddes = prt->papFldDes[ifield];
+        if (!getData(prd, &len))
+            return S_dbLib_badSnapshot;
+        if (enc == ENC_BINARY && pflddes->field_type == DBF_STRING) {
+            if (len >= (size_t) pflddes->size)
+                return S_dbLib_badSnapshot;
+        }
+        else if (enc == ENC_BINARY && isBinaryField(pflddes)) {
+            if (len != (size_t) pflddes->size)
+                return S_dbLib_badSnapshot;
+        }
+        else if (enc != ENC_STRING) {
+            return S_dbLib_badSnapshot;
+        }
+    }
+
+    for (ninfo = getU16(prd); !prd->bad && ninfo; ninfo--) {
+        if (!getData(prd, &len) || !getData(prd, &len))
+            return S_dbLib_badSnapshot;
+    }
+    return prd->bad ? S_dbLib_badSnapshot : 0;
+}
+
+static long checkAlias(snapReader *prd, DBENTRY *pdbentry,
+    struct gphPvt *names, char **pbuf, size_t *pbufSize)
+{
+    GPHENTRY *pgph;
+    char *alias;
+    long status = 0;
+
+    if (!getString(prd, pbuf, pbufSize) || !**pbuf)
+        return S_dbLib_badSnapshot;
+    alias = epicsStrDup(*pbuf);
+    if (!getString(prd, pbuf, pbufSize)) {
+        free(alias);
+        return S_dbLib_badSnapshot;
+    }
+
+    if (!gphFind(names, *pbuf, names) && dbFindRecord(pdbentry, *pbuf)) {
+        fprintf(stderr, "dbReadSnapshot: Alias \"%s\" for unknown record "
+                "\"%s\"\n", alias, *pbuf);
+        status = S_dbLib_badSnapshot;
+    }
+    else if ((pgph = gphFind(names, alias, names)) ? pgph->userPvt != NULL :
+             !dbFindRecord(pdbentry, alias) && !dbIsAlias(pdbentry)) {
+        fprintf(stderr, "dbReadSnapshot: Alias \"%s\" is already a "
+                "record name\n", alias);
+        status = S_dbLib_badSnapshot;
+    }
+    else if (!pgph) {
+        pgph = gphAdd(names, alias, names);
+        pgph->userPvt = NULL;
+    }
+    free(alias);
+    return status;
+}
+
+/* Creating pass */
+
+static long readRecord(snapReader *prd, DBENTRY *pdbentry,
+    dbRecordType **types, unsigned ntypes, char **pbuf, size_t *pbufSize)
+{
+    unsigned itype = getU16(prd);
+    unsigned visible = getU8(prd);
+    const char *name = getString(prd, pbuf, pbufSize);
+    dbRecordType *prt;
+    unsigned nfields, ninfo;
+    long status;
+
+    if (!name || itype >= ntypes)
+        return S_dbLib_badSnapshot;
+
+    prt = types[itype];
+    pdbentry->precordType = prt;
+    status = dbCreateRecord(pdbentry, name);
+    if (status == S_dbLib_recExists &&
+        pdbentry->precordType == prt)
+        status = 0;     /* same type, update it like dbLoadRecords does */
+    if (status) {
+        fprintf(stderr, "dbReadSnapshot: Can't create record \"%s\"\n", name);
+        return status;
+    }
+    if (visible)
+        dbVisibleRecord(pdbentry);
+
+    for (nfields = getU16(prd); !prd->bad && nfields; nfields--) {
+        unsigned ifield = getU16(prd);
+        unsigned enc = getU8(prd);
+        dbFldDes *pflddes;
+
+        if (prd->bad || ifield == 0 || ifield >= (unsigned) prt->no_fields)
+            return S_dbLib_badSnapshot;
+
+        pflddes = prt->papFldDes[ifield];
+        pdbentry->pflddes = pflddes;
+        pdbentry->indfield = ifield;
+        if (dbGetFieldAddress(pdbentry) || !pdbentry->pfield)
+            return S_dbLib_badSnapshot;
+
+        if (enc == ENC_BINARY && pflddes->field_type == DBF_STRING) {
+            size_t len;
+            const char *p = getData(prd, &len);
+
+            if (!p || len >= (size_t) pflddes->size)
+                return S_dbLib_badSnapshot;
+            memcpy(pdbentry->pfield, p, len);
+            ((char *)pdbentry->pfield)[len] = '\0';
+        }
+        else if (enc == ENC_BINARY && isBinaryField(pflddes)) {
+            size_t len;
+            const char *p = getData(prd, &len);
+
+            if (!p || len != (size_t) pflddes->size)
+                return S_dbLib_badSnapshot;
+            memcpy(pdbentry->pfield, p, len);
+        }
+        else if (enc == ENC_STRING) {
+            const char *value = getString(prd, pbuf, pbufSize);
+
+            if (!value)
+                return S_dbLib_badSnapshot;
+            status = dbPutString(pdbentry, value);
+            if (status) {
+                fprintf(stderr, "dbReadSnapshot: Can't set \"%s.%s\" to \"%s\"\n",
+                        dbGetRecordName(pdbentry), pflddes->name, value);
+                return status;
+            }
+        }
+        else {
+            return S_dbLib_badSnapshot;
+        }
+    }
+
+    for (ninfo = getU16(prd); !prd->bad && ninfo; ninfo--) {
+        char *iname;
+
+        if (!getString(prd, pbuf, pbufSize))
+            return S_dbLib_badSnapshot;
+        iname = epicsStrDup(*pbuf);
+        status = getString(prd, pbuf, pbufSize) ?
+            dbPutInfo(pdbentry, iname, *pbuf) : S_dbLib_badSnapshot;
+        free(iname);
+        if (status)
+            return status;
+    }
+    return prd->bad ? S_dbLib_badSnapshot : 0;
+}
+
+static long readAlias(snapReader *prd, DBENTRY *pdbentry,
+    char **pbuf, size_t *pbufSize)
+{
+    char *alias;
+    long status;
+
+    if (!getString(prd, pbuf, pbufSize))
+        return S_dbLib_badSnapshot;
+    alias = epicsStrDup(*pbuf);
+    if (!getString(prd, pbuf, pbufSize)) {
+        free(alias);
+        return S_dbLib_badSnapshot;
+    }
+    status = dbFindRecord(pdbentry, *pbuf);
+    if (!status)
+        status = dbCreateAlias(pdbentry, alias);
+    if (status == S_dbLib_recExists && !dbFindRecord(pdbentry, alias) &&
+        dbIsAlias(pdbentry))
+        status = 0;     /* already defined */
+    if (status)
+        fprintf(stderr, "dbReadSnapshot: Can't create alias \"%s\" for \"%s\"\n",
+                alias, *pbuf);
+    free(alias);
+    return status;
+}
+
+long dbReadSnapshot(DBBASE *pdbbase, const char *filename)
+{
+    DBENTRY dbentry;
+    snapHeader header;
+    snapReader rd;
+    dbRecordType **types = NULL;
+    dbRecordType *prt;
+    struct gphPvt *names;
+    unsigned ntypes, i;
+    int checked;
+    char *image = NULL, *buf = NULL;
+    size_t bufSize = 0;
+    long size, status = 0;
+    FILE *fp;
+
+    if (!pdbbase || !filename) {
+        fprintf(stderr, "dbReadSnapshot: No database or file name\n");
+        return -1;
+    }
+    if (getIocState() != iocVoid)
+        return -2;
+
+    fp = fopen(filename, "rb");
+    if (!fp)
+        return S_dbLib_badSnapshot;
+
+    /* Read the whole image in one go */
+    if (fseek(fp, 0, SEEK_END) || (size = ftell(fp)) < (long) sizeof(header) ||
+        fseek(fp, 0, SEEK_SET)) {
+        fclose(fp);
+        return S_dbLib_badSnapshot;
+    }
+    image = dbMalloc(size);
+    if (fread(image, size, 1, fp) != 1) {
+        fclose(fp);
+        free(image);
+        return S_dbLib_badSnapshot;
+    }
+    fclose(fp);
+
+    memcpy(&header, image, sizeof(header));
+    if (memcmp(header.magic, snapMagic, sizeof(snapMagic)) ||
+        header.version != SNAP_VERSION || header.bom != SNAP_BOM ||
+        header.ptrSize != sizeof(void *) ||
+        header.checksum != definitionsChecksum(pdbbase)) {
+        free(image);
+        return S_dbLib_badSnapshot;
+    }
+
+    ntypes = ellCount(&pdbbase->recordTypeList);
+    types = dbCalloc(ntypes + 1, sizeof(dbRecordType *));
+    for (i = 0, prt = (dbRecordType *)ellFirst(&pdbbase->recordTypeList); prt;
+         prt = (dbRecordType *)ellNext(&prt->node))
+        types[i++] = prt;
+
+    dbInitEntry(pdbbase, &dbentry);
+
+    /* Check the whole image before creating anything */
+    rd.pos = image + sizeof(header);
+    rd.end = image + size;
+    rd.bad = 0;
+    gphInitPvt(&names, 65536);
+    for (i = 0; !status && i < header.nentries; i++) {
+        switch (getU8(&rd)) {
+        case 'R':
+            status = checkRecord(&rd, &dbentry, types, ntypes, names,
+                                 &buf, &bufSize);
+            break;
+        case 'A':
+            status = checkAlias(&rd, &dbentry, names, &buf, &bufSize);
+            break;
+        default:
+            status = S_dbLib_badSnapshot;
+        }
+    }
+    if (!status && rd.pos != rd.end)
+        status = S_dbLib_badSnapshot;  /* trailing data */
+    gphFreeMem(names);
+    checked = !status;
+
+    rd.pos = image + sizeof(header);
+    rd.bad = 0;
+    for (i = 0; !status && i < header.nentries; i++) {
+        switch (getU8(&rd)) {
+        case 'R':
+            status = readRecord(&rd, &dbentry, types, ntypes, &buf, &bufSize);
+            break;
+        case 'A':
+            status = readAlias(&rd, &dbentry, &buf, &bufSize);
+            break;
+        default:
+            status = S_dbLib_badSnapshot;
+        }
+    }
+    if (status && !checked) {
+        fprintf(stderr, "dbReadSnapshot: '%s' is corrupt or conflicts with "
+                "existing records, none created\n", filename);
+    }
+    else if (status) {
+        /* Records created so far remain, S_dbLib_badSnapshot would
+         * tell the caller that nothing was created.
+         */
+        fprintf(stderr, "dbReadSnapshot: '%s' only partly loaded\n",
+                filename);
+        if (status == S_dbLib_badSnapshot)
+            status = -1;
+    }
+    dbFinishEntry(&dbentry);
+
+    free(buf);
+    free(types);
+    free(image);
+    return status;
+}
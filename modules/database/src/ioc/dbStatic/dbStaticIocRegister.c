@@ -260,6 +260,26 @@ static void dbCreateAliasCallFunc(const iocshArgBuf *args)
     }
 }
 
+/* dbWriteSnapshot */
+static const iocshArg dbWriteSnapshotArg1 = { "file name",iocshArgStringPath};
+static const iocshArg * const dbWriteSnapshotArgs[] =
+    {&argPdbbase, &dbWriteSnapshotArg1};
+static const iocshFuncDef dbWriteSnapshotFuncDef = {
+    "dbWriteSnapshot",
+    2,
+    dbWriteSnapshotArgs,
+    "Save all loaded records in a binary snapshot for dbLoadSnapshot.\n"
+    "Must be run before iocInit. The .dbd files are not included and must\n"
+    "still be loaded before the snapshot. The snapshot must be rewritten\n"
+    "whenever the .db or .dbd files change.\n"
+    "\n"
+    "Example: dbWriteSnapshot pdbbase db/ioc.snap\n",
+};
+static void dbWriteSnapshotCallFunc(const iocshArgBuf *args)
+{
+    iocshSetError(dbWriteSnapshot(*iocshPpdbbase,args[1].sval) != 0);
+}
+
 void dbStaticIocRegister(void)
 {
     iocshRegister(&dbDumpPathFuncDef, dbDumpPathCallFunc);
@@ -278,4 +298,5 @@ void dbStaticIocRegister(void)
     iocshRegister(&dbPvdTableSizeFuncDef,dbPvdTableSizeCallFunc);
     iocshRegister(&dbReportDeviceConfigFuncDef, dbReportDeviceConfigCallFunc);
     iocshRegister(&dbCreateAliasFuncDef, dbCreateAliasCallFunc);
+    iocshRegister(&dbWriteSnapshotFuncDef, dbWriteSnapshotCallFunc);
 }
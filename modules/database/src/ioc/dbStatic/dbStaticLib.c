@@ -512,6 +512,7 @@ void dbFreeBase(dbBase *pdbbase)
         free((void *)pdbRecordType->papsortFldName);
         free((void *)pdbRecordType->sortFldInd);
         free((void *)pdbRecordType->papFldDes);
+        dbFreeRecDefaults(pdbRecordType);
         free((void *)pdbRecordType);
         pdbRecordType = pdbRecordTypeNext;
     }
@@ -1446,6 +1447,7 @@ long dbCreateRecord(DBENTRY *pdbentry,const char *precordName)
     ppvd = dbPvdAdd(pdbentry->pdbbase,precordType,pNewRecNode);
     if(!ppvd) {errMessage(-1,"Logic Err: Could not add to PVD");return(-1);}
     pNewRecNode->order = pdbentry->pdbbase->no_records++;
+    pdbentry->pdbbase->nameGeneration++;
     return(0);
 }
 
@@ -1493,6 +1495,7 @@ long dbDeleteRecord(DBENTRY *pdbentry)
     preclist = &precordType->recList;
     ellDelete(preclist, &precnode->node);
     dbPvdDelete(pdbbase, precnode);
+    pdbbase->nameGeneration++;
     while (!dbFirstInfo(pdbentry)) {
         dbDeleteInfo(pdbentry);
     }
@@ -1688,6 +1691,7 @@ long dbCreateAlias(DBENTRY *pdbentry, const char *alias)
 
     ellAdd(&precordType->recList, &pnewnode->node);
     pnewnode->order = pdbentry->pdbbase->no_records++;
+    pdbentry->pdbbase->nameGeneration++;
     precordType->no_aliases++;
 
     return 0;
@@ -79,6 +79,29 @@ DBCORE_API long dbReadDatabase(DBBASE **ppdbbase,
  */
 DBCORE_API long dbReadDatabaseFP(DBBASE **ppdbbase,
     FILE *fp, const char *path, const char *substitutions);
+/** \brief Write all records, aliases and info items to a binary snapshot.
+ *  Record type, menu and device support definitions are not included.
+ *  \param pdbbase The database.
+ *  \param filename Snapshot file to create.
+ *  \return 0 on success, -1 on error or if called after iocInit.
+ */
+DBCORE_API long dbWriteSnapshot(DBBASE *pdbbase, const char *filename);
+/** \brief Create the records in a snapshot written by dbWriteSnapshot().
+ *  \param pdbbase The database, which must already hold the same record
+ *         type, field and menu definitions used to write the snapshot.
+ *  \param filename Snapshot file to read.
+ *  \return 0 on success, -1 if pdbbase or filename is NULL, -2 if called
+ *          after iocInit, S_dbLib_badSnapshot if the file is missing,
+ *          corrupt, doesn't match the loaded definitions or would give an
+ *          existing record name a different type.
+ *          The whole file is checked before any record is created, and
+ *          nothing is created when any of these errors are returned.
+ *          Any other status comes from dbCreateRecord(), dbCreateAlias(),
+ *          dbPutString() or dbPutInfo() failing part way through creating
+ *          records (a link or DTYP value that can't be set, for example),
+ *          in which case the records created before the failure remain.
+ */
+DBCORE_API long dbReadSnapshot(DBBASE *pdbbase, const char *filename);
 DBCORE_API long dbPath(DBBASE *pdbbase, const char *path);
 DBCORE_API long dbAddPath(DBBASE *pdbbase, const char *path);
 DBCORE_API char * dbGetPromptGroupNameFromKey(DBBASE *pdbbase,
@@ -266,6 +289,7 @@ extern int dbConvertStrict;
 #define S_dbLib_noSizeOffset (M_dbLib|23)      /* Missing SizeOffset Routine - No record support? */
 #define S_dbLib_outMem (M_dbLib|27)            /* Out of memory */
 #define S_dbLib_infoNotFound (M_dbLib|29)      /* Info item Not Found */
+#define S_dbLib_badSnapshot (M_dbLib|31)       /* Database snapshot missing or out of date */
 
 #ifdef __cplusplus
 }
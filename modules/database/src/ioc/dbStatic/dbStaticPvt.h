@@ -32,6 +32,8 @@ int dbIsMacroOk(DBENTRY *pdbentry);
 /*The following routines have different versions for run-time no-run-time*/
 long dbAllocRecord(DBENTRY *pdbentry,const char *precordName);
 long dbFreeRecord(DBENTRY *pdbentry);
+void dbFreeRecDefaults(dbRecordType *pdbRecordType);
+void dbInitRecSup(dbRecordType *pdbRecordType, rset *prset);
 
 long dbGetFieldAddress(DBENTRY *pdbentry);
 char *dbRecordName(DBENTRY *pdbentry);
@@ -44,6 +44,79 @@ struct dsxt devSoft_DSXT = {
 };
 
 static devSup *pthisDevSup = NULL;
+static dbRecordType *pthisRecordType = NULL;
+
+/* Numeric field initial values for a record type, converted from their
+ * string form once and copied into each new record by dbAllocRecord().
+ */
+typedef struct dbRecDefaults {
+    int     strict;     /* dbConvertStrict setting used for conversion */
+    char    *image;     /* rec_size bytes, allocated with this struct */
+} dbRecDefaults;
+
+static int isNumericField(const dbFldDes *pflddes)
+{
+    switch (pflddes->field_type) {
+    case DBF_CHAR:
+    case DBF_UCHAR:
+    case DBF_SHORT:
+    case DBF_USHORT:
+    case DBF_LONG:
+    case DBF_ULONG:
+    case DBF_INT64:
+    case DBF_UINT64:
+    case DBF_FLOAT:
+    case DBF_DOUBLE:
+    case DBF_ENUM:
+    case DBF_MENU:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static dbRecDefaults *getRecDefaults(dbRecordType *pdbRecordType)
+{
+    dbRecDefaults *pdefaults = pdbRecordType->pdefaults;
+    DBENTRY dbentry;
+    int i;
+
+    memset(&dbentry, 0, sizeof(dbentry));
+    dbentry.precordType = pdbRecordType;
+
+    if (pdefaults && pdefaults->strict == dbConvertStrict)
+        goto done;
+
+    free(pdefaults);
+    pdefaults = dbCalloc(1, sizeof(dbRecDefaults) + pdbRecordType->rec_size);
+    pdefaults->strict = dbConvertStrict;
+    pdefaults->image = (char *)(pdefaults + 1);
+
+    for (i = 1; i < pdbRecordType->no_fields; i++) {
+        dbFldDes *pflddes = pdbRecordType->papFldDes[i];
+
+        if (!pflddes || !pflddes->initial || !isNumericField(pflddes))
+            continue;
+        dbentry.pflddes = pflddes;
+        dbentry.indfield = i;
+        dbentry.pfield = pdefaults->image + pflddes->offset;
+        if (dbPutStringNum(&dbentry, pflddes->initial))
+            epicsPrintf(ERL_ERROR " initializing %s.%s initial %s\n",
+                        pdbRecordType->name, pflddes->name, pflddes->initial);
+    }
+    pdbRecordType->pdefaults = pdefaults;
+
+done:
+    /* dbPutStringNum() may have left an error message to free */
+    dbFinishEntry(&dbentry);
+    return pdefaults;
+}
+
+void dbFreeRecDefaults(dbRecordType *pdbRecordType)
+{
+    free(pdbRecordType->pdefaults);
+    pdbRecordType->pdefaults = NULL;
+}
 
 void dbInitDevSup(devSup *pdevSup, dset *pdset)
 {
@@ -66,6 +139,32 @@ void devExtend(dsxt *pdsxt)
         pthisDevSup->pdsxt = pdsxt;
     }
 }
+
+void devThreadSafeInit(void)
+{
+    if (!pthisDevSup)
+        errlogPrintf("devThreadSafeInit() called outside of dbInitDevSup()\n");
+    else
+        pthisDevSup->threadSafeInit = TRUE;
+}
+
+void dbInitRecSup(dbRecordType *pdbRecordType, rset *prset)
+{
+    pdbRecordType->prset = prset;
+    if (prset->init) {
+        pthisRecordType = pdbRecordType;
+        prset->init();
+        pthisRecordType = NULL;
+    }
+}
+
+void recThreadSafeInit(void)
+{
+    if (!pthisRecordType)
+        errlogPrintf("recThreadSafeInit() called outside of dbInitRecSup()\n");
+    else
+        pthisRecordType->threadSafeInit = TRUE;
+}
 
 long dbAllocRecord(DBENTRY *pdbentry,const char *precordName)
 {
@@ -75,6 +174,7 @@ long dbAllocRecord(DBENTRY *pdbentry,const char *precordName)
     int             i;
     dbCommonPvt     *ppvt;
     dbCommon        *precord;
+    dbRecDefaults   *pdefaults;
     char            *pfield;
 
     if(!pdbRecordType) return(S_dbLib_recordTypeNotFound);
@@ -107,6 +207,7 @@ long dbAllocRecord(DBENTRY *pdbentry,const char *precordName)
         return(S_dbLib_nameLength);
     }
     strcpy(precord->name, precordName);
+    pdefaults = getRecDefaults(pdbRecordType);
     for(i=1; i<pdbRecordType->no_fields; i++) {
 
         pflddes = pdbRecordType->papFldDes[i];
@@ -138,14 +239,9 @@ long dbAllocRecord(DBENTRY *pdbentry,const char *precordName)
         case DBF_DOUBLE:
         case DBF_ENUM:
         case DBF_MENU:
-            if(pflddes->initial) {
-                long status;
-
-                status = dbPutStringNum(pdbentry,pflddes->initial);
-                if(status)
-                    epicsPrintf(ERL_ERROR " initializing %s.%s initial %s\n",
-                                pdbRecordType->name,pflddes->name,pflddes->initial);
-            }
+            if(pflddes->initial)
+                memcpy(pfield, pdefaults->image + pflddes->offset,
+                       pflddes->size);
             break;
         case DBF_DEVICE:
             if(!pflddes->ftPvt) dbGetDeviceMenu(pdbentry);
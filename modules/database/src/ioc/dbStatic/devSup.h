@@ -163,6 +163,14 @@ DBCORE_API struct link* dbGetDevLink(struct dbCommon* prec);
 DBCORE_API extern dsxt devSoft_DSXT;  /* Allow anything table */
 
 DBCORE_API void devExtend(dsxt *pdsxt);
+/** Declare that this device support's init_record() may be called for
+ * different records at the same time from several threads.
+ *
+ * Only effective when called from dset::init() with @a after = 0.
+ * The record type must also be declared with recThreadSafeInit()
+ * for iocInit to spread its records over the dbInitRecordThreads pool.
+ */
+DBCORE_API void devThreadSafeInit(void);
 DBCORE_API void dbInitDevSup(struct devSup *pdevSup, dset *pdset);
 
 
@@ -87,6 +87,7 @@ struct pv_link {
     LINKCVT     getCvt;         /* input conversion function */
     short       pvlMask;        /* Options mask */
     short       lastGetdbrType; /* last dbrType for DB or CA get */
+    void        *pfield;        /* DB link scalar source, or NULL */
 };
 
 struct jlink;
@@ -18,6 +18,7 @@
 
 #include "errMdef.h"
 #include "compilerDependencies.h"
+#include "dbCoreAPI.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -92,6 +93,12 @@ typedef struct rset rset EPICS_DEPRECATED;
 
 #define RSETNUMBER 17
 
+/* Declare that init_record() may be called for different records at the
+ * same time from several threads. Only effective when called from the
+ * rset init() routine.
+ */
+DBCORE_API void recThreadSafeInit(void);
+
 #define S_rec_noRSET     (M_recSup| 1) /*Missing record support entry table*/
 #define S_rec_noSizeOffset (M_recSup| 2) /*Missing SizeOffset Routine*/
 #define S_rec_outMem     (M_recSup| 3) /*Out of Memory*/
@@ -31,6 +31,8 @@
 #include "epicsPrint.h"
 #include "epicsSignal.h"
 #include "epicsThread.h"
+#include "epicsThreadPool.h"
+#include "epicsTime.h"
 #include "errMdef.h"
 #include "iocsh.h"
 #include "taskwd.h"
@@ -53,6 +55,7 @@
 #include "dbLock.h"
 #include "dbNotify.h"
 #include "dbScan.h"
+#include "dbSeqlockPvt.h"
 #include "dbServer.h"
 #include "dbStaticLib.h"
 #include "dbStaticPvt.h"
@@ -98,6 +101,14 @@ static void iterateRecords(recIterFunc func, void *user);
 int dbThreadRealtimeLock = 1;
 epicsExportAddress(int, dbThreadRealtimeLock);
 
+/* Worker threads for init_record(), 0 = serial, <0 = one per CPU */
+int dbInitRecordThreads = 0;
+epicsExportAddress(int, dbInitRecordThreads);
+
+/* Report record initialization times per phase and record type */
+int dbInitRecordTiming = 0;
+epicsExportAddress(int, dbInitRecordTiming);
+
 enum iocStateEnum getIocState(void)
 {
     return iocState;
@@ -418,10 +429,7 @@ static void initRecSup(void)
             continue;
         }
         prset = precordTypeLocation->prset;
-        pdbRecordType->prset = prset;
-        if (prset->init) {
-            prset->init();
-        }
+        dbInitRecSup(pdbRecordType, prset);  /* Calls prset->init() */
     }
 }
 
@@ -555,19 +563,265 @@ static void doInitRecord1(dbRecordType *pdbRecordType, dbCommon *precord,
 
     if (prset->init_record)
         prset->init_record(precord, 1);
+
+    dbSeqlockInitRecord(precord);
+}
+
+/*
+ * Record initialization, with init_record() optionally spread over a
+ * pool of worker threads. Records whose record and device support have
+ * both declared themselves thread-safe are handed to the workers in
+ * batches; everything else is initialized afterwards in this thread,
+ * in the usual order. Link resolution is always serial.
+ */
+
+enum initPhase {
+    initPhaseRecord0, initPhaseLinks, initPhaseRecord1, initPhases
+};
+
+static const char * const initPhaseNames[initPhases] = {
+    "init_record(0)", "resolve links", "init_record(1)"
+};
+
+typedef struct initType {
+    dbRecordType *rtyp;
+    unsigned long nrec;
+    epicsUInt64 ns[initPhases];
+} initType;
+
+typedef struct initRec {
+    initType *ptype;
+    dbCommon *prec;
+    int threadSafe;
+} initRec;
+
+typedef struct initBatch {
+    initRec *precs;
+    size_t count;
+    epicsJob *job;
+} initBatch;
+
+#define INIT_BATCH_SIZE 64
+
+/* Current phase, for the workers */
+static enum initPhase initPhaseNow;
+static recIterFunc initFuncNow;
+static epicsMutexId initTimeLock;
+
+static void countRecords(dbRecordType *rtyp, dbCommon *prec, void *user)
+{
+    (*(size_t *)user)++;
+}
+
+static void initBatchJob(void *arg, epicsJobMode mode)
+{
+    initBatch *pbatch = arg;
+    initType *ptype = pbatch->precs[0].ptype;
+    epicsUInt64 start = epicsMonotonicGet();
+    size_t i;
+
+    if (mode != epicsJobModeRun)
+        return;
+
+    for (i = 0; i < pbatch->count; i++)
+        initFuncNow(ptype->rtyp, pbatch->precs[i].prec, NULL);
+
+    epicsMutexMustLock(initTimeLock);
+    ptype->ns[initPhaseNow] += epicsMonotonicGet() - start;
+    epicsMutexUnlock(initTimeLock);
+}
+
+/* Length of the batch of thread-safe records starting at precs[i] */
+static size_t batchLength(const initRec *precs, size_t nrec, size_t i)
+{
+    size_t n = 0;
+
+    while (i + n < nrec && n < INIT_BATCH_SIZE &&
+           precs[i + n].threadSafe && precs[i + n].ptype == precs[i].ptype)
+        n++;
+    return n;
+}
+
+static initBatch * makeBatches(initRec *precs, size_t nrec,
+    epicsThreadPool *pool, size_t *pnbatch)
+{
+    initBatch *batches;
+    size_t i, n, nbatch = 0;
+
+    for (i = 0; i < nrec; i += n ? n : 1) {
+        n = batchLength(precs, nrec, i);
+        if (n)
+            nbatch++;
+    }
+
+    batches = callocMustSucceed(nbatch + 1, sizeof(initBatch), "makeBatches");
+    for (nbatch = 0, i = 0; i < nrec; i += n ? n : 1) {
+        n = batchLength(precs, nrec, i);
+        if (n) {
+            initBatch *pbatch = &batches[nbatch++];
+
+            pbatch->precs = &precs[i];
+            pbatch->count = n;
+            pbatch->job = epicsJobCreate(pool, initBatchJob, pbatch);
+        }
+    }
+    *pnbatch = nbatch;
+    return batches;
+}
+
+static void initPhase(enum initPhase phase, recIterFunc func,
+    initRec *precs, size_t nrec, epicsThreadPool *pool,
+    initBatch *batches, size_t nbatch)
+{
+    size_t i;
+
+    if (pool) {
+        initPhaseNow = phase;
+        initFuncNow = func;
+        for (i = 0; i < nbatch; i++) {
+            epicsJob *job = batches[i].job;
+
+            if (!job || epicsJobQueue(job))
+                initBatchJob(&batches[i], epicsJobModeRun);
+        }
+        epicsThreadPoolWait(pool, -1.0);
+    }
+
+    /* Everything else, in this thread */
+    for (i = 0; i < nrec; ) {
+        initType *ptype = precs[i].ptype;
+        epicsUInt64 start = epicsMonotonicGet();
+
+        for (; i < nrec && precs[i].ptype == ptype; i++) {
+            if (!pool || !precs[i].threadSafe)
+                func(ptype->rtyp, precs[i].prec, NULL);
+        }
+        ptype->ns[phase] += epicsMonotonicGet() - start;
+    }
+}
+
+static void initTimingReport(initType *ptypes, size_t ntypes,
+    const epicsUInt64 *phaseNs, unsigned nthreads)
+{
+    size_t i;
+    int j;
+
+    printf("iocInit: Record initialization times (%u worker thread%s)\n",
+        nthreads, nthreads == 1 ? "" : "s");
+    for (j = 0; j < initPhases; j++)
+        printf("  %-16s %10.3f sec\n", initPhaseNames[j], phaseNs[j] * 1e-9);
+
+    printf("  %-16s %10s %10s %10s %10s\n", "Record type", "records",
+        "pass 0", "links", "pass 1");
+    for (i = 0; i < ntypes; i++) {
+        initType *ptype = &ptypes[i];
+
+        if (!ptype->nrec)
+            continue;
+        printf("  %-16s %10lu %10.3f %10.3f %10.3f%s\n", ptype->rtyp->name,
+            ptype->nrec, ptype->ns[initPhaseRecord0] * 1e-9,
+            ptype->ns[initPhaseLinks] * 1e-9,
+            ptype->ns[initPhaseRecord1] * 1e-9,
+            ptype->rtyp->threadSafeInit ? "  (parallel)" : "");
+    }
 }
 
 static void initDatabase(void)
 {
+    static recIterFunc const initFuncs[initPhases] = {
+        doInitRecord0, doResolveLinks, doInitRecord1
+    };
+    epicsThreadPool *pool = NULL;
+    epicsUInt64 phaseNs[initPhases];
+    dbRecordType *pdbRecordType;
+    initType *ptypes;
+    initRec *precs;
+    initBatch *batches = NULL;
+    size_t ntypes = ellCount(&pdbbase->recordTypeList);
+    size_t nrec = 0, nbatch = 0, i;
+    unsigned nthreads = 0;
+    int j;
+
     dbChannelInit();
-    iterateRecords(doInitRecord0, NULL);
-    iterateRecords(doResolveLinks, NULL);
-    iterateRecords(doInitRecord1, NULL);
+
+    /* Gather the records, in the order iterateRecords() uses */
+    iterateRecords(countRecords, &nrec);
+    ptypes = callocMustSucceed(ntypes + 1, sizeof(initType), "initDatabase");
+    precs = callocMustSucceed(nrec + 1, sizeof(initRec), "initDatabase");
+    nrec = 0;
+    for (i = 0, pdbRecordType = (dbRecordType *)ellFirst(&pdbbase->recordTypeList);
+         pdbRecordType;
+         i++, pdbRecordType = (dbRecordType *)ellNext(&pdbRecordType->node)) {
+        dbRecordNode *pdbRecordNode;
+
+        ptypes[i].rtyp = pdbRecordType;
+        for (pdbRecordNode = (dbRecordNode *)ellFirst(&pdbRecordType->recList);
+             pdbRecordNode;
+             pdbRecordNode = (dbRecordNode *)ellNext(&pdbRecordNode->node)) {
+            dbCommon *precord = pdbRecordNode->precord;
+            devSup *pdevSup;
+
+            if (!precord->name[0] ||
+                pdbRecordNode->flags & DBRN_FLAGS_ISALIAS)
+                continue;
+
+            pdevSup = dbDTYPtoDevSup(pdbRecordType, precord->dtyp);
+            precs[nrec].ptype = &ptypes[i];
+            precs[nrec].prec = precord;
+            precs[nrec].threadSafe = pdbRecordType->threadSafeInit &&
+                (!pdevSup || pdevSup->threadSafeInit);
+            nrec++;
+            ptypes[i].nrec++;
+        }
+    }
+
+    if (dbInitRecordThreads) {
+        epicsThreadPoolConfig opts;
+
+        nthreads = dbInitRecordThreads > 0 ? dbInitRecordThreads :
+            epicsThreadGetCPUs();
+        epicsThreadPoolConfigDefaults(&opts);
+        opts.initialThreads = opts.maxThreads = nthreads;
+        pool = epicsThreadPoolCreate(&opts);
+        if (pool) {
+            initTimeLock = epicsMutexMustCreate();
+            batches = makeBatches(precs, nrec, pool, &nbatch);
+        }
+        else {
+            errlogPrintf("iocInit: Can't create %u init_record threads\n",
+                nthreads);
+            nthreads = 0;
+        }
+    }
+
+    for (j = 0; j < initPhases; j++) {
+        epicsUInt64 start = epicsMonotonicGet();
+
+        initPhase(j, initFuncs[j], precs, nrec,
+            j == initPhaseLinks ? NULL : pool, batches, nbatch);
+        phaseNs[j] = epicsMonotonicGet() - start;
+    }
+
+    if (pool) {
+        for (i = 0; i < nbatch; i++) {
+            if (batches[i].job)
+                epicsJobDestroy(batches[i].job);
+        }
+        epicsThreadPoolDestroy(pool);
+        epicsMutexDestroy(initTimeLock);
+        initTimeLock = NULL;
+        free(batches);
+    }
+    if (dbInitRecordTiming)
+        initTimingReport(ptypes, ntypes, phaseNs, nthreads);
+
+    free(precs);
+    free(ptypes);
 
     epicsAtExit(exitDatabase, NULL);
     return;
 }
-
+
 /*
  *  Process database records at initialization ordered by phase
  *     if their pini (process at init) field is set.
@@ -705,6 +959,7 @@ static void doFreeRecord(dbRecordType *pdbRecordType, dbCommon *precord,
 
     epicsMutexDestroy(precord->mlok);
     free(precord->ppnr); /* may be allocated in dbNotify.c */
+    dbSeqlockFreeRecord(precord);
 }
 
 int iocShutdown(void)
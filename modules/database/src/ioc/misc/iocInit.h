@@ -30,6 +30,11 @@ DBCORE_API int iocRun(void);
 DBCORE_API int iocPause(void);
 DBCORE_API int iocShutdown(void);
 
+/* Number of threads for parallel init_record(), 0 = serial, <0 = per CPU */
+DBCORE_API extern int dbInitRecordThreads;
+/* Print record initialization times per phase and record type */
+DBCORE_API extern int dbInitRecordTiming;
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,15 +27,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devAiSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long read_ai(aiRecord *prec);
 
 aidset devAiSoft = {
-    {6, NULL, NULL, init_record, NULL},
+    {6, NULL, init, init_record, NULL},
     read_ai, NULL
 };
 epicsExportAddress(dset, devAiSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
     aiRecord *prec = (aiRecord *)pcommon;
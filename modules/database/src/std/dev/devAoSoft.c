@@ -32,15 +32,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devAoSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long write_ao(aoRecord *prec);
 
 aodset devAoSoft = {
-    {6, NULL, NULL, init_record, NULL},
+    {6, NULL, init, init_record, NULL},
     write_ao, NULL
 };
 epicsExportAddress(dset, devAoSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
 
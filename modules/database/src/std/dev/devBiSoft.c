@@ -26,15 +26,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devBiSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long read_bi(biRecord *prec);
 
 bidset devBiSoft = {
-    {5, NULL, NULL, init_record, NULL},
+    {5, NULL, init, init_record, NULL},
     read_bi
 };
 epicsExportAddress(dset, devBiSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
 	biRecord *prec = (biRecord *)pcommon;
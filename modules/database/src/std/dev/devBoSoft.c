@@ -30,15 +30,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devBoSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long write_bo(boRecord *prec);
 
 bodset devBoSoft = {
-    {5, NULL, NULL, init_record, NULL},
+    {5, NULL, init, init_record, NULL},
     write_bo
 };
 epicsExportAddress(dset, devBoSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
    long status=0;
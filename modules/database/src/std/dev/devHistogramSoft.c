@@ -49,6 +49,17 @@ static long init_record(dbCommon *pcommon)
 
 static long read_histogram(histogramRecord *prec)
 {
+    if (prec->nsam > 1) {
+        long nRequest = prec->nsam;
+
+        if (dbGetLink(&prec->svl, DBR_DOUBLE, prec->sptr, 0, &nRequest))
+            nRequest = 0;
+        prec->nord = nRequest;
+        if (nRequest > 0)
+            prec->sgnl = prec->sptr[nRequest - 1];
+        return 0; /*add count*/
+    }
+
     dbGetLink(&prec->svl, DBR_DOUBLE, &prec->sgnl, 0, 0);
     return 0; /*add count*/
 }
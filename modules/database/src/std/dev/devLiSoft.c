@@ -26,15 +26,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devLiSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long read_longin(longinRecord *prec);
 
 longindset devLiSoft = {
-    {5, NULL, NULL, init_record, NULL},
+    {5, NULL, init, init_record, NULL},
     read_longin
 };
 epicsExportAddress(dset, devLiSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
     longinRecord *prec = (longinRecord *)pcommon;
@@ -26,15 +26,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devLoSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long write_longout(longoutRecord *prec);
 
 longoutdset devLoSoft = {
-    {5, NULL, NULL, init_record, NULL},
+    {5, NULL, init, init_record, NULL},
     write_longout
 };
 epicsExportAddress(dset, devLoSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
     return 0;
@@ -26,15 +26,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devMbbiSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long read_mbbi(mbbiRecord *prec);
 
 mbbidset devMbbiSoft = {
-    {5, NULL, NULL, init_record, NULL},
+    {5, NULL, init, init_record, NULL},
     read_mbbi
 };
 epicsExportAddress(dset, devMbbiSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
 	mbbiRecord *prec = (mbbiRecord *)pcommon;
@@ -27,15 +27,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devMbboSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long write_mbbo(mbboRecord *prec);
 
 mbbodset devMbboSoft = {
-    {5, NULL, NULL, init_record, NULL},
+    {5, NULL, init, init_record, NULL},
     write_mbbo
 };
 epicsExportAddress(dset, devMbboSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
     /*dont convert*/
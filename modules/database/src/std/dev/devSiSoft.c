@@ -28,15 +28,23 @@
 #include "epicsExport.h"
 
 /* Create the dset for devSiSoft */
+static long init(int after);
 static long init_record(dbCommon *pcommon);
 static long read_stringin(stringinRecord *prec);
 
 stringindset devSiSoft = {
-    {5, NULL, NULL, init_record, NULL},
+    {5, NULL, init, init_record, NULL},
     read_stringin
 };
 epicsExportAddress(dset, devSiSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long init_record(dbCommon *pcommon)
 {
     stringinRecord *prec = (stringinRecord *)pcommon;
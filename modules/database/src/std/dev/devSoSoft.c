@@ -26,14 +26,22 @@
 #include "epicsExport.h"
 
 /* Create the dset for devSoSoft */
+static long init(int after);
 static long write_stringout(stringoutRecord *prec);
 
 stringoutdset devSoSoft = {
-    {5, NULL, NULL, NULL, NULL},
+    {5, NULL, init, NULL, NULL},
     write_stringout
 };
 epicsExportAddress(dset, devSoSoft);
 
+static long init(int after)
+{
+    if (!after)
+        devThreadSafeInit();
+    return 0;
+}
+
 static long write_stringout(stringoutRecord *prec)
 {
     long status;
@@ -21,19 +21,24 @@
 #include "epicsExport.h"
 
 typedef int (*PRINTFFUNC)(const char *fmt, ...);
+typedef void (*WRITEFUNC)(const char *line, size_t len);
 
 static int stderrPrintf(const char *fmt, ...);
 static int logPrintf(const char *fmt, ...);
+static void stdoutWrite(const char *line, size_t len);
+static void stderrWrite(const char *line, size_t len);
+static void logWrite(const char *line, size_t len);
 
 
 static struct outStream {
     const char *name;
     PRINTFFUNC print;
+    WRITEFUNC write;
 } outStreams[] = {
-    {"stdout", printf},
-    {"stderr", stderrPrintf},
-    {"errlog", logPrintf},
-    {NULL, NULL}
+    {"stdout", printf, stdoutWrite},
+    {"stderr", stderrPrintf, stderrWrite},
+    {"errlog", logPrintf, logWrite},
+    {NULL, NULL, NULL}
 };
 
 static int stderrPrintf(const char *fmt, ...) {
@@ -58,6 +63,37 @@ static int logPrintf(const char *fmt, ...) {
     return retval;
 }
 
+static void stdoutWrite(const char *line, size_t len) {
+    fwrite(line, 1, len, stdout);
+}
+
+static void stderrWrite(const char *line, size_t len) {
+    fwrite(line, 1, len, stderr);
+}
+
+static void logWrite(const char *line, size_t len) {
+    errlogMessage(line);
+}
+
+/* Output a string and a newline to the stream.  Most lines are joined
+ * here and passed on in one write, which the stdout buffer and the
+ * errlog queue take as a single entry, and stderr as a single system
+ * call; only longer lines are formatted by the stream.
+ */
+static void writeLine(struct outStream *pstream, const char *str) {
+    char line[256];
+    size_t len = strlen(str);
+
+    if (len < sizeof(line) - 1) {
+        memcpy(line, str, len);
+        line[len++] = '\n';
+        line[len] = 0;
+        pstream->write(line, len);
+    }
+    else
+        pstream->print("%s\n", str);
+}
+
 
 /* lso device support */
 
@@ -99,7 +135,7 @@ static long write_lso(lsoRecord *prec)
 {
     struct outStream *pstream = (struct outStream *)prec->dpvt;
     if (pstream)
-        pstream->print("%s\n", prec->val);
+        writeLine(pstream, prec->val);
     return 0;
 }
 
@@ -149,7 +185,7 @@ static long write_printf(printfRecord *prec)
 {
     struct outStream *pstream = (struct outStream *)prec->dpvt;
     if (pstream)
-        pstream->print("%s\n", prec->val);
+        writeLine(pstream, prec->val);
     return 0;
 }
 
@@ -199,7 +235,7 @@ static long write_stringout(stringoutRecord *prec)
 {
     struct outStream *pstream = (struct outStream *)prec->dpvt;
     if (pstream)
-        pstream->print("%s\n", prec->val);
+        writeLine(pstream, prec->val);
     return 0;
 }
 
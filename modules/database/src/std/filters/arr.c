@@ -30,7 +30,15 @@ typedef struct myStruct {
     long no_elements;
 } myStruct;
 
+/* Saved state of a field log that has been turned into a slice view */
+typedef struct sliceView {
+    dbfl_freeFunc *dtor;
+    void *field;
+    void *pvt;
+} sliceView;
+
 static void *myStructFreeList;
+static void *sliceViewFreeList;
 
 static const chfPluginArgDef opts[] = {
     chfInt32 (myStruct, start, "s", 0, 1),
@@ -74,6 +82,35 @@ static void freeArray(db_field_log *pfl)
     }
 }
 
+/* Restore the field log to the buffer it owned and release that */
+static void freeView(db_field_log *pfl)
+{
+    sliceView *view = (sliceView *) pfl->u.r.pvt;
+
+    pfl->dtor = view->dtor;
+    pfl->u.r.field = view->field;
+    pfl->u.r.pvt = view->pvt;
+    freeListFree(sliceViewFreeList, view);
+    if (pfl->dtor) pfl->dtor(pfl);
+}
+
+/* Make pfl reference nTarget elements of its own copy starting at
+ * offset, without copying them.
+ */
+static int makeView(db_field_log *pfl, long offset)
+{
+    sliceView *view = (sliceView *) freeListMalloc(sliceViewFreeList);
+
+    if (!view) return 0;
+    view->dtor = pfl->dtor;
+    view->field = pfl->u.r.field;
+    view->pvt = pfl->u.r.pvt;
+    pfl->u.r.field = (char *) pfl->u.r.field + offset * pfl->field_size;
+    pfl->u.r.pvt = view;
+    pfl->dtor = freeView;
+    return 1;
+}
+
 static long wrapArrayIndices(long *start, const long increment, long *end,
     const long no_elements)
 {
@@ -115,6 +152,15 @@ static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
             dbChannelGetArrayInfo(chan, &pSource, &nSource, &offset);
         }
         nTarget = wrapArrayIndices(&start, my->incr, &end, nSource);
+        /* A contiguous slice of a buffer the field log already owns
+         * (offset is 0 and start + nTarget <= nSource) is referenced
+         * in place rather than copied.
+         */
+        if (nTarget > 0 && !must_lock && my->incr == 1 &&
+            (start == 0 || makeView(pfl, start))) {
+            pfl->no_elements = nTarget;
+            break;
+        }
         if (nTarget > 0) {
             /* copy the data */
             pTarget = freeListCalloc(my->arrayFreeList);
@@ -185,12 +231,17 @@ static void arrShutdown(void* ignore)
     if(myStructFreeList)
         freeListCleanup(myStructFreeList);
     myStructFreeList = NULL;
+    if(sliceViewFreeList)
+        freeListCleanup(sliceViewFreeList);
+    sliceViewFreeList = NULL;
 }
 
 static void arrInitialize(void)
 {
     if (!myStructFreeList)
         freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+    if (!sliceViewFreeList)
+        freeListInitPvt(&sliceViewFreeList, sizeof(sliceView), 64);
 
     chfPluginRegister("arr", &pif, opts);
     epicsAtExit(arrShutdown, NULL);
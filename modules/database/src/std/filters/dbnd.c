@@ -13,27 +13,42 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <epicsMath.h>
 #include <freeList.h>
 #include <dbConvertFast.h>
+#include <dbConvert.h>
 #include <chfPlugin.h>
 #include <recGbl.h>
 #include <epicsExit.h>
 #include <dbAccess.h>
+#include <dbLock.h>
 #include <epicsExport.h>
 
+#define MODE_ABS  0
+#define MODE_REL  1
+#define MODE_HASH 2
+
 typedef struct myStruct {
     int    mode;
     double cval;
     double hyst;
     double last;
+    /* array updates */
+    long   nlast;       /* elements in last update sent, -1 if none yet */
+    long   nalloc;      /* elements allocated in plast and pwork */
+    double *plast;      /* abs, rel: last array sent */
+    double *pwork;      /* abs, rel: current array */
+    epicsUInt64 hash;   /* hash: hash of last update sent */
 } myStruct;
 
 static void *myStructFreeList;
 
 static const
-chfPluginEnumType modeEnum[] = { {"abs", 0}, {"rel", 1}, {NULL,0} };
+chfPluginEnumType modeEnum[] = { {"abs", MODE_ABS}, {"rel", MODE_REL},
+    {"hash", MODE_HASH}, {NULL,0} };
 
 static const
 chfPluginArgDef opts[] = {
@@ -51,6 +66,10 @@ static void * allocPvt(void)
 
 static void freePvt(void *pvt)
 {
+    myStruct *my = (myStruct*) pvt;
+
+    free(my->plast);
+    free(my->pwork);
     freeListFree(myStructFreeList, pvt);
 }
 
@@ -59,9 +78,144 @@ static int parse_ok(void *pvt)
     myStruct *my = (myStruct*) pvt;
     my->hyst = my->cval;
     my->last = epicsNAN;
+    my->nlast = -1;
+    return 0;
+}
+
+/* 64-bit FNV-1a, taking 8 bytes per step */
+#define HASH_PRIME 0x100000001b3ull
+#define HASH_BASIS 0xcbf29ce484222325ull
+
+static epicsUInt64 hashBytes(epicsUInt64 h, const char *p, size_t len)
+{
+    while (len >= 8) {
+        epicsUInt64 word;
+
+        memcpy(&word, p, 8);
+        h = (h ^ word) * HASH_PRIME;
+        p += 8;
+        len -= 8;
+    }
+    while (len--)
+        h = (h ^ (unsigned char) *p++) * HASH_PRIME;
+    return h;
+}
+
+/* Whether any element of pnew is outside the deadband around plast.
+ * Elements are compared in blocks without early exit so the compiler
+ * can vectorize the inner loop.  Two NaNs compare equal, as for scalars.
+ */
+static int arrayChanged(const double *pnew, const double *plast, long n,
+    double abstol, double reltol)
+{
+    long i = 0;
+
+    while (i < n) {
+        long end = n - i > 256 ? i + 256 : n;
+        int changed = 0;
+
+        for (; i < end; i++) {
+            double x = pnew[i], l = plast[i];
+            double tol = abstol + reltol * fabs(l);
+
+            changed |= (x != l) & !(fabs(x - l) <= tol) &
+                ((x == x) | (l == l));
+        }
+        if (changed)
+            return 1;
+    }
     return 0;
 }
 
+/* Returns 1 if the array in pfl differs from the last one sent, 0 if
+ * not, and -1 if it can't be compared.  Record-owned data must be read
+ * with the record locked.
+ */
+static int compareArray(myStruct *my, dbChannel *chan, db_field_log *pfl)
+{
+    DBADDR localAddr = chan->addr; /* Structure copy */
+    void *pfield = pfl->u.r.field;
+    long nelem = pfl->no_elements;
+    long offset = 0;
+    long capacity;
+
+    if (!dbfl_has_copy(pfl)) {
+        dbChannelGetArrayInfo(chan, &pfield, &nelem, &offset);
+        capacity = chan->addr.no_elements;
+    } else {
+        capacity = nelem;
+    }
+    if (nelem < 0 || nelem > capacity)
+        return -1;
+
+    if (my->mode == MODE_HASH) {
+        epicsUInt64 h = HASH_BASIS;
+        size_t size = pfl->field_size;
+        long nUpper = nelem < capacity - offset ? nelem : capacity - offset;
+
+        h = hashBytes(h, (char *) pfield + offset * size, nUpper * size);
+        h = hashBytes(h, (char *) pfield, (nelem - nUpper) * size);
+        if (my->nlast == nelem && my->hash == h)
+            return 0;
+        my->hash = h;
+        my->nlast = nelem;
+        return 1;
+    }
+
+    if (nelem > my->nalloc) {
+        double *plast = realloc(my->plast, nelem * sizeof(double));
+        double *pwork;
+
+        if (plast)
+            my->plast = plast;
+        pwork = realloc(my->pwork, nelem * sizeof(double));
+        if (pwork)
+            my->pwork = pwork;
+        if (!plast || !pwork)
+            return -1;
+        my->nalloc = nelem;
+    }
+
+    localAddr.field_type = pfl->field_type;
+    localAddr.field_size = pfl->field_size;
+    localAddr.no_elements = capacity;
+    localAddr.pfield = pfield;
+    if (nelem > 0 &&
+        dbGetConvertRoutine[pfl->field_type][DBR_DOUBLE]
+            (&localAddr, my->pwork, nelem, capacity, offset))
+        return -1;
+
+    if (my->nlast == nelem &&
+        !arrayChanged(my->pwork, my->plast, nelem,
+            my->mode == MODE_ABS ? my->cval : 0.0,
+            my->mode == MODE_REL ? my->cval / 100. : 0.0))
+        return 0;
+
+    /* the current array becomes the last one sent */
+    {
+        double *ptmp = my->plast;
+
+        my->plast = my->pwork;
+        my->pwork = ptmp;
+    }
+    my->nlast = nelem;
+    return 1;
+}
+
+static int checkArray(myStruct *my, dbChannel *chan, db_field_log *pfl)
+{
+    int changed;
+
+    /* Reads run the pre-chain without the record locked */
+    if (dbfl_has_copy(pfl))
+        return compareArray(my, chan, pfl);
+
+    dbScanLock(dbChannelRecord(chan));
+    changed = compareArray(my, chan, pfl);
+    dbScanUnlock(dbChannelRecord(chan));
+    return changed;
+}
+
 static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl) {
     myStruct *my = (myStruct*) pvt;
     long status;
@@ -69,10 +223,30 @@ static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl) {
     unsigned send = 1;
 
     /*
-     * Only scalar values supported - strings, arrays, and conversion errors
-     * are just passed on
+     * Conversion errors, and strings except in hash mode, are just passed on
      */
-    if (pfl->type == dbfl_type_val) {
+    if (pfl->type == dbfl_type_ref) {
+        int changed = checkArray(my, chan, pfl);
+
+        if (changed >= 0) {
+            send = pfl->mask & ~(DBE_VALUE|DBE_LOG);
+            if (changed)
+                send |= pfl->mask & (DBE_VALUE|DBE_LOG);
+        }
+    }
+    else if (my->mode == MODE_HASH) {
+        size_t size = pfl->field_size < sizeof(pfl->u.v.field) ?
+            pfl->field_size : sizeof(pfl->u.v.field);
+        epicsUInt64 h = hashBytes(HASH_BASIS, (char *) &pfl->u.v.field, size);
+
+        send = pfl->mask & ~(DBE_VALUE|DBE_LOG);
+        if (my->nlast != 1 || my->hash != h) {
+            send |= pfl->mask & (DBE_VALUE|DBE_LOG);
+            my->hash = h;
+            my->nlast = 1;
+        }
+    }
+    else {
         DBADDR localAddr = chan->addr; /* Structure copy */
         localAddr.field_type = pfl->field_type;
         localAddr.field_size = pfl->field_size;
@@ -83,7 +257,7 @@ static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl) {
         if (!status) {
             send = pfl->mask & ~(DBE_VALUE|DBE_LOG);
             recGblCheckDeadband(&my->last, val, my->hyst, &send, pfl->mask & (DBE_VALUE|DBE_LOG));
-            if (send && my->mode == 1) {
+            if (send && my->mode == MODE_REL) {
                 my->hyst = val * my->cval/100.;
             }
         }
@@ -106,7 +280,7 @@ static void channel_report(dbChannel *chan, void *pvt, int level, const unsigned
     myStruct *my = (myStruct*) pvt;
     printf("%*sDeadband (dbnd): mode=%s, delta=%g%s\n", indent, "",
            chfPluginEnumString(modeEnum, my->mode, "n/a"), my->cval,
-           my->mode == 1 ? "%" : "");
+           my->mode == MODE_REL ? "%" : "");
 }
 
 static chfPluginIf pif = {
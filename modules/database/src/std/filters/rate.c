@@ -0,0 +1,378 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Rate limiting filter, "rate".
+ *
+ * Sends at most one monitor update per period.  The first update after
+ * a quiet period is sent at once; later updates within the period are
+ * held back and the latest value, or the min, max or mean of the values
+ * held, is sent by a timer at the end of the period.  A change of alarm
+ * severity is always sent immediately.
+ *
+ * Several subscriptions may share a channel, so the period, the held
+ * updates and the timer are kept for each subscription separately.
+ */
+
+#include <stdio.h>
+
+#include "epicsMath.h"
+#include "epicsTimer.h"
+#include "epicsThread.h"
+#include "ellLib.h"
+#include "freeList.h"
+#include "caeventmask.h"
+#include "dbAccess.h"
+#include "db_field_log.h"
+#include "dbChannel.h"
+#include "dbEvent.h"
+#include "dbLock.h"
+#include "chfPlugin.h"
+#include "epicsExit.h"
+#include "epicsExport.h"
+
+#define MODE_LAST 0
+#define MODE_MIN  1
+#define MODE_MAX  2
+#define MODE_MEAN 3
+
+typedef struct myStruct {
+    int mode;
+    double period;
+    dbChannel *chan;
+    epicsTimerQueueId queue;
+    ELLLIST subs;           /* rateSub, protected by the record's scan lock */
+} myStruct;
+
+/* State of one subscription, protected by the record's scan lock */
+typedef struct rateSub {
+    ELLNODE node;
+    myStruct *my;
+    struct evSubscrip *sub; /* NULL if this slot is free */
+    epicsTimerId timer;
+    int armed;              /* the period timer is running */
+    int flushing;           /* the timer is posting the held update */
+    unsigned mask;          /* event mask of the held updates, 0 if none */
+    epicsEnum16 sevr;       /* severity of the last update sent */
+    long count;             /* values in the window */
+    double agg;             /* min, max or sum of the values in the window */
+} rateSub;
+
+static void *myStructFreeList;
+static void *rateSubFreeList;
+
+static const
+chfPluginEnumType modeEnum[] = {
+    {"last", MODE_LAST}, {"min", MODE_MIN}, {"max", MODE_MAX},
+    {"mean", MODE_MEAN}, {NULL, 0}
+};
+
+static const
+chfPluginArgDef opts[] = {
+    chfDouble (myStruct, period, "t", 0, 1),
+    chfEnum   (myStruct, mode, "m", 0, 1, modeEnum),
+    chfPluginArgEnd
+};
+
+static int getDouble(short field_type, const void *pfield, double *pval)
+{
+    switch (field_type) {
+    case DBF_CHAR:   *pval = *(const epicsInt8 *) pfield; break;
+    case DBF_UCHAR:  *pval = *(const epicsUInt8 *) pfield; break;
+    case DBF_SHORT:  *pval = *(const epicsInt16 *) pfield; break;
+    case DBF_USHORT: *pval = *(const epicsUInt16 *) pfield; break;
+    case DBF_ENUM:   *pval = *(const epicsEnum16 *) pfield; break;
+    case DBF_LONG:   *pval = *(const epicsInt32 *) pfield; break;
+    case DBF_ULONG:  *pval = *(const epicsUInt32 *) pfield; break;
+    case DBF_INT64:  *pval = (double) *(const epicsInt64 *) pfield; break;
+    case DBF_UINT64: *pval = (double) *(const epicsUInt64 *) pfield; break;
+    case DBF_FLOAT:  *pval = *(const epicsFloat32 *) pfield; break;
+    case DBF_DOUBLE: *pval = *(const epicsFloat64 *) pfield; break;
+    default:
+        return -1;
+    }
+    return 0;
+}
+
+/* Replace the value in pfl by a double */
+static void setDouble(db_field_log *pfl, double val)
+{
+    if (pfl->type == dbfl_type_ref && pfl->dtor) {
+        pfl->dtor(pfl);
+        pfl->dtor = NULL;
+    }
+    pfl->type = dbfl_type_val;
+    pfl->field_type = DBF_DOUBLE;
+    pfl->field_size = sizeof(epicsFloat64);
+    pfl->no_elements = 1;
+    pfl->u.v.field.dbf_double = val;
+}
+
+/* Value of a scalar update as a double, NaN if not available */
+static double logValue(dbChannel *chan, db_field_log *pfl)
+{
+    double val = epicsNAN;
+
+    if (dbfl_has_copy(pfl)) {
+        getDouble(pfl->field_type, dbfl_pfield(pfl), &val);
+    } else {
+        dbScanLock(dbChannelRecord(chan));
+        getDouble(pfl->field_type, dbChannelField(chan), &val);
+        dbScanUnlock(dbChannelRecord(chan));
+    }
+    return val;
+}
+
+static void accumulate(rateSub *rs, double val)
+{
+    if (rs->count++ == 0) {
+        rs->agg = val;
+        return;
+    }
+    switch (rs->my->mode) {
+    case MODE_MIN:  if (val < rs->agg) rs->agg = val; break;
+    case MODE_MAX:  if (val > rs->agg) rs->agg = val; break;
+    case MODE_MEAN: rs->agg += val; break;
+    }
+}
+
+static double aggregate(rateSub *rs)
+{
+    if (rs->count == 0)
+        return epicsNAN;
+    if (rs->my->mode == MODE_MEAN)
+        return rs->agg / rs->count;
+    return rs->agg;
+}
+
+static void expire(void *pvt);
+
+/* Find the state of a subscription, or set up a slot for a new one.
+ * Slots of subscriptions which were cancelled are re-used.
+ */
+static rateSub* findSub(myStruct *my, struct evSubscrip *sub)
+{
+    rateSub *rs, *slot = NULL;
+
+    for (rs = (rateSub*) ellFirst(&my->subs); rs;
+         rs = (rateSub*) ellNext(&rs->node)) {
+        if (rs->sub == sub)
+            return rs;
+        if (!slot && !rs->armed && (!rs->sub ||
+            db_post_subscription_events(rs->sub, my->chan, 0)))
+            slot = rs;
+    }
+
+    if (!slot) {
+        slot = (rateSub*) freeListCalloc(rateSubFreeList);
+        if (!slot)
+            return NULL;
+        slot->my = my;
+        slot->timer = epicsTimerQueueCreateTimer(my->queue, expire, slot);
+        if (!slot->timer) {
+            freeListFree(rateSubFreeList, slot);
+            return NULL;
+        }
+        ellAdd(&my->subs, &slot->node);
+    }
+    slot->sub = sub;
+    slot->mask = 0;
+    slot->count = 0;
+    return slot;
+}
+
+/* Start a new period, sending the update pfl */
+static db_field_log* send(rateSub *rs, db_field_log *pfl)
+{
+    if (rs->my->mode != MODE_LAST)
+        setDouble(pfl, aggregate(rs));
+    rs->count = 0;
+    rs->mask = 0;
+    rs->sevr = pfl->sevr;
+    if (!rs->armed) {
+        rs->armed = 1;
+        epicsTimerStartDelay(rs->timer, rs->my->period);
+    }
+    return pfl;
+}
+
+static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
+{
+    myStruct *my = (myStruct*) pvt;
+    unsigned mask = pfl->mask;
+    rateSub *rs;
+
+    /* Gets and property updates are not limited */
+    if (pfl->ctx == dbfl_context_read || (mask & DBE_PROPERTY) ||
+        !(rs = findSub(my, pfl->sub))) {
+        if (my->mode != MODE_LAST)
+            setDouble(pfl, logValue(chan, pfl));
+        return pfl;
+    }
+
+    /* Posted by our timer, send what was held */
+    if (rs->flushing) {
+        if (my->mode != MODE_LAST)
+            setDouble(pfl, aggregate(rs));
+        return pfl;
+    }
+
+    if (my->mode != MODE_LAST)
+        accumulate(rs, logValue(chan, pfl));
+
+    if (!rs->armed || pfl->sevr != rs->sevr)
+        return send(rs, pfl);
+
+    rs->mask |= mask;
+    db_delete_field_log(pfl);
+    return NULL;
+}
+
+static void expire(void *pvt)
+{
+    rateSub *rs = (rateSub*) pvt;
+    myStruct *my = rs->my;
+    dbCommon *prec = dbChannelRecord(my->chan);
+
+    dbScanLock(prec);
+    if (rs->sub && rs->mask) {
+        int gone;
+
+        rs->flushing = 1;
+        gone = db_post_subscription_events(rs->sub, my->chan, rs->mask);
+        rs->flushing = 0;
+        rs->count = 0;
+        rs->mask = 0;
+        if (!gone) {
+            rs->sevr = prec->sevr;
+            epicsTimerStartDelay(rs->timer, my->period);
+            dbScanUnlock(prec);
+            return;
+        }
+        rs->sub = NULL;
+    }
+    rs->armed = 0;
+    dbScanUnlock(prec);
+}
+
+static void * allocPvt(void)
+{
+    myStruct *my = (myStruct*) freeListCalloc(myStructFreeList);
+    if (!my) return NULL;
+
+    /* defaults */
+    my->period = 1.0;
+    my->mode = MODE_LAST;
+    return (void *) my;
+}
+
+static void freePvt(void *pvt)
+{
+    freeListFree(myStructFreeList, pvt);
+}
+
+static int parse_ok(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (!(my->period > 0.0))
+        return -1;
+    return 0;
+}
+
+static long channel_open(dbChannel *chan, void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    my->chan = chan;
+    ellInit(&my->subs);
+    my->queue = epicsTimerQueueAllocate(1, epicsThreadPriorityScanLow);
+    if (!my->queue)
+        return -1;
+    return 0;
+}
+
+static void channelRegisterPre(dbChannel *chan, void *pvt,
+    chPostEventFunc **cb_out, void **arg_out, db_field_log *probe)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    /* Only numeric scalars can be aggregated, just limit the rest */
+    if (probe->no_elements != 1 ||
+        probe->field_type == DBF_STRING || probe->field_type > DBF_ENUM)
+        my->mode = MODE_LAST;
+
+    if (my->mode != MODE_LAST) {
+        probe->field_type = DBF_DOUBLE;
+        probe->field_size = sizeof(epicsFloat64);
+        probe->type = dbfl_type_val;
+    }
+    *cb_out = filter;
+    *arg_out = pvt;
+}
+
+static void channel_report(dbChannel *chan, void *pvt, int level,
+    const unsigned short indent)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    printf("%*sRate limit (rate): t=%g, mode=%s, %d subscription slots\n",
+           indent, "", my->period,
+           chfPluginEnumString(modeEnum, my->mode, "n/a"),
+           ellCount(&my->subs));
+}
+
+static void channel_close(dbChannel *chan, void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+    rateSub *rs;
+
+    /* Waits for a running expire() to finish */
+    while ((rs = (rateSub*) ellGet(&my->subs))) {
+        epicsTimerQueueDestroyTimer(my->queue, rs->timer);
+        freeListFree(rateSubFreeList, rs);
+    }
+    if (my->queue)
+        epicsTimerQueueRelease(my->queue);
+    my->queue = NULL;
+}
+
+static chfPluginIf pif = {
+    allocPvt,
+    freePvt,
+
+    NULL, /* parse_error, */
+    parse_ok,
+
+    channel_open,
+    channelRegisterPre,
+    NULL, /* channelRegisterPost, */
+    channel_report,
+    channel_close
+};
+
+static void rateShutdown(void* ignore)
+{
+    if(myStructFreeList)
+        freeListCleanup(myStructFreeList);
+    myStructFreeList = NULL;
+    if(rateSubFreeList)
+        freeListCleanup(rateSubFreeList);
+    rateSubFreeList = NULL;
+}
+
+static void rateInitialize(void)
+{
+    if (!myStructFreeList)
+        freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+    if (!rateSubFreeList)
+        freeListInitPvt(&rateSubFreeList, sizeof(rateSub), 64);
+
+    chfPluginRegister("rate", &pif, opts);
+    epicsAtExit(rateShutdown, NULL);
+}
+
+epicsExportRegistrar(rateInitialize);
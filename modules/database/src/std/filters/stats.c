@@ -0,0 +1,421 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Array statistics filter, "stats".
+ *
+ * Reduces an array field to a single statistic, to a fixed set of
+ * statistics, or to a min/max envelope of N buckets.  It runs in the
+ * pre-chain so only the reduced data is put on the event queue.
+ */
+
+#include <stdio.h>
+#include <math.h>
+
+#include "epicsMath.h"
+#include "epicsTypes.h"
+#include "freeList.h"
+#include "dbAccess.h"
+#include "db_field_log.h"
+#include "dbChannel.h"
+#include "dbLock.h"
+#include "chfPlugin.h"
+#include "epicsExit.h"
+#include "epicsExport.h"
+
+#define MODE_MEAN 0
+#define MODE_RMS  1
+#define MODE_STD  2
+#define MODE_MIN  3
+#define MODE_MAX  4
+#define MODE_ALL  5
+#define MODE_ENV  6
+
+/* Elements of the "all" output array */
+#define ALL_COUNT 6
+
+typedef struct myStruct {
+    int mode;
+    epicsInt32 nbuckets;
+    long nout;              /* elements in the output array */
+    void *arrayFreeList;
+} myStruct;
+
+static void *myStructFreeList;
+
+static const
+chfPluginEnumType modeEnum[] = {
+    {"mean", MODE_MEAN}, {"rms", MODE_RMS}, {"std", MODE_STD},
+    {"min", MODE_MIN}, {"max", MODE_MAX}, {"all", MODE_ALL},
+    {"env", MODE_ENV}, {NULL, 0}
+};
+
+static const
+chfPluginArgDef opts[] = {
+    chfEnum  (myStruct, mode, "m", 0, 1, modeEnum),
+    chfInt32 (myStruct, nbuckets, "n", 0, 1),
+    chfPluginArgEnd
+};
+
+/* Running sums are kept relative to a shift (normally the first
+ * element) so that the variance does not lose precision when the
+ * values have a large common offset.
+ */
+typedef struct reduction {
+    long n;
+    double shift;
+    double sum;
+    double sumsq;
+    double min;
+    double max;
+} reduction;
+
+typedef void (reduceFunc)(const void *pv, long n, reduction *r);
+
+/* Each kernel keeps four independent partial results so the loop
+ * body can be unrolled and vectorized.
+ */
+#define DEFINE_REDUCE(NAME, TYPE) \
+static void NAME(const void *pv, long n, reduction *r) \
+{ \
+    const TYPE *p = (const TYPE *) pv; \
+    double sum[4] = {0.0, 0.0, 0.0, 0.0}; \
+    double sumsq[4] = {0.0, 0.0, 0.0, 0.0}; \
+    double lo[4], hi[4]; \
+    double shift = r->shift; \
+    long i; \
+    int k; \
+\
+    for (k = 0; k < 4; k++) { \
+        lo[k] = r->min; \
+        hi[k] = r->max; \
+    } \
+    for (i = 0; i + 4 <= n; i += 4) { \
+        for (k = 0; k < 4; k++) { \
+            double x = (double) p[i + k]; \
+            double d = x - shift; \
+            sum[k] += d; \
+            sumsq[k] += d * d; \
+            lo[k] = x < lo[k] ? x : lo[k]; \
+            hi[k] = x > hi[k] ? x : hi[k]; \
+        } \
+    } \
+    for (; i < n; i++) { \
+        double x = (double) p[i]; \
+        double d = x - shift; \
+        sum[0] += d; \
+        sumsq[0] += d * d; \
+        lo[0] = x < lo[0] ? x : lo[0]; \
+        hi[0] = x > hi[0] ? x : hi[0]; \
+    } \
+    for (k = 0; k < 4; k++) { \
+        r->sum += sum[k]; \
+        r->sumsq += sumsq[k]; \
+        r->min = lo[k] < r->min ? lo[k] : r->min; \
+        r->max = hi[k] > r->max ? hi[k] : r->max; \
+    } \
+    r->n += n; \
+}
+
+DEFINE_REDUCE(reduceInt8,    epicsInt8)
+DEFINE_REDUCE(reduceUInt8,   epicsUInt8)
+DEFINE_REDUCE(reduceInt16,   epicsInt16)
+DEFINE_REDUCE(reduceUInt16,  epicsUInt16)
+DEFINE_REDUCE(reduceInt32,   epicsInt32)
+DEFINE_REDUCE(reduceUInt32,  epicsUInt32)
+DEFINE_REDUCE(reduceInt64,   epicsInt64)
+DEFINE_REDUCE(reduceUInt64,  epicsUInt64)
+DEFINE_REDUCE(reduceFloat32, epicsFloat32)
+DEFINE_REDUCE(reduceFloat64, epicsFloat64)
+
+static reduceFunc * reduceFor(short field_type)
+{
+    switch (field_type) {
+    case DBF_CHAR:   return reduceInt8;
+    case DBF_UCHAR:  return reduceUInt8;
+    case DBF_SHORT:  return reduceInt16;
+    case DBF_USHORT: return reduceUInt16;
+    case DBF_ENUM:   return reduceUInt16;
+    case DBF_LONG:   return reduceInt32;
+    case DBF_ULONG:  return reduceUInt32;
+    case DBF_INT64:  return reduceInt64;
+    case DBF_UINT64: return reduceUInt64;
+    case DBF_FLOAT:  return reduceFloat32;
+    case DBF_DOUBLE: return reduceFloat64;
+    default:         return NULL;
+    }
+}
+
+/* Source array as seen by the filter; a record's circular buffer
+ * starts at offset and wraps around at capacity.
+ */
+typedef struct source {
+    const char *pfield;
+    long nelem;
+    long offset;
+    long capacity;
+    short size;
+    reduceFunc *reduce;
+} source;
+
+static void reduceInit(reduction *r, double shift)
+{
+    r->n = 0;
+    r->shift = shift;
+    r->sum = r->sumsq = 0.0;
+    r->min = epicsINF;
+    r->max = -epicsINF;
+}
+
+/* Reduce count elements starting at logical index start */
+static void reduceRange(const source *src, long start, long count,
+    reduction *r)
+{
+    long first = (src->offset + start) % src->capacity;
+    long nUpper = src->capacity - first;
+
+    if (nUpper > count)
+        nUpper = count;
+    src->reduce(src->pfield + first * src->size, nUpper, r);
+    if (count > nUpper)
+        src->reduce(src->pfield, count - nUpper, r);
+}
+
+static double firstValue(const source *src)
+{
+    reduction r;
+
+    reduceInit(&r, 0.0);
+    reduceRange(src, 0, 1, &r);
+    return r.sum;
+}
+
+static double statistic(int mode, const reduction *r)
+{
+    double mean, var;
+
+    if (r->n == 0)
+        return epicsNAN;
+    mean = r->sum / r->n;
+    var = r->sumsq / r->n - mean * mean;
+    if (var < 0.0)
+        var = 0.0;
+
+    switch (mode) {
+    case MODE_MEAN: return r->shift + mean;
+    case MODE_STD:  return sqrt(var);
+    case MODE_RMS:  return sqrt(var + (r->shift + mean) * (r->shift + mean));
+    case MODE_MIN:  return r->min;
+    case MODE_MAX:  return r->max;
+    default:        return epicsNAN;
+    }
+}
+
+static void * allocPvt(void)
+{
+    myStruct *my = (myStruct*) freeListCalloc(myStructFreeList);
+    if (!my) return NULL;
+
+    /* defaults */
+    my->mode = MODE_ALL;
+    my->nbuckets = 100;
+    return (void *) my;
+}
+
+static void freePvt(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->arrayFreeList) freeListCleanup(my->arrayFreeList);
+    freeListFree(myStructFreeList, pvt);
+}
+
+static int parse_ok(void *pvt)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    if (my->mode == MODE_ENV && my->nbuckets < 1)
+        return -1;
+    return 0;
+}
+
+static void freeArray(db_field_log *pfl)
+{
+    freeListFree(pfl->u.r.pvt, pfl->u.r.field);
+}
+
+static db_field_log* filter(void* pvt, dbChannel *chan, db_field_log *pfl)
+{
+    myStruct *my = (myStruct*) pvt;
+    int must_lock = !dbfl_has_copy(pfl);
+    void *pfield = pfl->u.r.field;
+    double *pout = NULL;
+    long nout = 0;
+    reduction r;
+    source src;
+
+    if (pfl->type != dbfl_type_ref)
+        return pfl;
+
+    src.nelem = pfl->no_elements;
+    src.offset = 0;
+    src.size = pfl->field_size;
+    src.reduce = reduceFor(pfl->field_type);
+    if (!src.reduce)
+        return pfl;
+
+    if (my->mode >= MODE_ALL) {
+        pout = freeListMalloc(my->arrayFreeList);
+        if (!pout)
+            return pfl;
+    }
+
+    /* Reads run the pre-chain without the record locked */
+    if (must_lock) {
+        dbScanLock(dbChannelRecord(chan));
+        dbChannelGetArrayInfo(chan, &pfield, &src.nelem, &src.offset);
+        src.capacity = dbChannelElements(chan);
+    } else {
+        src.capacity = src.nelem;
+    }
+    src.pfield = (const char *) pfield;
+    if (src.nelem > src.capacity)
+        src.nelem = src.capacity;
+
+    reduceInit(&r, src.nelem > 0 ? firstValue(&src) : 0.0);
+
+    if (my->mode == MODE_ENV) {
+        long nb = src.nelem < my->nbuckets ? src.nelem : my->nbuckets;
+        long b;
+
+        for (b = 0; b < nb; b++) {
+            long start = b * src.nelem / nb;
+            long end = (b + 1) * src.nelem / nb;
+
+            reduceInit(&r, 0.0);
+            reduceRange(&src, start, end - start, &r);
+            pout[2 * b] = r.min;
+            pout[2 * b + 1] = r.max;
+        }
+        nout = 2 * nb;
+    }
+    else if (src.nelem > 0) {
+        reduceRange(&src, 0, src.nelem, &r);
+    }
+
+    if (must_lock)
+        dbScanUnlock(dbChannelRecord(chan));
+
+    /* Replace the array with the reduced data */
+    if (pfl->dtor) {
+        pfl->dtor(pfl);
+        pfl->dtor = NULL;
+    }
+    pfl->field_type = DBF_DOUBLE;
+    pfl->field_size = sizeof(epicsFloat64);
+
+    if (my->mode < MODE_ALL) {
+        pfl->type = dbfl_type_val;
+        pfl->no_elements = 1;
+        pfl->u.v.field.dbf_double = statistic(my->mode, &r);
+        return pfl;
+    }
+
+    if (my->mode == MODE_ALL) {
+        pout[0] = statistic(MODE_MEAN, &r);
+        pout[1] = statistic(MODE_STD, &r);
+        pout[2] = statistic(MODE_RMS, &r);
+        pout[3] = statistic(MODE_MIN, &r);
+        pout[4] = statistic(MODE_MAX, &r);
+        pout[5] = (double) r.n;
+        nout = ALL_COUNT;
+    }
+
+    pfl->no_elements = nout;
+    pfl->u.r.field = pout;
+    pfl->u.r.pvt = my->arrayFreeList;
+    pfl->dtor = freeArray;
+    return pfl;
+}
+
+static void channelRegisterPre(dbChannel *chan, void *pvt,
+    chPostEventFunc **cb_out, void **arg_out, db_field_log *probe)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    /* numeric array data only */
+    if (probe->no_elements <= 1 || !reduceFor(probe->field_type))
+        return;
+
+    if (my->mode == MODE_ALL) {
+        my->nout = ALL_COUNT;
+    } else if (my->mode == MODE_ENV) {
+        long nb = probe->no_elements < my->nbuckets ?
+            probe->no_elements : my->nbuckets;
+
+        my->nout = 2 * nb;
+    } else {
+        my->nout = 1;
+    }
+
+    if (my->mode >= MODE_ALL) {
+        if (!my->arrayFreeList)
+            freeListInitPvt(&my->arrayFreeList,
+                my->nout * sizeof(epicsFloat64), 2);
+        if (!my->arrayFreeList) return;
+    }
+
+    probe->field_type = DBF_DOUBLE;
+    probe->field_size = sizeof(epicsFloat64);
+    probe->no_elements = my->nout;
+    probe->type = my->nout == 1 ? dbfl_type_val : dbfl_type_ref;
+    *cb_out = filter;
+    *arg_out = pvt;
+}
+
+static void channel_report(dbChannel *chan, void *pvt, int level,
+    const unsigned short indent)
+{
+    myStruct *my = (myStruct*) pvt;
+
+    printf("%*sStatistics (stats): mode=%s", indent, "",
+           chfPluginEnumString(modeEnum, my->mode, "n/a"));
+    if (my->mode == MODE_ENV)
+        printf(", buckets=%d", my->nbuckets);
+    printf("\n");
+}
+
+static chfPluginIf pif = {
+    allocPvt,
+    freePvt,
+
+    NULL, /* parse_error, */
+    parse_ok,
+
+    NULL, /* channel_open, */
+    channelRegisterPre,
+    NULL, /* channelRegisterPost, */
+    channel_report,
+    NULL /* channel_close */
+};
+
+static void statsShutdown(void* ignore)
+{
+    if(myStructFreeList)
+        freeListCleanup(myStructFreeList);
+    myStructFreeList = NULL;
+}
+
+static void statsInitialize(void)
+{
+    if (!myStructFreeList)
+        freeListInitPvt(&myStructFreeList, sizeof(myStruct), 64);
+
+    chfPluginRegister("stats", &pif, opts);
+    epicsAtExit(statsShutdown, NULL);
+}
+
+epicsExportRegistrar(statsInitialize);
@@ -10,6 +10,8 @@
 /*  Usage
  *      {calc:{expr:"A*B", args:[{...}, ...], units:"mm"}}
  *  First link in 'args' is 'A', second is 'B', and so forth.
+ *  An input link with nelm:N reads up to N elements from each arg and
+ *  evaluates the expression element-wise, see calcPerformArray().
  */
 
 #include <string.h>
@@ -49,6 +51,7 @@ typedef struct calc_link {
         ps_prec,
         ps_units,
         ps_time,
+        ps_nelm,
         ps_error
     } pstate;
     epicsEnum16 stat;
@@ -69,6 +72,13 @@ typedef struct calc_link {
     epicsTimeStamp time;
     epicsUTag utag;
     double val;
+    /* Array calculations, nelm > 0 */
+    long nelm;
+    double *pabuf;      /* nelm elements for each arg */
+    double *pval;       /* nelm results, then nelm for alarm expressions */
+    const double *pargs[CALCPERFORM_NARGS];
+    epicsUInt32 count[CALCPERFORM_NARGS];
+    epicsUInt32 nval;
 } calc_link;
 
 static lset lnkCalc_lset;
@@ -117,6 +127,8 @@ static void lnkCalc_free(jlink *pjlink)
     free(clink->post_major);
     free(clink->post_minor);
     free(clink->units);
+    free(clink->pabuf);
+    free(clink->pval);
     free(clink);
 }
 
@@ -129,6 +141,15 @@ static jlif_result lnkCalc_integer(jlink *pjlink, long long num)
         return jlif_continue;
     }
 
+    if (clink->pstate == ps_nelm) {
+        if (num < 1 || num > 0x7fffffff / sizeof(double)) {
+            errlogPrintf("lnkCalc: Bad 'nelm' value %lld\n", num);
+            return jlif_stop;
+        }
+        clink->nelm = num;
+        return jlif_continue;
+    }
+
     if (clink->pstate != ps_args) {
         errlogPrintf("lnkCalc: Unexpected integer %lld\n", num);
         return jlif_stop;
@@ -273,6 +294,9 @@ static jlif_result lnkCalc_map_key(jlink *pjlink, const char *key, size_t len)
             clink->pstate = ps_prec;
         else if (!strncmp(key, "time", len))
             clink->pstate = ps_time;
+        else if (!strncmp(key, "nelm", len) &&
+            clink->dbfType == DBF_INLINK)
+            clink->pstate = ps_nelm;
         else {
             errlogPrintf("lnkCalc: Unknown key \"%.4s\"\n", key);
             return jlif_stop;
@@ -315,6 +339,15 @@ static jlif_result lnkCalc_end_map(jlink *pjlink)
         return jlif_stop;
     }
 
+    if (clink->nelm) {
+        clink->pabuf = calloc(clink->nelm * CALCPERFORM_NARGS, sizeof(double));
+        clink->pval = calloc(clink->nelm * 2, sizeof(double));
+        if (!clink->pabuf || !clink->pval) {
+            errlogPrintf("lnkCalc: Out of memory\n");
+            return jlif_stop;
+        }
+    }
+
     return jlif_continue;
 }
 
@@ -412,8 +445,12 @@ static void lnkCalc_report(const jlink *pjlink, int level, int indent)
             jlink *child = plink->type == JSON_LINK ?
                 plink->value.json.jlink : NULL;
 
-            printf("%*s  Input %c: %g\n", indent, "",
-                i + 'A', clink->arg[i]);
+            if (clink->nelm)
+                printf("%*s  Input %c: %u element(s)\n", indent, "",
+                    i + 'A', clink->count[i]);
+            else
+                printf("%*s  Input %c: %g\n", indent, "",
+                    i + 'A', clink->arg[i]);
 
             if (child)
                 dbJLinkReport(child, level - 1, indent + 4);
@@ -460,6 +497,20 @@ static void lnkCalc_open(struct link *plink)
         child->precord = plink->precord;
         dbJLinkInit(child);
         dbLoadLink(child, DBR_DOUBLE, &clink->arg[i]);
+
+        if (clink->nelm) {
+            double *pbuf = clink->pabuf + i * clink->nelm;
+            long nReq = clink->nelm;
+
+            /* Numeric args and args that fail to load are scalars */
+            clink->pargs[i] = &clink->arg[i];
+            clink->count[i] = 1;
+            if (child->type == JSON_LINK &&
+                !dbLoadLinkArray(child, DBR_DOUBLE, pbuf, &nReq)) {
+                clink->pargs[i] = pbuf;
+                clink->count[i] = nReq;
+            }
+        }
     }
 
     if (clink->out.type == JSON_LINK) {
@@ -490,6 +541,8 @@ static void lnkCalc_remove(struct dbLocker *locker, struct link *plink)
     free(clink->post_major);
     free(clink->post_minor);
     free(clink->units);
+    free(clink->pabuf);
+    free(clink->pval);
     free(clink);
     plink->value.json.jlink = NULL;
 }
@@ -527,7 +580,10 @@ static int lnkCalc_getDBFtype(const struct link *plink)
 
 static long lnkCalc_getElements(const struct link *plink, long *nelements)
 {
-    *nelements = 1;
+    calc_link *clink = CONTAINER(plink->value.json.jlink,
+        struct calc_link, jlink);
+
+    *nelements = clink->nelm ? clink->nelm : 1;
     return 0;
 }
 
@@ -536,13 +592,13 @@ struct lcvt {
     double *pval;
     epicsTimeStamp *ptime;
     epicsUTag *ptag;
+    long nReq;
 };
 
 static long readLocked(struct link *pinp, void *vvt)
 {
     struct lcvt *pvt = (struct lcvt *) vvt;
-    long nReq = 1;
-    long status = dbGetLink(pinp, DBR_DOUBLE, pvt->pval, NULL, &nReq);
+    long status = dbGetLink(pinp, DBR_DOUBLE, pvt->pval, NULL, &pvt->nReq);
 
     if (!status && pvt->ptime)
         dbGetTimeStampTag(pinp, pvt->ptime, pvt->ptag);
@@ -550,6 +606,124 @@ static long readLocked(struct link *pinp, void *vvt)
     return status;
 }
 
+/* Read array args and evaluate the expressions element-wise */
+static long lnkCalc_getArray(struct link *plink, short dbrType, void *pbuffer,
+    long *pnRequest)
+{
+    calc_link *clink = CONTAINER(plink->value.json.jlink,
+        struct calc_link, jlink);
+    dbCommon *prec = plink->precord;
+    long nelm = clink->nelm;
+    epicsUInt32 nres = nelm;
+    double *palarm = clink->pval + nelm;
+    int vector = 0;
+    int i;
+    long status;
+    FASTCONVERT conv = dbFastPutConvertRoutine[DBR_DOUBLE][dbrType];
+
+    /* Any link errors will trigger a LINK/INVALID alarm in the child link */
+    for (i = 0; i < clink->nArgs; i++) {
+        struct link *child = &clink->inp[i];
+        double *pbuf = clink->pabuf + i * nelm;
+        long nReq = nelm;
+
+        /* Numbers and constant links were loaded by lnkCalc_open() */
+        if (child->type != JSON_LINK || dbLinkIsConstant(child))
+            continue;
+
+        if (i == clink->tinp) {
+            struct lcvt vt = {pbuf, &clink->time, &clink->utag, nelm};
+
+            status = dbLinkDoLocked(child, readLocked, &vt);
+            if (status == S_db_noLSET)
+                status = readLocked(child, &vt);
+            nReq = vt.nReq;
+
+            if (dbLinkIsConstant(&prec->tsel) &&
+                prec->tse == epicsTimeEventDeviceTime) {
+                prec->time = clink->time;
+                prec->utag = clink->utag;
+            }
+        }
+        else
+            status = dbGetLink(child, DBR_DOUBLE, pbuf, NULL, &nReq);
+
+        if (!status) {
+            clink->pargs[i] = pbuf;
+            clink->count[i] = nReq;
+        }
+    }
+
+    /* The result is as long as the shortest array arg */
+    for (i = 0; i < clink->nArgs; i++) {
+        if (clink->count[i] != 1) {
+            vector = 1;
+            if (clink->count[i] < nres)
+                nres = clink->count[i];
+        }
+    }
+    if (!vector)
+        nres = 1;
+
+    clink->stat = 0;
+    clink->sevr = 0;
+    clink->amsg[0] = '\0';
+
+    if (clink->post_expr) {
+        long nReq = pnRequest ? *pnRequest : 1;
+
+        status = calcPerformArray(clink->pargs, clink->count, clink->pval,
+            nres, clink->post_expr);
+        clink->nval = nres;
+        clink->val = nres ? clink->pval[0] : 0.0;
+        if (nReq > nres)
+            nReq = nres;
+        for (i = 0; !status && i < nReq; i++)
+            status = conv(&clink->pval[i],
+                (char *) pbuffer + i * dbValueSize(dbrType), NULL);
+        if (!status && pnRequest)
+            *pnRequest = nReq;
+    }
+    else {
+        status = 0;
+        if (pnRequest)
+            *pnRequest = 0;
+    }
+
+    /* Alarm expressions raise the alarm if true for any element */
+    if (!status && clink->post_major) {
+        memcpy(palarm, clink->pval, nres * sizeof(double));
+        status = calcPerformArray(clink->pargs, clink->count, palarm,
+            nres, clink->post_major);
+        for (i = 0; !status && i < nres; i++) {
+            if (palarm[i]) {
+                clink->stat = LINK_ALARM;
+                clink->sevr = MAJOR_ALARM;
+                strcpy(clink->amsg, "post_major error");
+                recGblSetSevrMsg(prec, clink->stat, clink->sevr, "post_major error");
+                break;
+            }
+        }
+    }
+
+    if (!status && !clink->sevr && clink->post_minor) {
+        memcpy(palarm, clink->pval, nres * sizeof(double));
+        status = calcPerformArray(clink->pargs, clink->count, palarm,
+            nres, clink->post_minor);
+        for (i = 0; !status && i < nres; i++) {
+            if (palarm[i]) {
+                clink->stat = LINK_ALARM;
+                clink->sevr = MINOR_ALARM;
+                strcpy(clink->amsg, "post_minor error");
+                recGblSetSevrMsg(prec, clink->stat, clink->sevr, "post_minor error");
+                break;
+            }
+        }
+    }
+
+    return status;
+}
+
 static long lnkCalc_getValue(struct link *plink, short dbrType, void *pbuffer,
     long *pnRequest)
 {
@@ -563,6 +737,9 @@ static long lnkCalc_getValue(struct link *plink, short dbrType, void *pbuffer,
     if(INVALID_DB_REQ(dbrType))
         return S_db_badDbrtype;
 
+    if (clink->nelm)
+        return lnkCalc_getArray(plink, dbrType, pbuffer, pnRequest);
+
     conv = dbFastPutConvertRoutine[DBR_DOUBLE][dbrType];
 
     /* Any link errors will trigger a LINK/INVALID alarm in the child link */
@@ -571,7 +748,7 @@ static long lnkCalc_getValue(struct link *plink, short dbrType, void *pbuffer,
         long nReq = 1;
 
         if (i == clink->tinp) {
-            struct lcvt vt = {&clink->arg[i], &clink->time, &clink->utag};
+            struct lcvt vt = {&clink->arg[i], &clink->time, &clink->utag, 1};
 
             status = dbLinkDoLocked(child, readLocked, &vt);
             if (status == S_db_noLSET)
@@ -651,7 +828,7 @@ static long lnkCalc_putValue(struct link *plink, short dbrType,
         long nReq = 1;
 
         if (i == clink->tinp) {
-            struct lcvt vt = {&clink->arg[i], &clink->time, &clink->utag};
+            struct lcvt vt = {&clink->arg[i], &clink->time, &clink->utag, 1};
 
             status = dbLinkDoLocked(child, readLocked, &vt);
             if (status == S_db_noLSET)
@@ -48,7 +48,7 @@
 
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -92,6 +92,12 @@ static void convert(aiRecord *prec);
 static void monitor(aiRecord *prec);
 static long readValue(aiRecord *prec);
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct aiRecord *prec = (struct aiRecord *)pcommon;
@@ -47,7 +47,7 @@
 
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -92,6 +92,12 @@ static void convert(aoRecord *, double);
 static void monitor(aoRecord *);
 static long writeValue(aoRecord *);
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct aoRecord *prec = (struct aoRecord *)pcommon;
@@ -42,7 +42,7 @@
 
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -84,6 +84,12 @@ static void checkAlarms(biRecord *);
 static void monitor(biRecord *);
 static long readValue(biRecord *);
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct biRecord *prec = (struct biRecord *)pcommon;
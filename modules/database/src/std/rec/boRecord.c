@@ -43,7 +43,7 @@
 
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -119,6 +119,12 @@ static void myCallbackFunc(epicsCallback *arg)
     dbScanUnlock((struct dbCommon *)prec);
 }
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon,int pass)
 {
     struct boRecord *prec = (struct boRecord *)pcommon;
@@ -426,18 +426,5 @@ static void monitor(calcRecord *prec)
 
 static int fetch_values(calcRecord *prec)
 {
-    struct link *plink;
-    double *pvalue;
-    long status = 0;
-    int i;
-
-    plink = &prec->inpa;
-    pvalue = &prec->a;
-    for(i = 0; i < CALCPERFORM_NARGS; i++, plink++, pvalue++) {
-        int newStatus;
-
-        newStatus = dbGetLink(plink, DBR_DOUBLE, pvalue, 0, 0);
-        if (status == 0) status = newStatus;
-    }
-    return status;
+    return dbGetLinks(&prec->inpa, CALCPERFORM_NARGS, DBR_DOUBLE, &prec->a);
 }
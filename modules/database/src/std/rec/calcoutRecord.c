@@ -684,19 +684,7 @@ static void monitor(calcoutRecord *prec)
 
 static int fetch_values(calcoutRecord *prec)
 {
-        DBLINK  *plink; /* structure of the link field  */
-        double          *pvalue;
-        long            status = 0;
-        int             i;
-
-        for (i = 0, plink = &prec->inpa, pvalue = &prec->a; i<CALCPERFORM_NARGS;
-            i++, plink++, pvalue++) {
-            int newStatus;
-
-            newStatus = dbGetLink(plink, DBR_DOUBLE, pvalue, 0, 0);
-            if (!status) status = newStatus;
-        }
-        return(status);
+        return dbGetLinks(&prec->inpa, CALCPERFORM_NARGS, DBR_DOUBLE, &prec->a);
 }
 
 static void checkLinksCallback(epicsCallback *arg)
@@ -138,15 +138,116 @@ static void put_value(compressRecord *prec, double *psource, int n)
 }
 
 
-/* qsort comparison function (for median calculation) */
-static int compare(const void *arg1, const void *arg2)
+/* Reduction kernels for the N to 1 algorithms.  These keep four partial
+ * results so the compiler can vectorize the loops.
+ */
+static double array_min(const double *p, epicsInt32 n)
+{
+    double m0 = p[0], m1 = p[0], m2 = p[0], m3 = p[0];
+    epicsInt32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        m0 = p[i]     < m0 ? p[i]     : m0;
+        m1 = p[i + 1] < m1 ? p[i + 1] : m1;
+        m2 = p[i + 2] < m2 ? p[i + 2] : m2;
+        m3 = p[i + 3] < m3 ? p[i + 3] : m3;
+    }
+    for (; i < n; i++)
+        m0 = p[i] < m0 ? p[i] : m0;
+    m0 = m1 < m0 ? m1 : m0;
+    m2 = m3 < m2 ? m3 : m2;
+    return m2 < m0 ? m2 : m0;
+}
+
+static double array_max(const double *p, epicsInt32 n)
+{
+    double m0 = p[0], m1 = p[0], m2 = p[0], m3 = p[0];
+    epicsInt32 i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        m0 = p[i]     > m0 ? p[i]     : m0;
+        m1 = p[i + 1] > m1 ? p[i + 1] : m1;
+        m2 = p[i + 2] > m2 ? p[i + 2] : m2;
+        m3 = p[i + 3] > m3 ? p[i + 3] : m3;
+    }
+    for (; i < n; i++)
+        m0 = p[i] > m0 ? p[i] : m0;
+    m0 = m1 > m0 ? m1 : m0;
+    m2 = m3 > m2 ? m3 : m2;
+    return m2 > m0 ? m2 : m0;
+}
+
+static double array_sum(const double *p, epicsInt32 n, int squares)
 {
-    double a = *(double *)arg1;
-    double b = *(double *)arg2;
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    epicsInt32 i;
 
-    if      ( a <  b ) return -1;
-    else if ( a == b ) return  0;
-    else               return  1;
+    if (squares) {
+        for (i = 0; i + 4 <= n; i += 4) {
+            s0 += p[i]     * p[i];
+            s1 += p[i + 1] * p[i + 1];
+            s2 += p[i + 2] * p[i + 2];
+            s3 += p[i + 3] * p[i + 3];
+        }
+        for (; i < n; i++)
+            s0 += p[i] * p[i];
+    }
+    else {
+        for (i = 0; i + 4 <= n; i += 4) {
+            s0 += p[i];
+            s1 += p[i + 1];
+            s2 += p[i + 2];
+            s3 += p[i + 3];
+        }
+        for (; i < n; i++)
+            s0 += p[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+/* Return the value that would be at index k if p[0..n-1] were sorted.
+ * Partially reorders the array in place (Hoare's selection algorithm).
+ */
+static double array_select(double *p, epicsInt32 n, epicsInt32 k)
+{
+    epicsInt32 lo = 0, hi = n - 1;
+
+    while (lo < hi) {
+        double pivot = p[lo + (hi - lo) / 2];
+        epicsInt32 i = lo, j = hi;
+
+        while (i <= j) {
+            while (p[i] < pivot)
+                i++;
+            while (p[j] > pivot)
+                j--;
+            if (i <= j) {
+                double tmp = p[i];
+
+                p[i++] = p[j];
+                p[j--] = tmp;
+            }
+        }
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            break;
+    }
+    return p[k];
+}
+
+/* Index of the PCTL percentile in a sorted window of n values */
+static epicsInt32 percentile_index(compressRecord *prec, epicsInt32 n)
+{
+    double k = prec->pctl * n / 100.0;
+
+    if (!(k > 0.0))
+        return 0;
+    if (k >= n - 1)
+        return n - 1;
+    return (epicsInt32) k;
 }
 
 #define min(a, b) ((a) < (b) ? (a) : (b))
@@ -154,7 +255,6 @@ static int compare(const void *arg1, const void *arg2)
 static int compress_array(compressRecord *prec,
     double *psource, int no_elements)
 {
-    epicsInt32 j;
     epicsInt32 n, nnew;
     epicsInt32 nsam = prec->nsam;
     epicsUInt32 samples_written = 0;
@@ -183,36 +283,26 @@ static int compress_array(compressRecord *prec,
         switch (prec->alg)
         {
         case compressALG_N_to_1_Low_Value:
-            value = *psource++;
-            for (j = 1; j < n; j++, psource++)
-            {
-                if (value > *psource)
-                    value = *psource;
-            }
+            value = array_min(psource, n);
             break;
         case compressALG_N_to_1_High_Value:
-            value = *psource++;
-            for (j = 1; j < n; j++, psource++)
-            {
-                if (value < *psource)
-                    value = *psource;
-            }
+            value = array_max(psource, n);
             break;
         case compressALG_N_to_1_Average:
-            value = *psource++;
-            for (j = 1; j < n; j++, psource++)
-            {
-                value += *psource;
-            }
-            value = value / n;
+            value = array_sum(psource, n, 0) / n;
+            break;
+        case compressALG_N_to_1_RMS:
+            value = sqrt(array_sum(psource, n, 1) / n);
             break;
+        /* note: these reorder the source array (OK; it's a work pointer) */
         case compressALG_N_to_1_Median:
-            /* note: sorts source array (OK; it's a work pointer) */
-            qsort(psource, n, sizeof(double), compare);
-            value = psource[n / 2];
-            psource += n;
+            value = array_select(psource, n, n / 2);
+            break;
+        case compressALG_N_to_1_Percentile:
+            value = array_select(psource, n, percentile_index(prec, n));
             break;
         }
+        psource += n;
         nnew -= n;
         put_value(prec, &value, 1);
         samples_written++;
@@ -286,11 +376,15 @@ static int compress_scalar(struct compressRecord *prec,double *psource)
         if ((value > *pdest) || (inx == 0))
             *pdest = value;
         break;
-    /* for scalars, Median not implemented => use average */
+    /* for scalars, Median and Percentile not implemented => use average */
     case (compressALG_N_to_1_Average):
     case (compressALG_N_to_1_Median):
+    case (compressALG_N_to_1_Percentile):
         *pdest = (inx * (*pdest) + value) / (inx + 1);
         break;
+    case (compressALG_N_to_1_RMS):
+        *pdest = sqrt((inx * (*pdest) * (*pdest) + value * value) / (inx + 1));
+        break;
     }
     inx++;
     if ((inx >= prec->n) || (prec->pbuf == menuYesNoYES)) {
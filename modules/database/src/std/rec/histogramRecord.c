@@ -24,6 +24,7 @@
 
 #include "dbDefs.h"
 #include "epicsPrint.h"
+#include "epicsMath.h"
 #include "alarm.h"
 #include "callback.h"
 #include "dbAccess.h"
@@ -94,7 +95,7 @@ typedef struct myCallback {
     histogramRecord *prec;
 } myCallback;
 
-static long add_count(histogramRecord *);
+static long add_count(histogramRecord *, const double *psamp, epicsUInt32 nsamp);
 static long clear_histogram(histogramRecord *);
 static void monitor(histogramRecord *);
 static long readValue(histogramRecord *);
@@ -160,6 +161,12 @@ static long init_record(struct dbCommon *pcommon, int pass)
             prec->bptr = calloc(prec->nelm, sizeof(epicsUInt32));
         }
 
+        /* allocate space for array input samples */
+        if (prec->nsam > 1 && !prec->sptr)
+            prec->sptr = calloc(prec->nsam, sizeof(double));
+        if (!prec->sptr)
+            prec->nsam = 1;
+
         /* calculate width of array element */
         prec->wdth = (prec->ulim - prec->llim) / prec->nelm;
         return 0;
@@ -215,8 +222,12 @@ static long process(struct dbCommon *pcommon)
 
     recGblGetTimeStampSimm(prec, prec->simm, &prec->siol);
 
-    if (status == 0)
-        add_count(prec);
+    if (status == 0) {
+        if (prec->nsam > 1)
+            add_count(prec, prec->sptr, prec->nord);
+        else
+            add_count(prec, &prec->sgnl, 1);
+    }
     else if (status == 2)
         status = 0;
 
@@ -260,7 +271,7 @@ static long special(DBADDR *paddr, int after)
 
     case SPC_MOD:
         /* increment frequency in histogram array */
-        add_count(prec);
+        add_count(prec, &prec->sgnl, 1);
         return 0;
 
     case SPC_RESET:
@@ -290,9 +301,18 @@ static void monitor(histogramRecord *prec)
         prec->mcnt = 0;
     }
     /* send out monitors connected to the value field */
-    if (monitor_mask)
+    if (monitor_mask) {
         db_post_events(prec, (void*)&prec->val, monitor_mask);
 
+        if (prec->rsts == menuYesNoYES) {
+            db_post_events(prec, &prec->scnt, monitor_mask);
+            db_post_events(prec, &prec->mean, monitor_mask);
+            db_post_events(prec, &prec->rms, monitor_mask);
+            db_post_events(prec, &prec->smin, monitor_mask);
+            db_post_events(prec, &prec->smax, monitor_mask);
+        }
+    }
+
     return;
 }
 
@@ -317,11 +337,20 @@ static long get_array_info(DBADDR *paddr, long *no_elements, long *offset)
     return 0;
 }
 
-static long add_count(histogramRecord *prec)
+/* Bin nsamp signal values.  The bin is found arithmetically; as for the
+ * original linear search each bin includes its upper edge.  Running
+ * statistics, if enabled, are accumulated over all values in the same pass.
+ */
+static long add_count(histogramRecord *prec, const double *psamp,
+    epicsUInt32 nsamp)
 {
-    double temp;
-    epicsUInt32 *pdest;
-    int i;
+    epicsUInt32 *pbins = prec->bptr;
+    const double llim = prec->llim;
+    const double ulim = prec->ulim;
+    const double wdth = prec->wdth;
+    const double scale = prec->nelm / (ulim - llim);
+    const long last = prec->nelm - 1;
+    epicsUInt32 i, nadded = 0;
 
     if (prec->csta == FALSE)
         return 0;
@@ -333,20 +362,65 @@ static long add_count(histogramRecord *prec)
             return -1;
         }
     }
-    if (prec->sgnl < prec->llim ||
-        prec->sgnl >= prec->ulim)
-        return 0;
 
-    temp = prec->sgnl - prec->llim;
-    for (i = 1; i <= prec->nelm; i++){
-        if (temp <= (double) i * prec->wdth)
-            break;
+    for (i = 0; i < nsamp; i++) {
+        const double temp = psamp[i] - llim;
+        long bin;
+
+        /* also rejects NaN */
+        if (!(psamp[i] >= llim && psamp[i] < ulim))
+            continue;
+
+        /* The estimate may be a bin out either way from rounding, bin b
+         * holds b*wdth < temp <= (b+1)*wdth, and bin 0 also temp == 0
+         */
+        bin = (long) (temp * scale);
+        if (bin > last)
+            bin = last;
+        while (bin > 0 && temp <= bin * wdth)
+            bin--;
+        while (bin < last && temp > (bin + 1) * wdth)
+            bin++;
+
+        if (pbins[bin] == (epicsUInt32) UINT_MAX)
+            pbins[bin] = 0;
+        pbins[bin]++;
+        nadded++;
+    }
+
+    if (nadded > (epicsUInt32) (SHRT_MAX - prec->mcnt))
+        prec->mcnt = SHRT_MAX;
+    else
+        prec->mcnt += nadded;
+
+    if (prec->rsts == menuYesNoYES) {
+        double sum = prec->ssum, sumsq = prec->sssq;
+        double smin = prec->smin, smax = prec->smax;
+        epicsUInt64 scnt = prec->scnt;
+
+        for (i = 0; i < nsamp; i++) {
+            const double val = psamp[i];
+
+            if (isnan(val))
+                continue;
+            if (scnt == 0 || val < smin)
+                smin = val;
+            if (scnt == 0 || val > smax)
+                smax = val;
+            sum += val;
+            sumsq += val * val;
+            scnt++;
+        }
+        if (scnt) {
+            prec->ssum = sum;
+            prec->sssq = sumsq;
+            prec->smin = smin;
+            prec->smax = smax;
+            prec->scnt = scnt;
+            prec->mean = sum / scnt;
+            prec->rms = sqrt(sumsq / scnt);
+        }
     }
-    pdest = prec->bptr + i - 1;
-    if (*pdest == (epicsUInt32) UINT_MAX)
-        *pdest = 0;
-    (*pdest)++;
-    prec->mcnt++;
 
     return 0;
 }
@@ -357,6 +431,10 @@ static long clear_histogram(histogramRecord *prec)
 
     for (i = 0; i < prec->nelm; i++)
         prec->bptr[i] = 0;
+    prec->scnt = 0;
+    prec->ssum = prec->sssq = 0.0;
+    prec->mean = prec->rms = 0.0;
+    prec->smin = prec->smax = 0.0;
     prec->mcnt = prec->mdel + 1;
     prec->udf = FALSE;
 
@@ -381,10 +459,23 @@ static long readValue(histogramRecord *prec)
     case menuYesNoYES: {
         recGblSetSevr(prec, SIMM_ALARM, prec->sims);
         if (prec->pact || (prec->sdly < 0.)) {
-            status = dbGetLink(&prec->siol, DBR_DOUBLE, &prec->sval, 0, 0);
-            if (status == 0) {
-                prec->sgnl = prec->sval;
-                prec->udf = FALSE;
+            if (prec->nsam > 1) {
+                long nRequest = prec->nsam;
+
+                status = dbGetLink(&prec->siol, DBR_DOUBLE, prec->sptr, 0, &nRequest);
+                if (status == 0) {
+                    prec->nord = nRequest;
+                    if (nRequest > 0)
+                        prec->sgnl = prec->sval = prec->sptr[nRequest - 1];
+                    prec->udf = FALSE;
+                }
+            }
+            else {
+                status = dbGetLink(&prec->siol, DBR_DOUBLE, &prec->sval, 0, 0);
+                if (status == 0) {
+                    prec->sgnl = prec->sval;
+                    prec->udf = FALSE;
+                }
             }
             prec->pact = FALSE;
         } else { /* !prec->pact && delay >= 0. */
@@ -426,6 +517,10 @@ static long get_precision(const DBADDR *paddr,long *precision)
         case indexof(SGNL):
         case indexof(SVAL):
         case indexof(WDTH):
+        case indexof(MEAN):
+        case indexof(RMS):
+        case indexof(SMIN):
+        case indexof(SMAX):
             *precision = prec->prec;
             break;
         case indexof(SDEL):
@@ -45,7 +45,7 @@
 #define THRESHOLD 0.6321
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -89,6 +89,12 @@ static void monitor(longinRecord *prec);
 static long readValue(longinRecord *prec);
 
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct longinRecord *prec = (struct longinRecord *)pcommon;
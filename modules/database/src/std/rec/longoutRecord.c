@@ -42,7 +42,7 @@
 
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -90,6 +90,12 @@ static long writeValue(longoutRecord *prec);
 static void convert(longoutRecord *prec, epicsInt32 value);
 static long conditional_write(longoutRecord *prec);
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct longoutRecord *prec = (struct longoutRecord *)pcommon;
@@ -45,7 +45,7 @@
 
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -104,6 +104,12 @@ static void init_common(mbbiRecord *prec)
     prec->sdef = FALSE;
 }
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct mbbiRecord *prec = (struct mbbiRecord *)pcommon;
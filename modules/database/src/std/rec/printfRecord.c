@@ -13,12 +13,14 @@
  */
 
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "dbDefs.h"
 #include "errlog.h"
 #include "alarm.h"
 #include "cantProceed.h"
+#include "cvtFast.h"
 #include "dbAccess.h"
 #include "dbEvent.h"
 #include "dbFldTypes.h"
@@ -43,19 +45,243 @@
 #define F_BADFMT 0x40
 #define F_BADLNK 0x80
 #define F_BAD (F_BADFMT | F_BADLNK)
+#define F_WSTAR 0x100
+#define F_PSTAR 0x200
 
-#define GET_PRINT(VALTYPE, DBRTYPE) \
-    VALTYPE val; \
-    int ok; \
-\
-    if (dbLinkIsConstant(plink)) \
-        ok = recGblInitConstantLink(plink++, DBRTYPE, &val); \
-    else \
-        ok = ! dbGetLink(plink++, DBRTYPE, &val, 0, 0); \
-    if (ok) \
-        added = epicsSnprintf(pval, vspace + 1, format, val); \
-    else \
-        flags |= F_BADLNK
+/* Format plan step operations */
+#define OP_TEXT 0   /* Copy literal text */
+#define OP_CONV 1   /* Convert a value read from the next input link */
+#define OP_BAD  2   /* Copy an invalid format directive */
+
+/* The FMT string is parsed into a plan when it is set.  Each step of
+ * the plan is a run of literal text or one format directive, with the
+ * DBR type to be read from its input link already worked out.
+ */
+typedef struct printfStep {
+    char op;            /* OP_TEXT, OP_CONV or OP_BAD */
+    char conv;          /* Conversion character */
+    char fast;          /* Plain %d, %i, %u or %s, done without printf */
+    char nstar;         /* Number of '*' width and precision links */
+    int flags;
+    short dbrType;      /* DBR type of the value link */
+    short linkn;        /* Index of the first input link used */
+    int width;          /* Literal width and precision */
+    int precision;
+    const char *text;   /* OP_TEXT only */
+    size_t len;
+    char format[20];    /* The directive, with any '*' kept */
+} printfStep;
+
+typedef struct printfPlan {
+    char fmt[sizeof(((printfRecord *) 0)->fmt)];
+    int nsteps;
+    printfStep step[1];
+} printfPlan;
+
+/* Parse the directive at *ppfmt into step.
+ * Returns 0 if the format string ended before the conversion character.
+ */
+static int parseDirective(printfStep *step, const char **ppfmt, int *plinkn)
+{
+    const char *pfmt = *ppfmt;
+    char *pformat = step->format;
+    char *pend = step->format + sizeof(step->format) - 1;
+    int *pnum = &step->width;
+    int flags = 0;
+    int cont = 1;
+    int ch = 0;
+
+    /* The directive parsing here is not comprehensive, in most cases
+     * we just copy it into format[] and let epicsSnprintf() do all the
+     * work.  A '*' width or precision is kept in the format and read
+     * from the next input link when the record processes.  We convert
+     * %ls (long string) directives ourself, so we need to know the
+     * width, precision and justification.
+     */
+
+    *pformat++ = *pfmt++; /* '%' */
+    while (cont && (ch = *pfmt++)) {
+        if (pformat < pend)
+            *pformat++ = ch;
+        else
+            flags |= F_BADFMT;
+        switch (ch) {
+        case '+': case ' ': case '#':
+            break;
+        case '-':
+            flags |= F_LEFT;
+            break;
+        case '.':
+            pnum = &step->precision;
+            break;
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            if (flags & (pnum == &step->width ? F_WSTAR : F_PSTAR))
+                flags |= F_BADFMT;
+            *pnum = *pnum * 10 + ch - '0';
+            break;
+        case '*':
+            if (*pnum || flags & (pnum == &step->width ? F_WSTAR : F_PSTAR))
+                flags |= F_BADFMT;
+            else {
+                flags |= pnum == &step->width ? F_WSTAR : F_PSTAR;
+                step->nstar++;
+            }
+            break;
+        case 'h':
+            if (flags & (F_LONGLONG | F_LONG | F_CHAR))
+                flags |= F_BADFMT;
+            else if (flags & F_SHORT)
+                flags = (flags & ~F_SHORT) | F_CHAR;
+            else
+                flags |= F_SHORT;
+            break;
+        case 'l':
+            if (flags & (F_LONGLONG | F_SHORT | F_CHAR))
+                flags |= F_BADFMT;
+            else if (flags & F_LONG)
+                flags = (flags & ~F_LONG) | F_LONGLONG;
+            else
+                flags |= F_LONG;
+            break;
+        default:
+            if (strchr("diouxXeEfFgGcs%", ch) == NULL)
+                flags |= F_BADFMT;
+            cont = 0;
+            break;
+        }
+    }
+    if (!ch)        /* End of format string */
+        return 0;
+
+    *pformat = 0;   /* Terminate our format string */
+    *ppfmt = pfmt;
+
+    step->conv = ch;
+    step->flags = flags;
+    step->linkn = *plinkn;
+    *plinkn += step->nstar;
+
+    if (flags & F_BADFMT) {
+        step->op = OP_BAD;
+        return 1;
+    }
+
+    if (ch == '%') {
+        if (pformat - step->format == 2) {
+            step->op = OP_TEXT;
+            step->text = "%";
+            step->len = 1;
+        }
+        else
+            step->op = OP_CONV;
+        return 1;
+    }
+
+    step->op = OP_CONV;
+    (*plinkn)++;
+
+    switch (ch) { /* Conversion character */
+    case 'c': case 'd': case 'i':
+        if (ch == 'c' || flags & F_CHAR)
+            step->dbrType = DBR_CHAR;
+        else if (flags & F_SHORT)
+            step->dbrType = DBR_SHORT;
+        else if (flags & F_LONGLONG)
+            step->dbrType = DBR_INT64;
+        else /* F_LONG has no real effect */
+            step->dbrType = DBR_LONG;
+        break;
+
+    case 'o': case 'x': case 'X': case 'u':
+        if (flags & F_CHAR)
+            step->dbrType = DBR_UCHAR;
+        else if (flags & F_SHORT)
+            step->dbrType = DBR_USHORT;
+        else if (flags & F_LONGLONG)
+            step->dbrType = DBR_UINT64;
+        else /* F_LONG has no real effect */
+            step->dbrType = DBR_ULONG;
+        break;
+
+    case 'e': case 'E':
+    case 'f': case 'F':
+    case 'g': case 'G':
+        if (flags & F_SHORT)
+            step->dbrType = DBR_FLOAT;
+        else
+            step->dbrType = DBR_DOUBLE;
+        break;
+
+    case 's':
+        step->dbrType = flags & F_LONG ? DBR_CHAR : DBR_STRING;
+        break;
+    }
+
+    /* No flags, width or precision, just length modifiers */
+    if (strspn(step->format + 1, "hl") == strlen(step->format) - 2) {
+        if (ch == 'd' || ch == 'i' || ch == 'u')
+            step->fast = 1;
+        else if (ch == 's' && !(flags & F_LONG))
+            step->fast = 1;
+    }
+    return 1;
+}
+
+static void compileFormat(printfRecord *prec)
+{
+    size_t len = strlen(prec->fmt);
+    printfPlan *plan = callocMustSucceed(1,
+        sizeof(printfPlan) + len * sizeof(printfStep),
+        "printf::compileFormat");
+    printfStep *step = plan->step;
+    const char *pfmt = plan->fmt;
+    int linkn = 0;
+
+    strcpy(plan->fmt, prec->fmt);
+
+    while (*pfmt) {
+        if (*pfmt != '%') {
+            /* Literal text is copied directly into prec->val */
+            step->op = OP_TEXT;
+            step->text = pfmt;
+            while (*pfmt && *pfmt != '%')
+                pfmt++;
+            step->len = pfmt - step->text;
+        }
+        else if (!parseDirective(step, &pfmt, &linkn))
+            break;
+        step++;
+    }
+    plan->nsteps = step - plan->step;
+
+    free(prec->fpln);
+    prec->fpln = plan;
+}
+
+static int getValue(DBLINK *plink, short dbrType, void *pval)
+{
+    if (dbLinkIsConstant(plink))
+        return recGblInitConstantLink(plink, dbrType, pval);
+    return ! dbGetLink(plink, dbrType, pval, 0, 0);
+}
+
+/* Copy what fits of a converted string, return its full length */
+static int putText(char *pval, int vspace, const char *text, size_t len)
+{
+    memcpy(pval, text, len < (size_t) vspace ? len : (size_t) vspace);
+    return len;
+}
+
+#define PRINT(VAL) \
+    switch (step->nstar) { \
+    case 0: \
+        return epicsSnprintf(pval, vspace + 1, step->format, VAL); \
+    case 1: \
+        return epicsSnprintf(pval, vspace + 1, step->format, star[0], VAL); \
+    default: \
+        return epicsSnprintf(pval, vspace + 1, step->format, star[0], star[1], VAL); \
+    }
 
 #ifdef __GNUC__
 #  pragma GCC diagnostic push
@@ -65,267 +291,193 @@
  */
 #endif
 
-static void doPrintf(printfRecord *prec)
+/* Make one conversion into pval.
+ * Returns the number of characters wanted, or -1 for a bad link.
+ */
+static int doConversion(printfRecord *prec, const printfStep *step,
+    char *pval, int vspace)
 {
-    const char *pfmt = prec->fmt;
-    DBLINK *plink = &prec->inp0;
-    int linkn = 0;
-    char *pval = prec->val;
-    int vspace = prec->sizv - 1;
-    int ch;
+    DBLINK *plink = &prec->inp0 + step->linkn;
+    int width = step->width;
+    int precision = step->precision;
+    int star[2] = {0, 0};
+    int i;
+    union {
+        epicsInt8 i8;
+        epicsUInt8 u8;
+        epicsInt16 i16;
+        epicsUInt16 u16;
+        epicsInt32 i32;
+        epicsUInt32 u32;
+        epicsInt64 i64;
+        epicsUInt64 u64;
+        epicsFloat32 f32;
+        epicsFloat64 f64;
+        char str[MAX_STRING_SIZE];
+    } val;
+    char digits[24];
+
+    if (step->linkn + step->nstar + (step->conv != '%') > PRINTF_NLINKS)
+        return -1;  /* No more LNKn fields */
+
+    for (i = 0; i < step->nstar; i++) {
+        epicsInt16 num;
+
+        if (!getValue(plink++, DBR_SHORT, &num))
+            return -1;
+        star[i] = num;
+    }
+    if (step->flags & F_WSTAR)
+        width = star[0];
+    if (step->flags & F_PSTAR)
+        precision = star[step->nstar - 1];
 
-    while (vspace > 0 && (ch = *pfmt++)) {
-        if (ch != '%') {
-            /* Copy literal strings directly into prec->val */
-            *pval++ = ch;
-            --vspace;
+    if (step->conv == '%') {
+        PRINT(0);
+    }
+
+    if (step->conv == 's' && step->flags & F_LONG) {
+        long n = vspace + 1;
+        long status;
+        int added, padding, left = step->flags & F_LEFT;
+
+        if (width < 0) {
+            width = -width;
+            left = 1;
         }
-        else {
-            char format[20];
-            char *pformat = format;
-            int width = 0;
-            int precision = 0;
-            int *pnum = &width;
-            int flags = 0;
-            int added = 0;
-            int cont = 1;
-
-            /* The format directive parsing here is not comprehensive,
-             * in most cases we just copy each directive into format[]
-             * and get epicsSnprintf() do all the work.  We do replace
-             * all variable-length field width or precision '*' chars
-             * with an integer read from the next input link, and we
-             * also convert %ls (long string) directives ourself, so
-             * we need to know the width, precision and justification.
+        if (precision < 0)
+            precision = 0;
+
+        if (precision && n > precision)
+            n = precision + 1;
+            /* If set, precision is the maximum number of
+             * characters to be printed from the string.
+             * It does not limit the field width however.
              */
+        if (dbLinkIsConstant(plink)) {
+            epicsUInt32 len = n;
+            status = dbLoadLinkLS(plink, pval, n, &len);
+            n = len;
+        }
+        else
+            status = dbGetLink(plink, DBR_CHAR, pval, 0, &n);
+        if (status)
+            return -1;
+
+        /* Terminate string and measure its length */
+        pval[n] = 0;
+        added = strlen(pval);
+        padding = width - added;
+
+        if (padding > 0) {
+            if (left) {
+                /* add spaces on RHS */
+                if (width > vspace)
+                    padding = vspace - added;
+                memset(pval + added, ' ', padding);
+            }
+            else {
+                /* insert spaces on LHS */
+                int trunc = width - vspace;
 
-            *pformat++ = ch; /* '%' */
-            while (cont && (ch = *pfmt++)) {
-                *pformat++ = ch;
-                switch (ch) {
-                case '+': case ' ': case '#':
-                    break;
-                case '-':
-                    flags |= F_LEFT;
-                    break;
-                case '.':
-                    pnum = &precision;
-                    break;
-                case '0': case '1': case '2': case '3': case '4':
-                case '5': case '6': case '7': case '8': case '9':
-                    *pnum = *pnum * 10 + ch - '0';
-                    break;
-                case '*':
-                    if (*pnum) {
-                        flags |= F_BADFMT;
-                    }
-                    else if (linkn++ < PRINTF_NLINKS) {
-                        epicsInt16 i;
-                        int ok;
-
-                        if (dbLinkIsConstant(plink))
-                            ok = recGblInitConstantLink(plink++, DBR_SHORT, &i);
-                        else
-                            ok = ! dbGetLink(plink++, DBR_SHORT, &i, 0, 0);
-                        if (ok) {
-                            *pnum = i;
-                            added = epicsSnprintf(--pformat, 6, "%d", i);
-                            pformat += added;
-                        }
-                        else /* No more LNKn fields */
-                            flags |= F_BADLNK;
-                    }
-                    else
-                        flags |= F_BADLNK;
-                    break;
-                case 'h':
-                    if (flags & (F_LONGLONG | F_LONG | F_CHAR))
-                        flags |= F_BADFMT;
-                    else if (flags & F_SHORT)
-                        flags = (flags & ~F_SHORT) | F_CHAR;
-                    else
-                        flags |= F_SHORT;
-                    break;
-                case 'l':
-                    if (flags & (F_LONGLONG | F_SHORT | F_CHAR))
-                        flags |= F_BADFMT;
-                    else if (flags & F_LONG)
-                        flags = (flags & ~F_LONG) | F_LONGLONG;
-                    else
-                        flags |= F_LONG;
-                    break;
-                default:
-                    if (strchr("diouxXeEfFgGcs%", ch) == NULL)
-                        flags |= F_BADFMT;
-                    cont = 0;
-                    break;
+                if (trunc < added) {
+                    added -= trunc;
+                    memmove(pval + padding, pval, added);
+                }
+                else {
+                    padding = vspace;
+                    added = 0;
                 }
+                memset(pval, ' ', padding);
             }
-            if (!ch)        /* End of format string */
-                break;
+            added += padding;
+        }
+        return added;
+    }
 
-            if (flags & F_BAD)
-                goto bad_format;
+    if (!getValue(plink, step->dbrType, &val))
+        return -1;
+
+    if (step->fast) {
+        switch (step->dbrType) {
+        case DBR_STRING:
+            val.str[MAX_STRING_SIZE - 1] = 0;
+            return putText(pval, vspace, val.str, strlen(val.str));
+        case DBR_CHAR:
+            return putText(pval, vspace, digits, cvtInt32ToString(val.i8, digits));
+        case DBR_UCHAR:
+            return putText(pval, vspace, digits, cvtUInt32ToString(val.u8, digits));
+        case DBR_SHORT:
+            return putText(pval, vspace, digits, cvtInt32ToString(val.i16, digits));
+        case DBR_USHORT:
+            return putText(pval, vspace, digits, cvtUInt32ToString(val.u16, digits));
+        case DBR_LONG:
+            return putText(pval, vspace, digits, cvtInt32ToString(val.i32, digits));
+        case DBR_ULONG:
+            return putText(pval, vspace, digits, cvtUInt32ToString(val.u32, digits));
+        case DBR_INT64:
+            return putText(pval, vspace, digits, cvtInt64ToString(val.i64, digits));
+        case DBR_UINT64:
+            return putText(pval, vspace, digits, cvtUInt64ToString(val.u64, digits));
+        }
+    }
 
-            *pformat = 0;   /* Terminate our format string */
+    switch (step->dbrType) {
+    case DBR_CHAR:   PRINT(val.i8);
+    case DBR_UCHAR:  PRINT(val.u8);
+    case DBR_SHORT:  PRINT(val.i16);
+    case DBR_USHORT: PRINT(val.u16);
+    case DBR_LONG:   PRINT(val.i32);
+    case DBR_ULONG:  PRINT(val.u32);
+    case DBR_INT64:  PRINT(val.i64);
+    case DBR_UINT64: PRINT(val.u64);
+    case DBR_FLOAT:  PRINT(val.f32);
+    case DBR_DOUBLE: PRINT(val.f64);
+    case DBR_STRING: PRINT(val.str);
+    }
+    errlogPrintf("printfRecord: Unexpected conversion '%s'\n", step->format);
+    return -1;
+}
 
-            if (width < 0) {
-                width = -width;
-                flags |= F_LEFT;
-            }
-            if (precision < 0)
-                precision = 0;
+#ifdef __GNUC__
+#  pragma GCC diagnostic pop
+#endif
 
-            if (ch == '%') {
-                added = epicsSnprintf(pval, vspace + 1, format);
-            }
-            else if (linkn++ >= PRINTF_NLINKS) {
-                /* No more LNKn fields */
-                flags |= F_BADLNK;
-            }
-            else
-                switch (ch) { /* Conversion character */
-                case 'c': case 'd': case 'i':
-                    if (ch == 'c' || flags & F_CHAR) {
-                        GET_PRINT(epicsInt8, DBR_CHAR);
-                    }
-                    else if (flags & F_SHORT) {
-                        GET_PRINT(epicsInt16, DBR_SHORT);
-                    }
-                    else if (flags & F_LONGLONG) {
-                        GET_PRINT(epicsInt64, DBR_INT64);
-                    }
-                    else { /* F_LONG has no real effect */
-                        GET_PRINT(epicsInt32, DBR_LONG);
-                    }
-                    break;
-
-                case 'o': case 'x': case 'X': case 'u':
-                    if (flags & F_CHAR) {
-                        GET_PRINT(epicsUInt8, DBR_UCHAR);
-                    }
-                    else if (flags & F_SHORT) {
-                        GET_PRINT(epicsUInt16, DBR_USHORT);
-                    }
-                    else if (flags & F_LONGLONG) {
-                        GET_PRINT(epicsUInt64, DBR_UINT64);
-                    }
-                    else { /* F_LONG has no real effect */
-                        GET_PRINT(epicsUInt32, DBR_ULONG);
-                    }
-                    break;
-
-                case 'e': case 'E':
-                case 'f': case 'F':
-                case 'g': case 'G':
-                    if (flags & F_SHORT) {
-                        GET_PRINT(epicsFloat32, DBR_FLOAT);
-                    }
-                    else {
-                        GET_PRINT(epicsFloat64, DBR_DOUBLE);
-                    }
-                    break;
-
-                case 's':
-                    if (flags & F_LONG) {
-                        long n = vspace + 1;
-                        long status;
-
-                        if (precision && n > precision)
-                            n = precision + 1;
-                            /* If set, precision is the maximum number of
-                             * characters to be printed from the string.
-                             * It does not limit the field width however.
-                             */
-                        if (dbLinkIsConstant(plink)) {
-                            epicsUInt32 len = n;
-                            status = dbLoadLinkLS(plink++, pval, n, &len);
-                            n = len;
-                        }
-                        else
-                            status = dbGetLink(plink++, DBR_CHAR, pval, 0, &n);
-                        if (status)
-                            flags |= F_BADLNK;
-                        else {
-                            int padding;
-
-                            /* Terminate string and measure its length */
-                            pval[n] = 0;
-                            added = strlen(pval);
-                            padding = width - added;
-
-                            if (padding > 0) {
-                                if (flags & F_LEFT) {
-                                    /* add spaces on RHS */
-                                    if (width > vspace)
-                                        padding = vspace - added;
-                                    memset(pval + added, ' ', padding);
-                                }
-                                else {
-                                    /* insert spaces on LHS */
-                                    int trunc = width - vspace;
-
-                                    if (trunc < added) {
-                                        added -= trunc;
-                                        memmove(pval + padding, pval, added);
-                                    }
-                                    else {
-                                        padding = vspace;
-                                        added = 0;
-                                    }
-                                    memset(pval, ' ', padding);
-                                }
-                                added += padding;
-                            }
-                        }
-                    }
-                    else {
-                        char val[MAX_STRING_SIZE];
-                        int ok;
-
-                        if (dbLinkIsConstant(plink))
-                            ok = recGblInitConstantLink(plink++, DBR_STRING, val);
-                        else
-                            ok = ! dbGetLink(plink++, DBR_STRING, val, 0, 0);
-                        if (ok)
-                            added = epicsSnprintf(pval, vspace + 1, format, val);
-                        else
-                            flags |= F_BADLNK;
-                    }
-                    break;
-
-                default:
-                    errlogPrintf("printfRecord: Unexpected conversion '%s'\n",
-                        format);
-                    flags |= F_BADFMT;
-                    break;
-                }
+static void doPrintf(printfRecord *prec)
+{
+    const printfPlan *plan = (const printfPlan *) prec->fpln;
+    const printfStep *step = plan->step;
+    const printfStep *end = step + plan->nsteps;
+    char *pval = prec->val;
+    int vspace = prec->sizv - 1;
 
-            if (flags & F_BAD) {
-    bad_format:
-                added = epicsSnprintf(pval, vspace + 1, "%s",
-                    flags & F_BADLNK ? prec->ivls : format);
-            }
+    for (; vspace > 0 && step < end; step++) {
+        int added;
 
-            if (added <= vspace) {
-                pval += added;
-                vspace -= added;
-            }
-            else {
-                /* Output was truncated */
-                pval += vspace;
-                vspace = 0;
-            }
+        if (step->op == OP_TEXT)
+            added = putText(pval, vspace, step->text, step->len);
+        else if (step->op == OP_BAD)
+            added = epicsSnprintf(pval, vspace + 1, "%s", step->format);
+        else {
+            added = doConversion(prec, step, pval, vspace);
+            if (added < 0)
+                added = epicsSnprintf(pval, vspace + 1, "%s", prec->ivls);
+        }
+
+        if (added <= vspace) {
+            pval += added;
+            vspace -= added;
+        }
+        else {
+            /* Output was truncated */
+            pval += vspace;
+            vspace = 0;
         }
     }
     *pval++ = 0;  /* Terminate the VAL string */
     prec->len = pval - prec->val;
 }
 
-#ifdef __GNUC__
-#  pragma GCC diagnostic pop
-#endif
-
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct printfRecord *prec = (struct printfRecord *)pcommon;
@@ -344,6 +496,7 @@ static long init_record(struct dbCommon *pcommon, int pass)
 
         prec->val = callocMustSucceed(1, sizv, "printf::init_record");
         prec->len = 0;
+        compileFormat(prec);
         return 0;
     }
 
@@ -405,6 +558,15 @@ static long process(struct dbCommon *pcommon)
     return status;
 }
 
+static long special(DBADDR *paddr, int after)
+{
+    printfRecord *prec = (printfRecord *)paddr->precord;
+
+    if (after && dbGetFieldIndex(paddr) == printfRecordFMT)
+        compileFormat(prec);
+    return 0;
+}
+
 static long cvt_dbaddr(DBADDR *paddr)
 {
     printfRecord *prec = (printfRecord *)paddr->precord;
@@ -439,7 +601,7 @@ static long get_array_info(DBADDR *paddr, long *no_elements, long *offset)
 #define initialize NULL
 /* init_record */
 /* process */
-#define special NULL
+/* special */
 #define get_value NULL
 /* cvt_dbaddr */
 /* get_array_info */
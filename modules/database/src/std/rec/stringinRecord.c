@@ -42,7 +42,7 @@
 
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -85,6 +85,12 @@ static void monitor(stringinRecord *);
 static long readValue(stringinRecord *);
 
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct stringinRecord *prec = (struct stringinRecord *)pcommon;
@@ -44,7 +44,7 @@
 
 /* Create RSET - Record Support Entry Table*/
 #define report NULL
-#define initialize NULL
+static long initialize(void);
 static long init_record(struct dbCommon *, int);
 static long process(struct dbCommon *);
 static long special(DBADDR *, int);
@@ -87,6 +87,12 @@ static void monitor(stringoutRecord *);
 static long writeValue(stringoutRecord *);
 
 
+static long initialize(void)
+{
+    recThreadSafeInit();
+    return 0;
+}
+
 static long init_record(struct dbCommon *pcommon, int pass)
 {
     struct stringoutRecord *prec = (struct stringoutRecord *)pcommon;
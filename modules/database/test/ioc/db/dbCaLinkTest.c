@@ -37,6 +37,7 @@ epicsShareExtern short epicsShareAPI ca_field_type (chid chan);
 #define MAX_UNITS_SIZE          8
 
 #include "dbCaPvt.h"
+#include "dbCaTest.h"
 #include "errlog.h"
 #include "testMain.h"
 
@@ -610,9 +611,86 @@ static void testCAC(void)
     free(buftarg2);
 }
 
+static void testWorkers(void)
+{
+    enum {nLinks = 8, nWorkers = 3};
+    int chans[nWorkers], discon[nWorkers];
+    int total = 0, ndiscon = 0, used = 0;
+    unsigned i;
+
+    testDiag("Links shared between several dbCa workers");
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    for (i = 0; i < nLinks; i++) {
+        char macros[8];
+
+        epicsSnprintf(macros, sizeof(macros), "N=%u", i);
+        testdbReadDatabase("dbCaLinkWorkers.db", NULL, macros);
+    }
+
+    dbCaLinkWorkers = nWorkers;
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    for (i = 0; i < nLinks; i++) {
+        char name[16];
+        xRecord *psrc;
+
+        epicsSnprintf(name, sizeof(name), "source%u", i);
+        psrc = (xRecord*)testdbRecordPtr(name);
+        testdbCaWaitForConnect(&psrc->lnk);
+    }
+
+    testOk(dbcaWorkerStats(nWorkers, chans, discon) == nWorkers,
+        "%d dbCa workers", nWorkers);
+    for (i = 0; i < nWorkers; i++) {
+        total += chans[i];
+        ndiscon += discon[i];
+        used += chans[i] > 0;
+    }
+    testOk(total == nLinks && ndiscon == 0,
+        "%d links, %d disconnected", total, ndiscon);
+    testOk(used > 1, "Links use %d workers", used);
+
+    for (i = 0; i < nLinks; i++) {
+        char name[16];
+        xRecord *psrc;
+        epicsInt32 val = 100 + i;
+
+        epicsSnprintf(name, sizeof(name), "source%u", i);
+        psrc = (xRecord*)testdbRecordPtr(name);
+        dbScanLock((dbCommon*)psrc);
+        dbPutLink(&psrc->lnk, DBR_LONG, &val, 1);
+        dbScanUnlock((dbCommon*)psrc);
+    }
+    dbCaSync();
+
+    for (i = 0; i < nLinks; i++) {
+        char name[16];
+        xRecord *ptarg;
+
+        epicsSnprintf(name, sizeof(name), "target%u", i);
+        ptarg = (xRecord*)testdbRecordPtr(name);
+        dbScanLock((dbCommon*)ptarg);
+        testOk(ptarg->val == 100 + i, "%s.VAL == %d (got %d)",
+            name, 100 + i, ptarg->val);
+        dbScanUnlock((dbCommon*)ptarg);
+    }
+
+    testIocShutdownOk();
+    dbCaLinkWorkers = 1;
+
+    testdbCleanup();
+}
+
 MAIN(dbCaLinkTest)
 {
-    testPlan(101);
+    testPlan(112);
     testNativeLink();
     testStringLink();
     testCP();
@@ -622,5 +700,6 @@ MAIN(dbCaLinkTest)
     testArrayLink(10,10);
     testreTargetTypeChange();
     testCAC();
+    testWorkers();
     return testDone();
 }
@@ -153,11 +153,73 @@ chFilterIf testIf =
 
 void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
 
+static void testCache(void)
+{
+    dbChannelCacheStats stats;
+    dbChannel *pch;
+    DBENTRY dbe;
+    int i;
+
+    testDiag("Channel name cache");
+    dbChannelCacheFlush(1);
+
+    for (i = 0; i < 2; i++) {
+        testOk1(!!(pch = dbChannelCreate("x.NAME$")));
+        testOk1(pch && dbChannelFieldType(pch) == DBF_CHAR);
+        testOk1(pch && dbChannelElements(pch) == PVNAME_STRINGSZ);
+        if (pch) dbChannelDelete(pch);
+    }
+    dbChannelCacheGetStats(&stats);
+    testOk(stats.entries == 1 && stats.hits == 1 && stats.misses == 1,
+        "entries %u, hits %lu, misses %lu", (unsigned) stats.entries,
+        stats.hits, stats.misses);
+
+    /* A cached filter gets the same parser events again */
+    r = r_any;
+    for (i = 0; i < 2; i++) {
+        e = e_start | e_start_map | e_map_key | e_double | e_string
+                | e_end_map | e_end;
+        testOk1(!!(pch = dbChannelCreate("x.{any:{a:2.7183,b:'c'}}")));
+        e = e_close;
+        if (pch) dbChannelDelete(pch);
+    }
+    e = 0;
+    dbChannelCacheGetStats(&stats);
+    testOk(stats.hits == 2, "hits %lu", stats.hits);
+
+    /* Failures are not cached */
+    testOk1(!dbChannelCreate("x.NOFIELD"));
+    testOk1(!dbChannelCreate("x.NOFIELD"));
+    dbChannelCacheGetStats(&stats);
+    testOk(stats.entries == 2 && stats.misses == 4,
+        "entries %u, misses %lu", (unsigned) stats.entries, stats.misses);
+
+    /* Name changes empty the cache */
+    dbInitEntry(pdbbase, &dbe);
+    testOk1(!dbFindRecord(&dbe, "x") && !dbCreateAlias(&dbe, "xalias"));
+    dbFinishEntry(&dbe);
+    testOk1(!!(pch = dbChannelCreate("xalias.NAME$")));
+    if (pch) dbChannelDelete(pch);
+    dbChannelCacheGetStats(&stats);
+    testOk(stats.entries == 1 && stats.flushes == 1,
+        "entries %u, flushes %lu", (unsigned) stats.entries, stats.flushes);
+
+    /* Least recently used names are dropped */
+    dbChannelCacheSize = 1;
+    testOk1(!!(pch = dbChannelCreate("x.VAL")));
+    if (pch) dbChannelDelete(pch);
+    dbChannelCacheGetStats(&stats);
+    testOk(stats.entries == 1 && stats.evictions == 1,
+        "entries %u, evictions %lu", (unsigned) stats.entries,
+        stats.evictions);
+    dbChannelCacheSize = 1024;
+}
+
 MAIN(testDbChannel)     /* dbChannelTest is an API routine... */
 {
     dbChannel *pch;
 
-    testPlan(76);
+    testPlan(112);
 
     testdbPrepare();
 
@@ -267,6 +329,8 @@ MAIN(testDbChannel)     /* dbChannelTest is an API routine... */
     e = e_start | e_start_map | e_abort;
     testOk1(!dbChannelCreate("x.{scalar:{}}"));
 
+    testCache();
+
     testIocShutdownOk();
     testdbCleanup();
 
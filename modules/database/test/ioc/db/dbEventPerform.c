@@ -0,0 +1,140 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * db_post_events() timing for a record with many monitored fields.
+ *
+ * Each pass subscribes N clients to each of up to MAXFIELDS fields of
+ * one record, then measures the time taken to post an event for every
+ * field, as a record with that many monitored fields would when it
+ * processes.  The event task is not started, so after the first post
+ * each subscription just replaces its last queued event.
+ */
+
+#include <string.h>
+
+#include "dbDefs.h"
+#include "epicsStdio.h"
+#include "epicsTime.h"
+#include "caeventmask.h"
+#include "dbAccess.h"
+#include "dbChannel.h"
+#include "dbEvent.h"
+#include "dbLock.h"
+#include "dbStaticLib.h"
+#include "errlog.h"
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+#define MAXFIELDS 50
+#define MAXCLIENTS 20
+#define NCYCLES 20000
+
+static dbChannel *chans[MAXFIELDS];
+static unsigned nchans;
+static dbEventSubscription subs[MAXFIELDS * MAXCLIENTS];
+
+static void openChannels(dbCommon *prec)
+{
+    dbRecordType *prt = prec->rdes;
+    int i;
+
+    for (i = 0; i < prt->no_fields && nchans < MAXFIELDS; i++) {
+        dbFldDes *pflddes = prt->papFldDes[i];
+        char name[PVNAME_STRINGSZ + 8];
+        dbChannel *chan;
+
+        if (pflddes->field_type > DBF_DEVICE)
+            continue;
+        epicsSnprintf(name, sizeof(name), "%s.%s", prec->name, pflddes->name);
+        chan = dbChannelCreate(name);
+        if (!chan)
+            continue;
+        if (dbChannelOpen(chan) || dbChannelElements(chan) != 1) {
+            dbChannelDelete(chan);
+            continue;
+        }
+        chans[nchans++] = chan;
+    }
+}
+
+static void timePosts(dbCommon *prec, unsigned nclients)
+{
+    dbEventCtx ctx = db_init_events();
+    epicsUInt64 start, end;
+    unsigned i, j, nsubs = 0;
+    double elapsed;
+
+    if (!ctx)
+        testAbort("db_init_events() failed");
+
+    for (i = 0; i < nchans; i++) {
+        for (j = 0; j < nclients; j++) {
+            dbEventSubscription sub = db_add_event(ctx, chans[i], NULL, NULL,
+                DBE_VALUE | DBE_ALARM);
+
+            if (!sub)
+                testAbort("db_add_event() failed");
+            db_event_enable(sub);
+            subs[nsubs++] = sub;
+        }
+    }
+
+    start = epicsMonotonicGet();
+    for (i = 0; i < NCYCLES; i++) {
+        dbScanLock(prec);
+        for (j = 0; j < nchans; j++)
+            db_post_events(prec, dbChannelField(chans[j]), DBE_VALUE);
+        dbScanUnlock(prec);
+    }
+    end = epicsMonotonicGet();
+    elapsed = (end - start) * 1e-9;
+
+    testOk(ellCount(&prec->mlis) == (int)nsubs, "%u subscriptions", nsubs);
+    testDiag("%2u clients x %u fields: %.3f usec per process, %.1f nsec per post",
+             nclients, nchans, elapsed * 1e6 / NCYCLES,
+             elapsed * 1e9 / NCYCLES / nchans);
+
+    for (i = 0; i < nsubs; i++)
+        db_cancel_event(subs[i]);
+    db_close_events(ctx);
+}
+
+MAIN(dbEventPerform)
+{
+    static const unsigned clients[] = {1, 5, MAXCLIENTS};
+    dbCommon *prec;
+    unsigned i;
+
+    testPlan(NELEMENTS(clients));
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("xRecord.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    prec = testdbRecordPtr("x");
+    openChannels(prec);
+    testDiag("Monitoring %u fields of %s", nchans, prec->name);
+
+    for (i = 0; i < NELEMENTS(clients); i++)
+        timePosts(prec, clients[i]);
+
+    for (i = 0; i < nchans; i++)
+        dbChannelDelete(chans[i]);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
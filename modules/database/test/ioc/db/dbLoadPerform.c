@@ -0,0 +1,123 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Database load and IOC boot timing with large synthetic databases.
+ *
+ * Each pass writes N records to a temporary file, then measures the
+ * time taken by dbReadDatabaseFP() (with and without macro substitution)
+ * and by iocInit, then the time to re-create the same records from a
+ * binary snapshot.
+ */
+
+#include <stdio.h>
+
+#include "dbDefs.h"
+#include "epicsTempFile.h"
+#include "epicsTime.h"
+#include "dbStaticLib.h"
+#include "dbAccess.h"
+#include "errlog.h"
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+static const char snapFile[] = "dbLoadPerform.snap";
+
+static FILE *makeDb(unsigned long nrec, int useMacros)
+{
+    FILE *fp = epicsTempFile();
+    unsigned long i;
+
+    if (!fp)
+        testAbort("Can't create temporary file");
+
+    for (i = 0; i < nrec; i++) {
+        fprintf(fp, "record(x, \"%s%lu\") {\n", useMacros ? "$(P)" : "perf:", i);
+        fprintf(fp, "    field(DESC, \"Record number %lu\")\n", i);
+        fprintf(fp, "    field(VAL, \"%lu\")\n", i);
+        fprintf(fp, "    field(F64, \"%lu.5\")\n", i);
+        /* link records in small groups, as for typical lock sets */
+        fprintf(fp, "    field(INP, \"%s%lu\")\n",
+                useMacros ? "$(P)" : "perf:", i - i % 10);
+        fprintf(fp, "}\n");
+    }
+    rewind(fp);
+    return fp;
+}
+
+static void timeBoot(unsigned long nrec, int useMacros)
+{
+    epicsTimeStamp t0, t1, t2;
+    FILE *fp = makeDb(nrec, useMacros);
+    long status;
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    epicsTimeGetCurrent(&t0);
+    status = dbReadDatabaseFP(&pdbbase, fp, NULL,
+                              useMacros ? "P=perf:" : NULL);
+    epicsTimeGetCurrent(&t1);
+    testOk(status == 0, "Loaded %lu records%s", nrec,
+           useMacros ? " with macros" : "");
+    if (!useMacros && dbWriteSnapshot(pdbbase, snapFile))
+        testAbort("Can't write snapshot");
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+    epicsTimeGetCurrent(&t2);
+
+    testDiag("%8lu records: load %.3f sec (%.2f usec/record), iocInit %.3f sec",
+             nrec, epicsTimeDiffInSeconds(&t1, &t0),
+             epicsTimeDiffInSeconds(&t1, &t0) * 1e6 / nrec,
+             epicsTimeDiffInSeconds(&t2, &t1));
+
+    testIocShutdownOk();
+    testdbCleanup();
+}
+
+static void timeSnapshot(unsigned long nrec)
+{
+    epicsTimeStamp t0, t1;
+    long status;
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    epicsTimeGetCurrent(&t0);
+    status = dbReadSnapshot(pdbbase, snapFile);
+    epicsTimeGetCurrent(&t1);
+    testOk(status == 0, "Loaded %lu records from snapshot", nrec);
+
+    testDiag("%8lu records: snapshot %.3f sec (%.2f usec/record)",
+             nrec, epicsTimeDiffInSeconds(&t1, &t0),
+             epicsTimeDiffInSeconds(&t1, &t0) * 1e6 / nrec);
+
+    testdbCleanup();
+    remove(snapFile);
+}
+
+MAIN(dbLoadPerform)
+{
+    static const unsigned long sizes[] = {10000, 100000, 1000000};
+    unsigned i;
+
+    testPlan(3 * NELEMENTS(sizes));
+
+    for (i = 0; i < NELEMENTS(sizes); i++) {
+        timeBoot(sizes[i], 0);
+        timeSnapshot(sizes[i]);
+        timeBoot(sizes[i], 1);
+    }
+
+    return testDone();
+}
@@ -0,0 +1,120 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Lock set maintenance timing while re-targeting many DB links.
+ *
+ * Records are linked in groups of GROUP through their SDIS links, as in
+ * dbStressLock.c.  Each pass moves every link to the other of two
+ * overlapping groupings, forcing each lock set to be merged and split.
+ * The passes are timed with every link change made on its own, and with
+ * each pass made as one dbLockSetBatchBegin()/dbLockSetBatchEnd() batch.
+ */
+
+#include <stdio.h>
+
+#include "dbDefs.h"
+#include "epicsStdio.h"
+#include "epicsTempFile.h"
+#include "epicsTime.h"
+#include "dbStaticLib.h"
+#include "dbAccess.h"
+#include "dbLock.h"
+#include "errlog.h"
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+#define GROUP 10
+#define NPASS 10
+
+static void loadDb(unsigned long nrec)
+{
+    FILE *fp = epicsTempFile();
+    unsigned long i;
+
+    if (!fp)
+        testAbort("Can't create temporary file");
+
+    for (i = 0; i < nrec; i++)
+        fprintf(fp, "record(x, \"lk:%lu\") {\n"
+                    "    field(SDIS, \"lk:%lu\")\n"
+                    "}\n", i, i - i % GROUP);
+    rewind(fp);
+
+    if (dbReadDatabaseFP(&pdbbase, fp, NULL, NULL))
+        testAbort("Can't load %lu records", nrec);
+}
+
+/* Point every SDIS to its group head, with groups offset by shift */
+static void retarget(unsigned long nrec, unsigned long shift)
+{
+    unsigned long i;
+
+    for (i = 0; i < nrec; i++) {
+        unsigned long head = (i + shift) - (i + shift) % GROUP;
+        char field[32], target[32];
+        DBADDR addr;
+
+        epicsSnprintf(field, sizeof(field), "lk:%lu.SDIS", i);
+        epicsSnprintf(target, sizeof(target), "lk:%lu", (head + nrec - shift) % nrec);
+        if (dbNameToAddr(field, &addr) ||
+            dbPutField(&addr, DBR_STRING, target, 1))
+            testAbort("Can't set %s to %s", field, target);
+    }
+}
+
+static void timeRetarget(unsigned long nrec, int batch)
+{
+    epicsTimeStamp t0, t1;
+    unsigned pass;
+    double elapsed;
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    loadDb(nrec);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    epicsTimeGetCurrent(&t0);
+    for (pass = 0; pass < NPASS; pass++) {
+        if (batch)
+            dbLockSetBatchBegin();
+        retarget(nrec, pass & 1 ? GROUP / 2 : 0);
+        if (batch)
+            dbLockSetBatchEnd();
+    }
+    epicsTimeGetCurrent(&t1);
+    elapsed = epicsTimeDiffInSeconds(&t1, &t0);
+
+    testOk(dbLockCountSets() == nrec / GROUP, "%lu lock sets", dbLockCountSets());
+    testDiag("%6lu records %s: %.3f sec (%.2f usec/link)",
+             nrec, batch ? "batched  " : "unbatched", elapsed,
+             elapsed * 1e6 / NPASS / nrec);
+
+    testIocShutdownOk();
+    testdbCleanup();
+}
+
+MAIN(dbLockBatchPerform)
+{
+    static const unsigned long sizes[] = {1000, 10000, 100000};
+    unsigned i;
+
+    testPlan(2 * NELEMENTS(sizes));
+
+    for (i = 0; i < NELEMENTS(sizes); i++) {
+        timeRetarget(sizes[i], 0);
+        timeRetarget(sizes[i], 1);
+    }
+
+    return testDone();
+}
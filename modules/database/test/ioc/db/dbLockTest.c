@@ -11,6 +11,7 @@
  */
 
 #include <stdlib.h>
+#include <stdio.h>
 
 #include "epicsSpin.h"
 #include "epicsMutex.h"
@@ -414,12 +415,99 @@ static void testLinkNOP(void)
     testdbCleanup();
 }
 
+/* begin a batch and exit without ending it */
+static void batchAbandon(void *unused)
+{
+    dbLockSetBatchBegin();
+    testdbPutFieldOk("rec08.SDIS", DBR_STRING, "");
+}
+
+static void testLinkBatch(void)
+{
+    epicsThreadOpts opts = EPICS_THREAD_OPTS_INIT;
+    epicsThreadId tid;
+    dbCommon *prec01, *prec10;
+    unsigned long nsets;
+    char name[16], target[16];
+    int i;
+    testDiag("Test batched link changes");
+
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("dbStressLock.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    prec01 = testdbRecordPtr("rec01");
+    prec10 = testdbRecordPtr("rec10");
+    nsets = dbLockCountSets();
+
+    /* chain rec01 -> rec02 -> ... -> rec10 */
+    dbLockSetBatchBegin();
+    for(i=1; i<10; i++) {
+        sprintf(name, "rec%02d.SDIS", i);
+        sprintf(target, "rec%02d", i+1);
+        testdbPutFieldOk(name, DBR_STRING, target);
+    }
+    dbLockSetBatchEnd();
+
+    compareSets(1, "rec01", "rec10");
+    testIntOk1(prec01->lset->plockSet->refcount, ==, 10);
+
+    /* rec06 -> rec07 -> rec08 -> rec01 -> ... -> rec05  and  rec09 -> rec10 */
+    dbLockSetBatchBegin();
+    testdbPutFieldOk("rec05.SDIS", DBR_STRING, "");
+    testdbPutFieldOk("rec08.SDIS", DBR_STRING, "rec01");
+    compareSets(1, "rec05", "rec10"); /* split is deferred */
+    dbLockSetBatchEnd();
+
+    compareSets(1, "rec01", "rec08");
+    compareSets(0, "rec01", "rec09");
+    compareSets(1, "rec09", "rec10");
+    testIntOk1(prec01->lset->plockSet->refcount, ==, 8);
+    testIntOk1(prec10->lset->plockSet->refcount, ==, 2);
+
+    testDiag("Nested batches");
+    dbLockSetBatchBegin();
+    dbLockSetBatchBegin();
+    testdbPutFieldOk("rec09.SDIS", DBR_STRING, "");
+    dbLockSetBatchEnd();
+    compareSets(1, "rec09", "rec10");
+    dbLockSetBatchEnd();
+    compareSets(0, "rec09", "rec10");
+    testIntOk1(prec10->lset->plockSet->refcount, ==, 1);
+
+    /* 10 records were merged into one set, which was split into sets
+     * of 8 and 2, then the set of 2 was split into 2 sets of 1.
+     */
+    testOk(dbLockCountSets()==nsets-9+2, "%lu lockSets", dbLockCountSets());
+
+    testDiag("Thread exits inside a batch");
+    opts.joinable = 1;
+    eltc(0);
+    tid = epicsThreadCreateOpt("batchAbandon", batchAbandon, NULL, &opts);
+    epicsThreadMustJoin(tid);
+    eltc(1);
+    compareSets(1, "rec06", "rec08");
+    compareSets(0, "rec08", "rec01");
+    testIntOk1(prec01->lset->plockSet->refcount, ==, 5);
+    testOk(dbLockCountSets()==nsets-9+3, "%lu lockSets", dbLockCountSets());
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+}
+
 MAIN(dbLockTest)
 {
 #ifdef LOCKSET_DEBUG
-    testPlan(100);
+    testPlan(129);
 #else
-    testPlan(88);
+    testPlan(117);
 #endif
     testSets();
     testSingleLock();
@@ -428,5 +516,6 @@ MAIN(dbLockTest)
     testLinkMake();
     testLinkChange();
     testLinkNOP();
+    testLinkBatch();
     return testDone();
 }
@@ -20,6 +20,10 @@
 #include "dbDefs.h"
 #include "link.h"
 #include "dbAccess.h"
+#include "dbChannel.h"
+#include "dbNotify.h"
+#include "epicsEvent.h"
+#include "epicsTime.h"
 #include "registry.h"
 #include "dbStaticLib.h"
 #include "dbStaticPvt.h"
@@ -699,9 +703,109 @@ void testTSEL(void)
 #undef COMPARE
 }
 
+#define NNOTIFY 10000
+
+static int notifyValue = 1;
+static int notifyDone;
+static int notifyFwd;
+static int notifyBadCount;
+static epicsEventId notifyEvent;
+
+static int notifyPut(processNotify *ppn, notifyPutType type)
+{
+    if (type == putDisabledType)
+        return 0;
+    return !dbChannelPut(ppn->chan, DBR_LONG, &notifyValue, 1);
+}
+
+static void notifyDoneCb(processNotify *ppn)
+{
+    if (dbNotifyOutstanding() != 1)
+        notifyBadCount++;
+    epicsAtomicIncrIntT(&notifyDone);
+    epicsEventMustTrigger(notifyEvent);
+}
+
+static void countFwd(xRecord *prec)
+{
+    notifyFwd++;
+}
+
+static void testPutNotify(void)
+{
+    processNotify pn;
+    xRecord *prec2;
+    epicsUInt64 t0, t1;
+    int i, inlined = 0;
+
+    testDiag("Put-notify throughput through a record chain");
+
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("dbPutLinkTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    notifyEvent = epicsEventMustCreate(epicsEventEmpty);
+    testdbPutFieldOk("x1.FLNK", DBR_STRING, "x2");
+    prec2 = (xRecord *)testdbRecordPtr("x2");
+    dbScanLock((dbCommon *)prec2);
+    prec2->clbk = countFwd;
+    dbScanUnlock((dbCommon *)prec2);
+
+    memset(&pn, 0, sizeof(pn));
+    pn.requestType = putProcessRequest;
+    pn.chan = dbChannelCreate("x1.PROC");
+    pn.putCallback = notifyPut;
+    pn.doneCallback = notifyDoneCb;
+    if (!pn.chan || dbChannelOpen(pn.chan))
+        testAbort("Can't open channel x1.PROC");
+
+    t0 = epicsMonotonicGet();
+    for (i = 0; i < NNOTIFY; i++) {
+        /* discard the trigger left by a completion made in-line */
+        while (epicsEventTryWait(notifyEvent) == epicsEventOK)
+            ;
+        dbProcessNotify(&pn);
+        if (epicsAtomicGetIntT(&notifyDone) == i + 1)
+            inlined++;
+        else
+            epicsEventMustWait(notifyEvent);
+    }
+    t1 = epicsMonotonicGet();
+
+    testOk(notifyDone == NNOTIFY, "%d of %d put-notifies completed",
+           notifyDone, NNOTIFY);
+    testOk(inlined == NNOTIFY, "%d completed before dbProcessNotify() returned",
+           inlined);
+    testOk(pn.status == notifyOK && pn.wasProcessed, "status %d processed %d",
+           pn.status, pn.wasProcessed);
+    testOk(notifyFwd == NNOTIFY, "x2 processed %d times", notifyFwd);
+    testOk(notifyBadCount == 0, "%d doneCallbacks saw a wrong outstanding count",
+           notifyBadCount);
+    testOk(dbNotifyOutstanding() == 0, "%lu put-notifies outstanding",
+           (unsigned long) dbNotifyOutstanding());
+    testDiag("%.2f usec per put-notify",
+             (t1 - t0) * 1e-3 / NNOTIFY);
+
+    dbNotifyCancel(&pn);
+    dbChannelDelete(pn.chan);
+    epicsEventDestroy(notifyEvent);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+}
+
 MAIN(dbPutLinkTest)
 {
-    testPlan(348);
+    testPlan(355);
     testLinkParse();
     testLinkFailParse();
     testCADBSet();
@@ -711,5 +815,6 @@ MAIN(dbPutLinkTest)
     testLinkFail();
     testJLink();
     testTSEL();
+    testPutNotify();
     return testDone();
 }
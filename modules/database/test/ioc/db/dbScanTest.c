@@ -13,7 +13,10 @@
 #include <string.h>
 
 #include "dbScan.h"
+#include "epicsAtomic.h"
 #include "epicsEvent.h"
+#include "epicsThread.h"
+#include "callback.h"
 
 #include "dbUnitTest.h"
 #include "testMain.h"
@@ -21,6 +24,8 @@
 #include "dbAccess.h"
 #include "errlog.h"
 
+#include "xRecord.h"
+
 void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
 
 static epicsEventId waiter;
@@ -66,9 +71,176 @@ static void testOnce(void)
     epicsEventDestroy(waiter);
 }
 
+static epicsEventId blocked, release, done;
+static int nproc;
+static char order[8];
+static int norder;
+
+static void countProc(xRecord *prec)
+{
+    nproc++;
+}
+
+/* holds up the once thread until released */
+static void blockComp(void *junk, dbCommon *prec)
+{
+    epicsEventMustTrigger(blocked);
+    epicsEventMustWait(release);
+}
+
+static void orderComp(void *usr, dbCommon *prec)
+{
+    order[norder++] = prec->name[3];
+}
+
+static void doneComp(void *usr, dbCommon *prec)
+{
+    epicsEventMustTrigger(done);
+}
+
+static void countComp(void *usr, dbCommon *prec)
+{
+    if (epicsAtomicIncrIntT(&nproc) == 7)
+        epicsEventMustTrigger(done);
+}
+
+static void startIoc(void)
+{
+    testdbPrepare();
+
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("dbLockTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+}
+
+static void blockOnce(void)
+{
+    scanOnceCallback(testdbRecordPtr("recg"), blockComp, NULL);
+    epicsEventMustWait(blocked);
+}
+
+static void testCoalesce(void)
+{
+    xRecord *prec;
+    scanOnceQueueStats stats;
+    int i, ok = 1;
+
+    testDiag("check scanOnce() coalescing and priorities");
+    blocked = epicsEventMustCreate(epicsEventEmpty);
+    release = epicsEventMustCreate(epicsEventEmpty);
+    done = epicsEventMustCreate(epicsEventEmpty);
+
+    startIoc();
+
+    prec = (xRecord *)testdbRecordPtr("reca");
+    dbScanLock((dbCommon *)prec);
+    prec->clbk = countProc;
+    dbScanUnlock((dbCommon *)prec);
+
+    blockOnce();
+    for (i = 0; i < 5; i++)
+        ok &= scanOnce((dbCommon *)prec) == 0;
+    testOk(ok, "scanOnce() x5 succeeds");
+    testOk1(scanOnceQueueStatus(0, &stats) == 0);
+    testOk(stats.numUsed == 1, "%d queued", stats.numUsed);
+    scanOnceCallback((dbCommon *)prec, doneComp, NULL);
+    epicsEventMustTrigger(release);
+    epicsEventMustWait(done);
+    testOk(nproc == 2, "processed %d times", nproc);
+
+    testDiag("Requests made once taken from the queue are not lost");
+    nproc = 0;
+    scanOnce((dbCommon *)prec);
+    scanOnceCallback((dbCommon *)prec, doneComp, NULL);
+    epicsEventMustWait(done);
+    scanOnce((dbCommon *)prec);
+    scanOnceCallback((dbCommon *)prec, doneComp, NULL);
+    epicsEventMustWait(done);
+    testOk(nproc == 4, "processed %d times", nproc);
+
+    testDiag("Higher PRIO records are processed first");
+    testdbPutFieldOk("recc.PRIO", DBR_LONG, 2);
+    testdbPutFieldOk("recd.PRIO", DBR_LONG, 1);
+    blockOnce();
+    scanOnceCallback(testdbRecordPtr("recb"), orderComp, NULL);
+    scanOnceCallback(testdbRecordPtr("recd"), orderComp, NULL);
+    scanOnceCallback(testdbRecordPtr("recc"), orderComp, NULL);
+    scanOnceCallback(testdbRecordPtr("rece"), orderComp, NULL);
+    scanOnceCallback(testdbRecordPtr("recf"), doneComp, NULL);
+    epicsEventMustTrigger(release);
+    epicsEventMustWait(done);
+    order[norder] = '\0';
+    testOk(strcmp(order, "cdbe") == 0, "order \"%s\"", order);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+    epicsEventDestroy(blocked);
+    epicsEventDestroy(release);
+    epicsEventDestroy(done);
+}
+
+static epicsThreadId onceId;
+
+static void threadComp(void *usr, dbCommon *prec)
+{
+    onceId = epicsThreadGetIdSelf();
+    epicsEventMustTrigger(done);
+}
+
+static void testThreads(void)
+{
+    scanOnceQueueStats stats;
+    epicsThreadId first;
+    int i;
+
+    testDiag("check multiple scanOnce threads");
+    done = epicsEventMustCreate(epicsEventEmpty);
+
+    testOk1(scanOnceSetThreads(3) == 0);
+    startIoc();
+    testOk1(scanOnceSetThreads(1) == -1);
+
+    testOk1(scanOnceQueueStatus(0, &stats) == 0);
+    testOk(stats.size == 1000, "queue size %d", stats.size);
+    testOk1(scanOnceQueueStatusPrio(priorityLow, 0, &stats) == 0);
+    testOk(stats.size == 3 * 1000, "LOW queues size %d", stats.size);
+    testOk1(scanOnceQueueStatusPrio(NUM_CALLBACK_PRIORITIES, 0, &stats) == -1);
+
+    nproc = 0;
+    for (i = 0; i < 7; i++) {
+        char name[] = "reca";
+        name[3] += i;
+        scanOnceCallback(testdbRecordPtr(name), countComp, NULL);
+    }
+    testOk(epicsEventWaitWithTimeout(done, 10.0) == epicsEventOK,
+           "%d records processed", epicsAtomicGetIntT(&nproc));
+
+    testDiag("A record keeps its thread when its lock set changes");
+    scanOnceCallback(testdbRecordPtr("reca"), threadComp, NULL);
+    epicsEventMustWait(done);
+    first = onceId;
+    testdbPutFieldOk("reca.SDIS", DBR_STRING, "recd");
+    scanOnceCallback(testdbRecordPtr("reca"), threadComp, NULL);
+    epicsEventMustWait(done);
+    testOk(onceId == first, "same scanOnce thread");
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+    scanOnceSetThreads(1);
+    epicsEventDestroy(done);
+}
+
 MAIN(dbScanTest)
 {
-    testPlan(3);
+    testPlan(21);
     testOnce();
+    testCoalesce();
+    testThreads();
     return testDone();
 }
@@ -0,0 +1,144 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Tests for unlocked reads of scalar VAL fields (dbSeqlockReads)
+ */
+
+#include <string.h>
+
+#include "alarm.h"
+#include "dbAccess.h"
+#include "dbChannel.h"
+#include "dbLock.h"
+#include "dbSeqlockPvt.h"
+#include "recGbl.h"
+#include "errlog.h"
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+#include "xRecord.h"
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+typedef struct {
+    DBRstatus
+    DBRtime
+    epicsInt32 value;
+} statusTimeLong;
+
+static void setAlarm(xRecord *prec)
+{
+    recGblSetSevr(prec, HIGH_ALARM, MINOR_ALARM);
+}
+
+static void startIoc(int enable)
+{
+    dbSeqlockReads = enable;
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("xRecord.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+}
+
+static void stopIoc(void)
+{
+    testIocShutdownOk();
+    testdbCleanup();
+    dbSeqlockReads = 0;
+}
+
+static void testReads(void)
+{
+    xRecord *prec;
+    DBADDR addr;
+    dbChannel *chan;
+    statusTimeLong buf;
+    long options, nReq;
+    double dval;
+    char sval[MAX_STRING_SIZE];
+
+    testDiag("Unlocked reads enabled");
+    startIoc(1);
+
+    prec = (xRecord *)testdbRecordPtr("x");
+    testOk1(dbRec2Pvt((dbCommon *)prec)->seqlock != NULL);
+
+    if (dbNameToAddr("x.VAL", &addr))
+        testAbort("Can't find x.VAL");
+
+    testdbPutFieldOk("x.VAL", DBR_LONG, 42);
+
+    memset(&buf, 0, sizeof(buf));
+    options = DBR_STATUS | DBR_TIME;
+    nReq = 1;
+    testOk1(dbGetField(&addr, DBR_LONG, &buf, &options, &nReq, NULL) == 0);
+    testOk(buf.value == 42, "value %d == 42", buf.value);
+    testOk(buf.status == prec->stat && buf.severity == prec->sevr,
+        "status %u/%u", buf.status, buf.severity);
+
+    /* A change made behind the database's back isn't seen by readers
+     * until the copy is refreshed.
+     */
+    dbScanLock((dbCommon *)prec);
+    prec->val = 7;
+    dbScanUnlock((dbCommon *)prec);
+    testdbGetFieldEqual("x.VAL", DBR_LONG, 42);
+
+    dbScanLock((dbCommon *)prec);
+    prec->clbk = &setAlarm;
+    dbScanUnlock((dbCommon *)prec);
+    testdbPutFieldOk("x.PROC", DBR_LONG, 1);
+
+    memset(&buf, 0, sizeof(buf));
+    options = DBR_STATUS | DBR_TIME;
+    nReq = 1;
+    testOk1(dbGetField(&addr, DBR_LONG, &buf, &options, &nReq, NULL) == 0);
+    testOk(buf.value == 7, "value %d == 7", buf.value);
+    testOk(buf.status == HIGH_ALARM && buf.severity == MINOR_ALARM,
+        "status %u/%u", buf.status, buf.severity);
+    testOk1(epicsTimeEqual(&buf.time, &prec->time));
+
+    chan = dbChannelCreate("x.VAL");
+    if (!chan || dbChannelOpen(chan))
+        testAbort("Can't open channel x.VAL");
+    nReq = 1;
+    testOk1(dbChannelGetField(chan, DBR_DOUBLE, &dval, NULL, &nReq, NULL) == 0);
+    testOk(dval == 7.0, "double value %g == 7", dval);
+
+    /* Not served from the copy */
+    nReq = 1;
+    testOk1(dbChannelGetField(chan, DBR_STRING, sval, NULL, &nReq, NULL) == 0);
+    testOk(strcmp(sval, "7") == 0, "string value \"%s\"", sval);
+    dbChannelDelete(chan);
+
+    testdbGetFieldEqual("x.I32", DBR_LONG, 0);
+
+    stopIoc();
+
+    testDiag("Unlocked reads disabled");
+    startIoc(0);
+
+    prec = (xRecord *)testdbRecordPtr("x");
+    testOk1(dbRec2Pvt((dbCommon *)prec)->seqlock == NULL);
+    testdbPutFieldOk("x.VAL", DBR_LONG, 42);
+    testdbGetFieldEqual("x.VAL", DBR_LONG, 42);
+
+    stopIoc();
+}
+
+MAIN(dbSeqlockTest)
+{
+    testPlan(19);
+    testReads();
+    return testDone();
+}
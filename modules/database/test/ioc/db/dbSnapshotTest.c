@@ -0,0 +1,247 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dbDefs.h>
+#include <envDefs.h>
+#include <epicsTempFile.h>
+#include <errlog.h>
+#include <dbAccess.h>
+#include <dbStaticLib.h>
+#include <dbUnitTest.h>
+#include <testMain.h>
+
+#include "devx.h"
+
+void dbTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+static const char snapFile[] = "dbSnapshotTest.snap";
+
+static void startIoc(void)
+{
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+}
+
+/* Returns the output of dbWriteRecordFP(), to be free()'d */
+static char *dumpRecords(void)
+{
+    FILE *fp = epicsTempFile();
+    char *text;
+    long len;
+
+    if (!fp)
+        testAbort("Can't create temporary file");
+    dbWriteRecordFP(pdbbase, fp, NULL, 1);
+    len = ftell(fp);
+    rewind(fp);
+    text = calloc(1, len + 1);
+    if (!text || fread(text, 1, len, fp) != (size_t) len)
+        testAbort("Can't read temporary file");
+    fclose(fp);
+    return text;
+}
+
+/* Number of x records, including aliases */
+static long countRecords(void)
+{
+    DBENTRY entry;
+    long n = 0;
+
+    dbInitEntry(pdbbase, &entry);
+    if (!dbFindRecordType(&entry, "x"))
+        n = dbGetNRecords(&entry);
+    dbFinishEntry(&entry);
+    return n;
+}
+
+static void testRoundTrip(void)
+{
+    char *before, *after;
+    long status;
+
+    testDiag("Write and read back a snapshot");
+
+    startIoc();
+    testdbReadDatabase("dbSnapshotTest.db", NULL, NULL);
+    testdbReadDatabase("dbStaticTest.db", NULL, NULL);
+    status = dbWriteSnapshot(pdbbase, snapFile);
+    testOk(status == 0, "dbWriteSnapshot() returned %ld", status);
+    before = dumpRecords();
+    testdbCleanup();
+
+    startIoc();
+    status = dbReadSnapshot(pdbbase, snapFile);
+    testOk(status == 0, "dbReadSnapshot() returned %ld", status);
+    after = dumpRecords();
+    testOk(strcmp(before, after) == 0, "Records match the original database");
+    if (strcmp(before, after))
+        testDiag("Expected:\n%s\nGot:\n%s", before, after);
+    free(before);
+    free(after);
+
+    xdrv_add(0, NULL, NULL);
+    testIocInitOk();
+    status = dbWriteSnapshot(pdbbase, "running.snap");
+    testOk(status != 0, "dbWriteSnapshot() refused after iocInit");
+    testdbGetFieldEqual("snap:src", DBF_LONG, 42);
+    testdbGetFieldEqual("snap:alias1.U16", DBF_ULONG, 65535);
+    testdbGetFieldEqual("snap:src.I64", DBF_INT64, -1234567890123LL);
+    testdbGetFieldEqual("snap:src.F64", DBF_DOUBLE, 2.718281828);
+    testdbGetFieldEqual("snap:src.SFX", DBF_STRING, "After");
+    testdbGetFieldEqual("snap:src.DESC", DBF_STRING, "Snapshot source");
+    testdbGetFieldEqual("snap:alias2.DTYP", DBF_STRING, "Scan I/O");
+    testdbGetFieldEqual("snap:dst.LNK", DBF_STRING, "snap:src.F64 NPP MS");
+    testdbGetFieldEqual("snap:src.FLNK", DBF_STRING, "snap:dst");
+    testIocShutdownOk();
+    testdbCleanup();
+    xdrv_reset();
+}
+
+static char hookFile[64];
+
+static void loadHook(const char *filename, const char *substitutions)
+{
+    strncpy(hookFile, filename, sizeof(hookFile) - 1);
+}
+
+static void testLoadHook(void)
+{
+    long status;
+
+    testDiag("dbLoadSnapshot() calls dbLoadRecordsHook");
+
+    startIoc();
+    dbLoadRecordsHook = loadHook;
+    status = dbLoadSnapshot(snapFile, NULL, NULL);
+    dbLoadRecordsHook = NULL;
+    testOk(status == 0, "dbLoadSnapshot() returned %ld", status);
+    testOk(strcmp(hookFile, snapFile) == 0, "Hook called for '%s'", hookFile);
+    testdbCleanup();
+}
+
+/* Write the first len bytes of the snapshot to filename, then extra */
+static void copySnapshot(const char *filename, long len, const char *extra)
+{
+    FILE *in = fopen(snapFile, "rb");
+    FILE *out = fopen(filename, "wb");
+    int c;
+
+    if (!in || !out)
+        testAbort("Can't copy %s to %s", snapFile, filename);
+    while ((len < 0 || len-- > 0) && (c = fgetc(in)) != EOF)
+        fputc(c, out);
+    if (extra)
+        fputs(extra, out);
+    fclose(in);
+    fclose(out);
+}
+
+static long snapshotSize(void)
+{
+    FILE *fp = fopen(snapFile, "rb");
+    long size;
+
+    if (!fp)
+        testAbort("Can't open %s", snapFile);
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+static void testBadBody(void)
+{
+    long size = snapshotSize();
+    DBENTRY entry;
+    long status;
+
+    testDiag("Reject snapshots with a bad body before creating records");
+
+    startIoc();
+    copySnapshot("bad.snap", size - 10, NULL);
+    status = dbReadSnapshot(pdbbase, "bad.snap");
+    testOk(status == S_dbLib_badSnapshot, "Truncated: %ld", status);
+    testOk(countRecords() == 0, "No records created");
+
+    copySnapshot("bad.snap", -1, "junk");
+    status = dbReadSnapshot(pdbbase, "bad.snap");
+    testOk(status == S_dbLib_badSnapshot, "Trailing data: %ld", status);
+    testOk(countRecords() == 0, "No records created");
+
+    testDiag("dbLoadSnapshot() falls back after a truncated body");
+    copySnapshot("bad.snap", size / 2, NULL);
+    epicsEnvSet("EPICS_DB_INCLUDE_PATH", ".:..");
+    status = dbLoadSnapshot("bad.snap", "dbSnapshotTest.db", NULL);
+    epicsEnvUnset("EPICS_DB_INCLUDE_PATH");
+    testOk(status == 0, "dbLoadSnapshot() returned %ld", status);
+    testOk(countRecords() == 5, "%ld records and aliases loaded",
+           countRecords());
+    testdbCleanup();
+
+    testDiag("Reject a snapshot which would change a record's type");
+    startIoc();
+    dbInitEntry(pdbbase, &entry);
+    if (dbFindRecordType(&entry, "arr") || dbCreateRecord(&entry, "testrec"))
+        testAbort("Can't create arr record");
+    dbFinishEntry(&entry);
+    status = dbReadSnapshot(pdbbase, snapFile);
+    testOk(status == S_dbLib_badSnapshot, "Name clash: %ld", status);
+    testOk(countRecords() == 0, "No records created");
+    testdbCleanup();
+
+    remove("bad.snap");
+}
+
+static void testBadSnapshot(void)
+{
+    FILE *fp;
+    long status;
+
+    testDiag("Reject missing, corrupt and out of date snapshots");
+
+    startIoc();
+    status = dbReadSnapshot(pdbbase, "no-such-file.snap");
+    testOk(status == S_dbLib_badSnapshot, "Missing file: %ld", status);
+
+    fp = fopen(snapFile, "r+b");
+    if (!fp)
+        testAbort("Can't open %s", snapFile);
+    /* change the definitions checksum at the end of the header */
+    fseek(fp, 24, SEEK_SET);
+    fputc(~fgetc(fp) & 0xff, fp);
+    fclose(fp);
+
+    status = dbReadSnapshot(pdbbase, snapFile);
+    testOk(status == S_dbLib_badSnapshot, "Wrong checksum: %ld", status);
+    testOk(countRecords() == 0, "No records created");
+
+    testDiag("dbLoadSnapshot() falls back to the .db file");
+    epicsEnvSet("EPICS_DB_INCLUDE_PATH", ".:..");
+    status = dbLoadSnapshot(snapFile, "dbSnapshotTest.db", NULL);
+    epicsEnvUnset("EPICS_DB_INCLUDE_PATH");
+    testOk(status == 0, "dbLoadSnapshot() returned %ld", status);
+    testOk(countRecords() == 5, "%ld records and aliases loaded",
+           countRecords());
+    testdbCleanup();
+}
+
+MAIN(dbSnapshotTest)
+{
+    testPlan(28);
+
+    testRoundTrip();
+    testLoadHook();
+    testBadBody();
+    testBadSnapshot();
+
+    remove(snapFile);
+    return testDone();
+}
@@ -10,10 +10,13 @@
  * Lockset stress test.
  *
  * The test strategy is for N threads to contend for M records.
- * Each thread will perform one of three operations:
+ * Each thread will perform one of five operations:
  * 1) Lock a single record.
  * 2) Lock several records.
  * 3) Retarget the TSEL link of a record
+ * 4) Read the VAL field of a record with the record locked.
+ * 5) Read the VAL field of a record with dbGetField(), which
+ *    uses the unlocked (dbSeqlockReads) path.
  *
  *  Author: Michael Davidsaver <mdavidsaver@bnl.gov>
  */
@@ -59,14 +62,17 @@ static unsigned int nrecords;
 
 #define MAXLOCK 20
 
+#define NACTIONS 5
+
 static dbCommon **precords;
+static DBADDR *paddrs;
 
 typedef struct {
     int id;
-    unsigned long N[3];
-    double X[3];
-    double X2[3];
-    double min[3], max[3];
+    unsigned long N[NACTIONS];
+    double X[NACTIONS];
+    double X2[NACTIONS];
+    double min[NACTIONS], max[NACTIONS];
 
     unsigned int done;
     epicsEventId donevent;
@@ -154,6 +160,41 @@ void doreTarget(workerPriv *p)
         testAbort("put fails with %ld", ret);
 }
 
+static
+void doLockedRead(workerPriv *p)
+{
+    size_t recn = (size_t)(getRand()*(nrecords-1));
+    dbCommon *prec = precords[recn];
+    struct {
+        DBRstatus
+        DBRtime
+        epicsInt32 value;
+    } buf;
+    long options = DBR_STATUS | DBR_TIME;
+    long nReq = 1;
+
+    dbScanLock(prec);
+    if (dbGet(&paddrs[recn], DBR_LONG, &buf, &options, &nReq, NULL))
+        testAbort("dbGet fails");
+    dbScanUnlock(prec);
+}
+
+static
+void doUnlockedRead(workerPriv *p)
+{
+    size_t recn = (size_t)(getRand()*(nrecords-1));
+    struct {
+        DBRstatus
+        DBRtime
+        epicsInt32 value;
+    } buf;
+    long options = DBR_STATUS | DBR_TIME;
+    long nReq = 1;
+
+    if (dbGetField(&paddrs[recn], DBR_LONG, &buf, &options, &nReq, NULL))
+        testAbort("dbGetField fails");
+}
+
 static
 void worker(void *raw)
 {
@@ -170,15 +211,21 @@ void worker(void *raw)
 
         before = epicsMonotonicGet();
 
-        if(sel<0.33) {
+        if(sel<0.2) {
             doSingle(priv);
             act = 0;
-        } else if(sel<0.66) {
+        } else if(sel<0.4) {
             doMulti(priv);
             act = 1;
-        } else {
+        } else if(sel<0.6) {
             doreTarget(priv);
             act = 2;
+        } else if(sel<0.8) {
+            doLockedRead(priv);
+            act = 3;
+        } else {
+            doUnlockedRead(priv);
+            act = 4;
         }
 
         after = epicsMonotonicGet();
@@ -218,10 +265,10 @@ MAIN(dbStressTest)
             nworkers = val;
     }
 
-    testPlan(80+nworkers*3);
+    testPlan(80+nworkers*NACTIONS);
 
 #if defined(__rtems__)
-    testSkip(80+nworkers*3, "Test assumes time sliced preempting scheduling");
+    testSkip(80+nworkers*NACTIONS, "Test assumes time sliced preempting scheduling");
     return testDone();
 #endif
 
@@ -235,6 +282,7 @@ MAIN(dbStressTest)
     dbTestIoc_registerRecordDeviceDriver(pdbbase);
     testdbReadDatabase("dbStressLock.db", NULL, NULL);
 
+    dbSeqlockReads = 1;
     eltc(0);
     testIocInitOk();
     eltc(1);
@@ -274,6 +322,16 @@ MAIN(dbStressTest)
     }
     dbFinishEntry(&ent);
 
+    paddrs = callocMustSucceed(nrecords, sizeof(*paddrs), "no mem");
+    for(i=0; i<nrecords; i++) {
+        char name[PVNAME_STRINGSZ+4];
+
+        strcpy(name, precords[i]->name);
+        strcat(name, ".VAL");
+        if(dbNameToAddr(name, &paddrs[i]))
+            testAbort("bad record name? %s", name);
+    }
+
     testDiag("Running with %u workers and %u records",
              nworkers, nrecords);
 
@@ -329,31 +387,40 @@ MAIN(dbStressTest)
     dbFinishEntry(&ent);
 
     testDiag("Statistics");
+    testDiag("    single\tmulti\tretarget\tlocked read\tunlocked read");
     for(i=0; i<nworkers; i++) {
-        double avg[3], std[3];
+        double avg[NACTIONS], std[NACTIONS];
         unsigned j;
         testDiag("Worker %u", i);
-        for(j=0; j<3; j++) {
+        for(j=0; j<NACTIONS; j++) {
             avg[j] = priv[i].X[j]/priv[i].N[j];
             std[j] = sqrt( (priv[i].X2[j]/priv[i].N[j]) - avg[j]*avg[j] );
         }
-        testDiag("N = %lu\t%lu\t%lu", priv[i].N[0], priv[i].N[1], priv[i].N[2]);
-        testDiag("AVG = %g us\t%g us\t%g us", avg[0]*1e6, avg[1]*1e6, avg[2]*1e6);
-        testDiag("STD = %g us\t%g us\t%g us", std[0]*1e6, std[1]*1e6, std[2]*1e6);
-        testDiag("MIN = %g us\t%g us\t%g us", priv[i].min[0]*1e6, priv[i].min[1]*1e6, priv[i].min[2]*1e6);
-        testDiag("MAX = %g us\t%g us\t%g us", priv[i].max[0]*1e6, priv[i].max[1]*1e6, priv[i].max[2]*1e6);
-
-        testOk1(priv[i].N[0]>0);
-        testOk1(priv[i].N[1]>0);
-        testOk1(priv[i].N[2]>0);
+        testDiag("N = %lu\t%lu\t%lu\t%lu\t%lu", priv[i].N[0], priv[i].N[1],
+                 priv[i].N[2], priv[i].N[3], priv[i].N[4]);
+        testDiag("AVG = %g us\t%g us\t%g us\t%g us\t%g us", avg[0]*1e6,
+                 avg[1]*1e6, avg[2]*1e6, avg[3]*1e6, avg[4]*1e6);
+        testDiag("STD = %g us\t%g us\t%g us\t%g us\t%g us", std[0]*1e6,
+                 std[1]*1e6, std[2]*1e6, std[3]*1e6, std[4]*1e6);
+        testDiag("MIN = %g us\t%g us\t%g us\t%g us\t%g us",
+                 priv[i].min[0]*1e6, priv[i].min[1]*1e6, priv[i].min[2]*1e6,
+                 priv[i].min[3]*1e6, priv[i].min[4]*1e6);
+        testDiag("MAX = %g us\t%g us\t%g us\t%g us\t%g us",
+                 priv[i].max[0]*1e6, priv[i].max[1]*1e6, priv[i].max[2]*1e6,
+                 priv[i].max[3]*1e6, priv[i].max[4]*1e6);
+
+        for(j=0; j<NACTIONS; j++)
+            testOk(priv[i].N[j]>0, "N[%u] = %lu", j, priv[i].N[j]);
     }
 
     testIocShutdownOk();
+    dbSeqlockReads = 0;
 
     testdbCleanup();
 
     free(priv);
     free(precords);
+    free(paddrs);
 
     return testDone();
 }
@@ -29,6 +29,8 @@ int scanIoTest(void);
 int dbLockTest(void);
 int dbPutLinkTest(void);
 int dbStaticTest(void);
+int dbSnapshotTest(void);
+int dbSeqlockTest(void);
 int dbCaLinkTest(void);
 int dbDbLinkTest(void);
 int testDbChannel(void);
@@ -52,6 +54,8 @@ void epicsRunDbTests(void)
     runTest(dbLockTest);
     runTest(dbPutLinkTest);
     runTest(dbStaticTest);
+    runTest(dbSnapshotTest);
+    runTest(dbSeqlockTest);
     runTest(dbCaLinkTest);
     runTest(dbDbLinkTest);
     runTest(testDbChannel);
@@ -16,7 +16,9 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "epicsAtomic.h"
 #include "epicsEvent.h"
+#include "epicsThread.h"
 #include "epicsMessageQueue.h"
 #include "epicsPrint.h"
 #include "epicsMath.h"
@@ -296,14 +298,209 @@ static void testMultiThreading(void)
     }
 }
 
+#define NCHUNKED 10
+#define CHUNKSIZE 4
+
+static int chunkProcd[NCHUNKED];
+static int chunkGate, chunkStarted, chunkComplete, chunkAllDone;
+static epicsEventId chunkWait, chunkWake, chunkDone;
+
+static void testcbchunk(xpriv *priv, void *raw)
+{
+    epicsAtomicIncrIntT(&chunkProcd[priv->member]);
+
+    /* hold the first record of each chunk until all have started */
+    if (priv->member % CHUNKSIZE == 0 && epicsAtomicGetIntT(&chunkGate)) {
+        if (epicsAtomicIncrIntT(&chunkStarted) == (NCHUNKED + CHUNKSIZE - 1) / CHUNKSIZE)
+            epicsEventMustTrigger(chunkWait);
+        epicsEventMustWait(chunkWake);
+        epicsEventMustTrigger(chunkWake);
+    }
+}
+
+static void testcompchunk(void *raw, IOSCANPVT scan, int prio)
+{
+    int i, all = 1;
+
+    for (i = 0; i < NCHUNKED; i++)
+        all &= epicsAtomicGetIntT(&chunkProcd[i]) == chunkComplete + 1;
+    chunkAllDone = all;
+    chunkComplete++;
+    epicsEventMustTrigger(chunkDone);
+}
+
+static void testChunked(void)
+{
+    xdrv *drv;
+    int i, ok;
+
+    testDiag("Test chunked I/O Intr scanning");
+
+    chunkWait = epicsEventMustCreate(epicsEventEmpty);
+    chunkWake = epicsEventMustCreate(epicsEventEmpty);
+    chunkDone = epicsEventMustCreate(epicsEventEmpty);
+    memset(chunkProcd, 0, sizeof(chunkProcd));
+    chunkStarted = chunkComplete = 0;
+    chunkGate = 1;
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    for (i = 0; i < NCHUNKED; i++)
+        loadRecord(0, i, "LOW");
+
+    drv = xdrv_add(0, &testcbchunk, NULL);
+    scanIoSetComplete(drv->scan, &testcompchunk, NULL);
+    scanIoSetChunkSize(drv->scan, CHUNKSIZE);
+
+    /* one worker for each chunk */
+    callbackParallelThreads(3, "LOW");
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testOk1(scanIoRequest(drv->scan)==0x1);
+    testOk(epicsEventWaitWithTimeout(chunkWait, 10.0)==epicsEventOK,
+           "All chunks running concurrently");
+    epicsAtomicSetIntT(&chunkGate, 0);
+    epicsEventMustTrigger(chunkWake);
+    epicsEventMustWait(chunkDone);
+    testOk(chunkComplete==1, "Completed once (%d)", chunkComplete);
+    testOk1(chunkAllDone);
+
+    testDiag("Second pass");
+    testOk1(scanIoRequest(drv->scan)==0x1);
+    epicsEventMustWait(chunkDone);
+    testOk(chunkComplete==2, "Completed twice (%d)", chunkComplete);
+    testOk1(chunkAllDone);
+
+    ok = 1;
+    for (i = 0; i < NCHUNKED; i++)
+        ok &= chunkProcd[i] == 2;
+    testOk(ok, "Each record processed twice");
+
+    scanpiol();
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    xdrv_reset();
+
+    epicsEventDestroy(chunkWait);
+    epicsEventDestroy(chunkWake);
+    epicsEventDestroy(chunkDone);
+}
+
+/* Requests which keep arriving while each pass runs must not make the
+ * passes nest on one callback thread's stack.
+ */
+#define NFLOOD 5000
+
+static IOSCANPVT floodScan;
+static int floodPasses;
+static epicsEventId floodDone;
+
+/* Stack position of the completion routine, per callback thread */
+static struct {
+    epicsThreadId id;
+    char *base;
+} floodStack[4];
+static size_t floodDepth;
+
+static void testcbflood(xpriv *priv, void *raw)
+{
+    if (epicsAtomicGetIntT(&floodPasses) < NFLOOD) {
+        scanIoRequest(floodScan);
+        /* let another thread see the request while this pass runs */
+        epicsThreadSleep(0.0001);
+    }
+}
+
+static void testcompflood(void *raw, IOSCANPVT scan, int prio)
+{
+    epicsThreadId self = epicsThreadGetIdSelf();
+    char here;
+    int i;
+
+    for (i = 0; i < NELEMENTS(floodStack); i++) {
+        if (!floodStack[i].id) {
+            floodStack[i].id = self;
+            floodStack[i].base = &here;
+        }
+        if (floodStack[i].id == self) {
+            size_t depth = floodStack[i].base > &here ?
+                floodStack[i].base - &here : &here - floodStack[i].base;
+
+            if (depth > floodDepth)
+                floodDepth = depth;
+            break;
+        }
+    }
+
+    if (epicsAtomicIncrIntT(&floodPasses) == NFLOOD)
+        epicsEventMustTrigger(floodDone);
+}
+
+static void testFlood(void)
+{
+    xdrv *drv;
+    int i, ok = 1;
+
+    testDiag("Test chunked I/O Intr scanning with a stream of requests");
+
+    floodDone = epicsEventMustCreate(epicsEventEmpty);
+    floodPasses = 0;
+    floodDepth = 0;
+    memset(floodStack, 0, sizeof(floodStack));
+
+    testdbPrepare();
+    testdbReadDatabase("dbTestIoc.dbd", NULL, NULL);
+    dbTestIoc_registerRecordDeviceDriver(pdbbase);
+
+    loadRecord(0, 0, "LOW");
+
+    drv = xdrv_add(0, &testcbflood, NULL);
+    floodScan = drv->scan;
+    scanIoSetComplete(drv->scan, &testcompflood, NULL);
+    scanIoSetChunkSize(drv->scan, CHUNKSIZE);
+
+    callbackParallelThreads(3, "LOW");
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    /* and a burst from outside as well */
+    for (i = 0; i < 100; i++)
+        ok &= scanIoRequest(drv->scan)==0x1;
+    testOk(ok, "100 requests queued");
+    testOk(epicsEventWaitWithTimeout(floodDone, 60.0)==epicsEventOK,
+           "%d passes completed", NFLOOD);
+    testOk(floodDepth < 4096, "Passes did not nest (%lu bytes)",
+           (unsigned long)floodDepth);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    xdrv_reset();
+
+    epicsEventDestroy(floodDone);
+}
+
 MAIN(scanIoTest)
 {
-    testPlan(152);
+    testPlan(163);
     testSingleThreading();
     testDiag("run a second time to verify shutdown and restart works");
     testSingleThreading();
     testMultiThreading();
     testDiag("run a second time to verify shutdown and restart works");
     testMultiThreading();
+    testChunked();
+    testFlood();
     return testDone();
 }
@@ -291,6 +291,18 @@ static void check(short dbr_type) {
     TEST5B(3, -8,  6, "left side from-end");
     TEST5B(3,  2, -4, "right side from-end");
     TEST5B(3, -8, -4, "both sides from-end");
+
+    /* Slices of a slice are views into the first copy */
+
+    testHead("Five %s elements from buffer, nested contiguous slices", typname);
+    createAndOpen(valname, "{arr:{},arr:{s:1,e:8},arr:{s:1,e:5}}",
+                  "(nested)", &pch, 3);
+    testOk(pch->final_type == valaddr.field_type,
+           "final type unchanged (%d->%d)", valaddr.field_type, pch->final_type);
+    testOk(pch->final_no_elements == 5,
+           "final no_elements correct (%ld->%ld)", valaddr.no_elements, pch->final_no_elements);
+    TEST1(5, 0, 1, "no offset");
+    dbChannelDelete(pch);
 }
 
 MAIN(arrTest)
@@ -299,7 +311,7 @@ MAIN(arrTest)
     const chFilterPlugin *plug;
     char arr[] = "arr";
 
-    testPlan(1402);
+    testPlan(1435);
 
     /* Prepare the IOC */
 
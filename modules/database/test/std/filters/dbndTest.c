@@ -118,6 +118,89 @@ static void testHead (char* title) {
     testDiag("--------------------------------------------------------");
 }
 
+static void checkArray(dbChannel *pch, int pass, const char *what) {
+    int oldFree = db_available_logs();
+    db_field_log *pfl, *pfl2;
+
+    pfl2 = db_create_read_log(pch);
+    pfl2->mask = DBE_VALUE;
+    pfl = dbChannelRunPreChain(pch, pfl2);
+    if (pass) {
+        testOk(pfl == pfl2, "%s: field_log passed", what);
+        db_delete_field_log(pfl);
+    } else {
+        testOk(!pfl, "%s: field_log dropped", what);
+    }
+    testOk(db_available_logs() == oldFree, "field_log was freed");
+}
+
+static void testArrays(void) {
+    epicsInt32 ar[4] = {1, 2, 3, 4};
+    const char *as[4] = {"a", "b", "c", "d"};
+    char sbuf[4][MAX_STRING_SIZE];
+    dbChannel *pch;
+    int i;
+
+    testHead("Arrays, absolute deadband");
+    testdbPutArrFieldOk("ax", DBR_LONG, 4, ar);
+    testOk(!!(pch = dbChannelCreate("ax.VAL{dbnd:{d:1}}")),
+           "dbChannel with plugin dbnd (delta=1) on array created");
+    testOk(!(dbChannelOpen(pch)), "dbChannel with plugin dbnd opened");
+
+    checkArray(pch, 1, "first update");
+    checkArray(pch, 0, "same array");
+    ar[3] = 5;
+    testdbPutArrFieldOk("ax", DBR_LONG, 4, ar);
+    checkArray(pch, 0, "element changed by 1");
+    ar[3] = 6;
+    testdbPutArrFieldOk("ax", DBR_LONG, 4, ar);
+    checkArray(pch, 1, "element changed by 2");
+    testdbPutArrFieldOk("ax", DBR_LONG, 3, ar);
+    checkArray(pch, 1, "shorter array");
+    checkArray(pch, 0, "shorter array again");
+    dbChannelDelete(pch);
+
+    testHead("Arrays, relative deadband");
+    testOk(!!(pch = dbChannelCreate("ax.VAL{dbnd:{rel:50}}")),
+           "dbChannel with plugin dbnd (mode=rel, delta=50) on array created");
+    testOk(!(dbChannelOpen(pch)), "dbChannel with plugin dbnd opened");
+    checkArray(pch, 1, "first update");
+    ar[0] = 2;
+    testdbPutArrFieldOk("ax", DBR_LONG, 3, ar);
+    checkArray(pch, 1, "element changed by 100%");
+    ar[2] = 4;
+    testdbPutArrFieldOk("ax", DBR_LONG, 3, ar);
+    checkArray(pch, 0, "element changed by 33%");
+    dbChannelDelete(pch);
+
+    testHead("String arrays, hash mode");
+    for (i = 0; i < 4; i++)
+        strcpy(sbuf[i], as[i]);
+    testdbPutArrFieldOk("as", DBR_STRING, 4, sbuf);
+    testOk(!!(pch = dbChannelCreate("as.VAL{dbnd:{m:'hash'}}")),
+           "dbChannel with plugin dbnd (mode=hash) on array created");
+    testOk(!(dbChannelOpen(pch)), "dbChannel with plugin dbnd opened");
+    checkArray(pch, 1, "first update");
+    testdbPutArrFieldOk("as", DBR_STRING, 4, sbuf);
+    checkArray(pch, 0, "same strings");
+    strcpy(sbuf[2], "x");
+    testdbPutArrFieldOk("as", DBR_STRING, 4, sbuf);
+    checkArray(pch, 1, "one string changed");
+    dbChannelDelete(pch);
+
+    testHead("Hash mode on a scalar");
+    testOk(!!(pch = dbChannelCreate("x.VAL{dbnd:{m:'hash'}}")),
+           "dbChannel with plugin dbnd (mode=hash) created");
+    testOk(!(dbChannelOpen(pch)), "dbChannel with plugin dbnd opened");
+    {
+        db_field_log *pfl2 = db_create_read_log(pch);
+
+        fl_setup(pch, pfl2);
+        mustPassOnce(pch, pfl2, "hash", 0., 7);
+    }
+    dbChannelDelete(pch);
+}
+
 MAIN(dbndTest)
 {
     dbChannel *pch;
@@ -132,7 +215,7 @@ MAIN(dbndTest)
     dbEventCtx evtctx;
     int logsFree, logsFinal;
 
-    testPlan(72);
+    testPlan(112);
 
     testdbPrepare();
 
@@ -141,6 +224,7 @@ MAIN(dbndTest)
     filterTest_registerRecordDeviceDriver(pdbbase);
 
     testdbReadDatabase("xRecord.db", NULL, NULL);
+    testdbReadDatabase("dbndTest.db", NULL, NULL);
 
     eltc(0);
     testIocInitOk();
@@ -173,12 +257,6 @@ MAIN(dbndTest)
            "dbnd has one filter with argument in pre chain");
     testOk((ellCount(&pch->post_chain) == 0), "dbnd has no filter in post chain");
 
-    /* Field logs of type ref: pass any update */
-
-    testHead("Field logs of type ref");
-    fl1.type = dbfl_type_ref;
-    mustPassTwice(pch, &fl1, "abs field_log=ref", 0., 0);
-
     /* Delta = 0: pass any change */
 
     testHead("Delta = 0: pass any change");
@@ -301,6 +379,8 @@ MAIN(dbndTest)
 
     dbChannelDelete(pch);
 
+    testArrays();
+
     logsFinal = db_available_logs();
     testOk(logsFree == logsFinal, "%d field_logs on free-list", logsFinal);
 
@@ -19,6 +19,8 @@ int dbndTest(void);
 int syncTest(void);
 int arrTest(void);
 int decTest(void);
+int statsTest(void);
+int rateTest(void);
 
 void epicsRunFilterTests(void)
 {
@@ -29,6 +31,8 @@ void epicsRunFilterTests(void)
     runTest(syncTest);
     runTest(arrTest);
     runTest(decTest);
+    runTest(statsTest);
+    runTest(rateTest);
 
     dbmfFreeChunks();
 
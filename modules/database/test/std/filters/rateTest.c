@@ -0,0 +1,278 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Tests for the rate limiting filter "rate".
+ */
+
+#include <string.h>
+
+#include "dbAccess.h"
+#include "dbStaticLib.h"
+#include "dbAccessDefs.h"
+#include "db_field_log.h"
+#include "dbChannel.h"
+#include "dbEvent.h"
+#include "dbLock.h"
+#include "chfPlugin.h"
+#include "alarm.h"
+#include "errlog.h"
+#include "epicsEvent.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "epicsUnitTest.h"
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+#include "xRecord.h"
+
+#define PERIOD 0.5
+
+void filterTest_registerRecordDeviceDriver(struct dbBase *);
+
+static dbEventCtx evtctx;
+static epicsMutexId lock;
+
+/* Updates received by one subscription */
+typedef struct subscriber {
+    dbEventSubscription sub;
+    epicsEventId updated;
+    unsigned count;
+    double lastValue;
+    epicsEnum16 lastSevr;
+} subscriber;
+
+static subscriber subs[2];
+
+static void update(void *user_arg, struct dbChannel *chan,
+                   int eventsRemaining, struct db_field_log *pfl)
+{
+    subscriber *ps = (subscriber *) user_arg;
+
+    epicsMutexMustLock(lock);
+    ps->count++;
+    if (pfl->field_type == DBF_DOUBLE)
+        ps->lastValue = pfl->u.v.field.dbf_double;
+    else
+        ps->lastValue = pfl->u.v.field.dbf_long;
+    ps->lastSevr = pfl->sevr;
+    epicsMutexUnlock(lock);
+    epicsEventMustTrigger(ps->updated);
+}
+
+static void testHead (char* title) {
+    testDiag("--------------------------------------------------------");
+    testDiag("%s", title);
+    testDiag("--------------------------------------------------------");
+}
+
+static void post(xRecord *prec, epicsInt32 val, epicsEnum16 sevr)
+{
+    dbScanLock((dbCommon *) prec);
+    prec->val = val;
+    prec->sevr = sevr;
+    db_post_events(prec, &prec->val, DBE_VALUE | DBE_ALARM);
+    dbScanUnlock((dbCommon *) prec);
+}
+
+static void getCount(subscriber *ps, unsigned *pgot, double *pval)
+{
+    epicsMutexMustLock(lock);
+    *pgot = ps->count;
+    *pval = ps->lastValue;
+    epicsMutexUnlock(lock);
+}
+
+/* Wait up to 3 periods for the n-th update and check its value */
+static void checkUpdateOf(subscriber *ps, unsigned n, double value,
+    const char *what)
+{
+    unsigned got;
+    double val;
+
+    for (;;) {
+        getCount(ps, &got, &val);
+        if (got >= n ||
+            epicsEventWaitWithTimeout(ps->updated, 3 * PERIOD) != epicsEventOK)
+            break;
+    }
+    getCount(ps, &got, &val);
+    testOk(got == n && val == value, "%s: update %u, value %g (got %u, %g)",
+           what, n, value, got, val);
+}
+
+static void checkUpdate(unsigned n, double value, const char *what)
+{
+    checkUpdateOf(&subs[0], n, value, what);
+}
+
+/* Check that no update beyond the n-th arrives for a while */
+static void checkHeld(unsigned n, double wait, const char *what)
+{
+    subscriber *ps = &subs[0];
+    unsigned got;
+    double val;
+
+    while (epicsEventTryWait(ps->updated) == epicsEventOK)
+        ;
+    getCount(ps, &got, &val);
+    if (got == n)
+        epicsEventWaitWithTimeout(ps->updated, wait);
+    getCount(ps, &got, &val);
+    testOk(got == n, "%s: still %u updates (got %u)", what, n, got);
+}
+
+static void subscribeTo(subscriber *ps, dbChannel *pch)
+{
+    epicsMutexMustLock(lock);
+    ps->count = 0;
+    epicsMutexUnlock(lock);
+    while (epicsEventTryWait(ps->updated) == epicsEventOK)
+        ;
+    ps->sub = db_add_event(evtctx, pch, update, ps, DBE_VALUE | DBE_ALARM);
+    if (!ps->sub)
+        testAbort("Can't subscribe to %s", dbChannelName(pch));
+    db_event_enable(ps->sub);
+}
+
+static dbEventSubscription subscribe(const char *name, dbChannel **ppch)
+{
+    *ppch = dbChannelCreate(name);
+    if (!*ppch || dbChannelOpen(*ppch))
+        testAbort("Can't open %s", name);
+    subscribeTo(&subs[0], *ppch);
+    return subs[0].sub;
+}
+
+static void cancel(dbEventSubscription sub)
+{
+    db_event_disable(sub);
+    db_cancel_event(sub);
+}
+
+static void unsubscribe(dbEventSubscription sub, dbChannel *pch)
+{
+    cancel(sub);
+    dbChannelDelete(pch);
+}
+
+MAIN(rateTest)
+{
+    const char rate[] = "rate";
+    dbEventSubscription sub;
+    dbChannel *pch;
+    xRecord *prec;
+
+    testPlan(24);
+
+    lock = epicsMutexMustCreate();
+    subs[0].updated = epicsEventMustCreate(epicsEventEmpty);
+    subs[1].updated = epicsEventMustCreate(epicsEventEmpty);
+
+    testdbPrepare();
+
+    testdbReadDatabase("filterTest.dbd", NULL, NULL);
+
+    filterTest_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("xRecord.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    evtctx = db_init_events();
+    db_start_events(evtctx, "test-rate", NULL, NULL, epicsThreadPriorityLow);
+    prec = (xRecord *) testdbRecordPtr("x");
+
+    testOk(!!dbFindFilter(rate, strlen(rate)), "plugin rate registered correctly");
+
+    testOk(!dbChannelCreate("x.{rate:{t:0}}"), "zero period rejected");
+    pch = dbChannelCreate("x.{rate:{m:'mean'}}");
+    testOk(pch && !dbChannelOpen(pch) &&
+           dbChannelFinalFieldType(pch) == DBF_DOUBLE,
+           "mean mode gives a DOUBLE");
+    if (pch) dbChannelDelete(pch);
+
+    testHead("Latest value");
+    sub = subscribe("x.{rate:{t:0.5}}", &pch);
+    post(prec, 1, NO_ALARM);
+    checkUpdate(1, 1, "first update is sent");
+    post(prec, 2, NO_ALARM);
+    post(prec, 3, NO_ALARM);
+    post(prec, 4, NO_ALARM);
+    checkHeld(1, PERIOD / 5, "later updates");
+    checkUpdate(2, 4, "latest value sent at end of period");
+    checkHeld(2, 2.5 * PERIOD, "idle");
+    post(prec, 5, NO_ALARM);
+    checkUpdate(3, 5, "update after idle period is sent");
+    post(prec, 6, NO_ALARM);
+    /* channel closed while the timer is running */
+    unsubscribe(sub, pch);
+    testPass("channel closed with an update held");
+
+    testHead("Mean value");
+    sub = subscribe("x.{rate:{t:0.5,m:'mean'}}", &pch);
+    post(prec, 10, NO_ALARM);
+    checkUpdate(1, 10, "first update is sent");
+    post(prec, 20, NO_ALARM);
+    post(prec, 40, NO_ALARM);
+    checkHeld(1, PERIOD / 5, "later updates");
+    checkUpdate(2, 30, "mean sent at end of period");
+    unsubscribe(sub, pch);
+
+    testHead("Maximum value");
+    sub = subscribe("x.{rate:{t:0.5,m:'max'}}", &pch);
+    post(prec, 1, NO_ALARM);
+    checkUpdate(1, 1, "first update is sent");
+    post(prec, 7, NO_ALARM);
+    post(prec, 3, NO_ALARM);
+    checkUpdate(2, 7, "maximum sent at end of period");
+    unsubscribe(sub, pch);
+
+    testHead("Severity change");
+    sub = subscribe("x.{rate:{t:0.5,m:'mean'}}", &pch);
+    post(prec, 1, NO_ALARM);
+    checkUpdate(1, 1, "first update is sent");
+    post(prec, 2, NO_ALARM);
+    checkHeld(1, PERIOD / 5, "same severity");
+    post(prec, 3, MAJOR_ALARM);
+    checkUpdate(2, 2.5, "new severity sent immediately");
+    testOk(subs[0].lastSevr == MAJOR_ALARM, "update has severity MAJOR");
+    unsubscribe(sub, pch);
+
+    testHead("Two subscriptions on one channel");
+    sub = subscribe("x.{rate:{t:0.5,m:'mean'}}", &pch);
+    subscribeTo(&subs[1], pch);
+    post(prec, 10, NO_ALARM);
+    checkUpdateOf(&subs[0], 1, 10, "first subscription gets first update");
+    checkUpdateOf(&subs[1], 1, 10, "second subscription gets first update");
+    post(prec, 20, NO_ALARM);
+    post(prec, 40, NO_ALARM);
+    checkUpdateOf(&subs[0], 2, 30, "first subscription gets the mean");
+    checkUpdateOf(&subs[1], 2, 30, "second subscription gets the mean");
+    cancel(subs[1].sub);
+    post(prec, 50, NO_ALARM);
+    post(prec, 60, NO_ALARM);
+    checkUpdateOf(&subs[0], 3, 55, "remaining subscription after cancel");
+    subscribeTo(&subs[1], pch);
+    post(prec, 70, NO_ALARM);
+    checkUpdateOf(&subs[1], 1, 70, "new subscription starts its own period");
+    cancel(subs[1].sub);
+    unsubscribe(sub, pch);
+
+    db_close_events(evtctx);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    epicsEventDestroy(subs[0].updated);
+    epicsEventDestroy(subs[1].updated);
+    epicsMutexDestroy(lock);
+
+    return testDone();
+}
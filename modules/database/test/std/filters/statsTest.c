@@ -0,0 +1,168 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Tests for the array statistics filter "stats".
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "dbAccess.h"
+#include "dbStaticLib.h"
+#include "dbAccessDefs.h"
+#include "db_field_log.h"
+#include "dbChannel.h"
+#include "chfPlugin.h"
+#include "errlog.h"
+#include "epicsUnitTest.h"
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+void filterTest_registerRecordDeviceDriver(struct dbBase *);
+
+static void testHead (char* title) {
+    testDiag("--------------------------------------------------------");
+    testDiag("%s", title);
+    testDiag("--------------------------------------------------------");
+}
+
+/* Run the filter chains on a read log and compare the doubles returned */
+static void checkValues(const char *name, long nfinal, long nexp,
+    const double *expected)
+{
+    int oldFree = db_available_logs();
+    dbChannel *pch = dbChannelCreate(name);
+    db_field_log *pfl;
+    const double *pval;
+    long i;
+    int ok;
+
+    if (!testOk(!!pch && !dbChannelOpen(pch), "channel %s opened", name)) {
+        testSkip(4, "channel failed");
+        if (pch) dbChannelDelete(pch);
+        return;
+    }
+    testOk(dbChannelFinalFieldType(pch) == DBF_DOUBLE &&
+           dbChannelFinalElements(pch) == nfinal,
+           "final type DOUBLE, %ld elements (got %d, %ld)", nfinal,
+           dbChannelFinalFieldType(pch), dbChannelFinalElements(pch));
+
+    pfl = db_create_read_log(pch);
+    pfl = dbChannelRunPreChain(pch, pfl);
+    if (pfl)
+        pfl = dbChannelRunPostChain(pch, pfl);
+    if (!testOk(pfl && pfl->field_type == DBF_DOUBLE &&
+                pfl->no_elements == nexp,
+                "field_log holds %ld doubles", nexp)) {
+        testSkip(1, "wrong field_log");
+    } else {
+        pval = (const double *) dbfl_pfield(pfl);
+        ok = 1;
+        for (i = 0; i < nexp; i++) {
+            if (fabs(pval[i] - expected[i]) > 1e-9 * (1.0 + fabs(expected[i]))) {
+                testDiag("[%ld] %g != %g", i, pval[i], expected[i]);
+                ok = 0;
+            }
+        }
+        testOk(ok, "values match");
+    }
+    if (pfl) db_delete_field_log(pfl);
+    dbChannelDelete(pch);
+    testOk(db_available_logs() == oldFree, "field_log was freed");
+}
+
+MAIN(statsTest)
+{
+    epicsInt32 ar[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    epicsFloat64 dr[4] = {1e9 + 1, 1e9 + 2, 1e9 + 3, 1e9 + 4};
+    const char stats[] = "stats";
+    dbChannel *pch;
+
+    testPlan(56);
+
+    testdbPrepare();
+
+    testdbReadDatabase("filterTest.dbd", NULL, NULL);
+
+    filterTest_registerRecordDeviceDriver(pdbbase);
+
+    testdbReadDatabase("arrTest.db", NULL, NULL);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    testOk(!!dbFindFilter(stats, strlen(stats)), "plugin stats registered correctly");
+
+    /* Start the free-list */
+    pch = dbChannelCreate("x");
+    db_delete_field_log(db_create_read_log(pch));
+    dbChannelDelete(pch);
+
+    testdbPutArrFieldOk("x", DBR_LONG, 10, ar);
+    testdbPutArrFieldOk("y", DBR_DOUBLE, 4, dr);
+
+    testHead("Single statistics");
+    {
+        double mean = 5.5, min = 1, max = 10;
+        double std = sqrt(8.25), rms = sqrt(38.5);
+
+        checkValues("x.{stats:{m:'mean'}}", 1, 1, &mean);
+        checkValues("x.{stats:{m:'std'}}", 1, 1, &std);
+        checkValues("x.{stats:{m:'rms'}}", 1, 1, &rms);
+        checkValues("x.{stats:{m:'min'}}", 1, 1, &min);
+        checkValues("x.{stats:{m:'max'}}", 1, 1, &max);
+    }
+
+    testHead("All statistics");
+    {
+        double all[6] = {5.5, 0, 0, 1, 10, 10};
+
+        all[1] = sqrt(8.25);
+        all[2] = sqrt(38.5);
+        checkValues("x.{stats:{}}", 6, 6, all);
+    }
+
+    testHead("Large common offset");
+    {
+        double std = sqrt(1.25);
+
+        checkValues("y.{stats:{m:'std'}}", 1, 1, &std);
+    }
+
+    testHead("Min/max envelope");
+    {
+        double env2[4] = {1, 5, 6, 10};
+        double env[8] = {1, 1, 2, 2, 3, 3, 4, 4};
+
+        checkValues("x.{stats:{m:'env',n:2}}", 4, 4, env2);
+        testdbPutArrFieldOk("x", DBR_LONG, 4, ar);
+        checkValues("x.{stats:{m:'env',n:6}}", 12, 8, env);
+    }
+
+    testHead("Filter chain");
+    {
+        double range[2] = {1, 4};
+
+        checkValues("x.{stats:{},arr:{s:3,e:4}}", 2, 2, range);
+    }
+
+    testHead("Unsupported channels");
+    testOk(!dbChannelCreate("x.{stats:{m:'env',n:0}}"),
+           "zero envelope buckets rejected");
+    pch = dbChannelCreate("z.{stats:{}}");
+    testOk(pch && !dbChannelOpen(pch) &&
+           dbChannelFinalFieldType(pch) == DBF_STRING,
+           "string array is not reduced");
+    if (pch) dbChannelDelete(pch);
+
+    testIocShutdownOk();
+
+    testdbCleanup();
+
+    return testDone();
+}
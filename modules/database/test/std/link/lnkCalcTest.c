@@ -108,6 +108,63 @@ static void testCalc()
         testOk(sevr == MINOR_ALARM, "Alarm severity = MINOR (%d)", sevr);
     }
 
+    testDiag("testing lnkCalc array input");
+
+    {
+        epicsFloat64 arr[10];
+        long nReq = 10;
+        long nelem = 0;
+
+        testPutLongStr("io.INPUT", "{calc:{"
+            "expr:'A*B+C',"
+            "nelm:5,"
+            "major:'A>3',"
+            "args:[{const:[1,2,3,4]},{const:[10,20,30,40,50]},0.5]"
+            "}}");
+        if (testOk1(pinp->type == JSON_LINK))
+            testDiag("Link was set to '%s'", pinp->value.json.string);
+
+        status = dbGetNelements(pinp, &nelem);
+        testOk(!status && nelem == 5, "dbGetNelements gives 5 (%ld)", nelem);
+
+        status = dbGetLink(pinp, DBF_DOUBLE, arr, NULL, &nReq);
+        testOk(!status, "dbGetLink succeeded (status = %ld)", status);
+        testOk(nReq == 4, "Got 4 elements (%ld)", nReq);
+        testOk(arr[0] == 10.5 && arr[1] == 40.5 &&
+               arr[2] == 90.5 && arr[3] == 160.5,
+               "Element-wise values (%g, %g, %g, %g)",
+               arr[0], arr[1], arr[2], arr[3]);
+        testOk(recGblResetAlarms(pio) & DBE_ALARM,
+               "Record alarm raised by last element");
+
+        nReq = 2;
+        status = dbGetLink(pinp, DBF_DOUBLE, arr, NULL, &nReq);
+        testOk(!status && nReq == 2 && arr[1] == 40.5,
+               "Got 2 elements when 2 requested (%ld)", nReq);
+
+        testPutLongStr("io.INPUT", "{calc:{"
+            "expr:'A>2?A:-B',"
+            "nelm:4,"
+            "args:[{const:[1,2,3,4]},7]"
+            "}}");
+        nReq = 10;
+        status = dbGetLink(pinp, DBF_DOUBLE, arr, NULL, &nReq);
+        testOk(!status && nReq == 4 && arr[0] == -7 && arr[1] == -7 &&
+               arr[2] == 3 && arr[3] == 4,
+               "Conditional with scalar broadcast (%g, %g, %g, %g)",
+               arr[0], arr[1], arr[2], arr[3]);
+
+        testPutLongStr("io.INPUT", "{calc:{"
+            "expr:'A+1',"
+            "nelm:4,"
+            "args:[2]"
+            "}}");
+        nReq = 10;
+        status = dbGetLink(pinp, DBF_DOUBLE, arr, NULL, &nReq);
+        testOk(!status && nReq == 1 && arr[0] == 3,
+               "Scalar args give one element (%ld, %g)", nReq, arr[0]);
+    }
+
     testDiag("testing lnkCalc output");
 
     {
@@ -157,7 +214,7 @@ static void testCalc()
 
 MAIN(lnkCalcTest)
 {
-    testPlan(30);
+    testPlan(42);
 
     testCalc();
 
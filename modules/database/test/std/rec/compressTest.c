@@ -14,6 +14,7 @@
 #include "errlog.h"
 #include "dbAccess.h"
 #include "epicsMath.h"
+#include "epicsStdio.h"
 #include "menuYesNo.h"
 
 #include "aiRecord.h"
@@ -694,9 +695,43 @@ testAIAveragePartial(void) {
     testdbCleanup();
 }
 
+static void
+testNto2Select(const char *alg, const char *pctl, double a, double b)
+{
+    char macros[80];
+    DBADDR wfaddr, caddr;
+
+    testDiag("Test '%s', N to 2, PCTL=%s", alg, pctl);
+
+    testdbPrepare();
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+    epicsSnprintf(macros, sizeof(macros),
+        "INP=wf,ALG=%s,BALG=FIFO Buffer,NSAM=2,N=3,PBUF=YES,PCTL=%s", alg, pctl);
+    testdbReadDatabase("compressTest.db", NULL, macros);
+
+    eltc(0);
+    testIocInitOk();
+    eltc(1);
+
+    fetchRecordOrDie("wf", wfaddr);
+    fetchRecordOrDie("comp", caddr);
+
+    writeToWaveform(&wfaddr, 4, 3., 1., 2., 4.);
+
+    dbScanLock(caddr.precord);
+    dbProcess(caddr.precord);
+
+    checkArrD("comp", 2, a, b, 0, 0);
+    dbScanUnlock(caddr.precord);
+
+    testIocShutdownOk();
+    testdbCleanup();
+}
+
 MAIN(compressTest)
 {
-    testPlan(134);
+    testPlan(139);
     testFIFOCirc();
     testLIFOCirc();
     testArrayAverage();
@@ -706,5 +741,10 @@ MAIN(compressTest)
     testNtoMPartial();
     testAIAveragePartial();
     testNto1LowValue();
+    testNto2Select("N to 1 High Value", "50", 3.0, 4.0);
+    testNto2Select("N to 1 Median", "50", 2.0, 4.0);
+    testNto2Select("N to 1 Percentile", "0", 1.0, 4.0);
+    testNto2Select("N to 1 Percentile", "100", 3.0, 4.0);
+    testNto2Select("N to 1 RMS", "50", sqrt(14.0 / 3), 4.0);
     return testDone();
 }
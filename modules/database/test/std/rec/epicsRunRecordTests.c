@@ -15,8 +15,10 @@
 
 int analogMonitorTest(void);
 int compressTest(void);
+int histogramTest(void);
 int recMiscTest(void);
 int arrayOpTest(void);
+int parallelInitTest(void);
 int asTest(void);
 int linkRetargetLinkTest(void);
 int linkInitTest(void);
@@ -37,9 +39,12 @@ void epicsRunRecordTests(void)
 
     runTest(compressTest);
 
+    runTest(histogramTest);
+
     runTest(recMiscTest);
 
     runTest(arrayOpTest);
+    runTest(parallelInitTest);
 
     runTest(asTest);
 
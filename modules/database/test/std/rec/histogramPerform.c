@@ -0,0 +1,118 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Histogram binning rate.
+ *
+ * A waveform of NSAM random values is binned into NELM bins by a
+ * histogram record in array input mode, with and without running
+ * statistics.  For comparison the same values are also written one
+ * at a time to the SGNL field of a scalar histogram record.
+ */
+
+#include <stdlib.h>
+
+#include "dbDefs.h"
+#include "epicsTime.h"
+#include "dbAccess.h"
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+#include "histogramRecord.h"
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+#define NSAM 65536
+#define NELM 4096
+#define NPASS 100
+
+static double samples[NSAM];
+
+static void report(const char *what, const epicsTimeStamp *t0,
+    unsigned long nsamp)
+{
+    epicsTimeStamp t1;
+    double elapsed;
+
+    epicsTimeGetCurrent(&t1);
+    elapsed = epicsTimeDiffInSeconds(&t1, t0);
+    testDiag("%-28s %9lu samples in %.3f sec (%.1f Msamples/s)",
+             what, nsamp, elapsed, nsamp / elapsed / 1e6);
+}
+
+static void timeArray(histogramRecord *prec, int stats)
+{
+    epicsTimeStamp t0;
+    unsigned pass;
+
+    dbScanLock((dbCommon *)prec);
+    prec->rsts = stats;
+    epicsTimeGetCurrent(&t0);
+    for (pass = 0; pass < NPASS; pass++)
+        dbProcess((dbCommon *)prec);
+    report(stats ? "array input, statistics" : "array input", &t0,
+           (unsigned long)NPASS * NSAM);
+    dbScanUnlock((dbCommon *)prec);
+}
+
+static void timeScalar(void)
+{
+    epicsTimeStamp t0;
+    DBADDR addr;
+    unsigned i;
+
+    if (dbNameToAddr("scalar.SGNL", &addr))
+        testAbort("No scalar.SGNL");
+
+    epicsTimeGetCurrent(&t0);
+    for (i = 0; i < NSAM; i++)
+        dbPutField(&addr, DBR_DOUBLE, &samples[i], 1);
+    report("scalar SGNL puts", &t0, NSAM);
+}
+
+MAIN(histogramPerform)
+{
+    histogramRecord *prec;
+    epicsUInt32 *bins;
+    epicsUInt64 total = 0;
+    unsigned i;
+
+    testPlan(2);
+
+    testdbPrepare();
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("histogramTest.db", NULL,
+                       "NSAM=65536,NELM=4096,ULIM=1.0");
+
+    testIocInitOk();
+
+    /* about 1% of the values fall outside the histogram range */
+    srand(42);
+    for (i = 0; i < NSAM; i++)
+        samples[i] = rand() / (RAND_MAX + 1.0) * 1.01;
+    testdbPutArrFieldOk("src", DBR_DOUBLE, NSAM, samples);
+
+    prec = (histogramRecord *)testdbRecordPtr("hist");
+    timeArray(prec, 0);
+    timeArray(prec, 1);
+    timeScalar();
+
+    dbScanLock((dbCommon *)prec);
+    bins = prec->bptr;
+    for (i = 0; i < NELM; i++)
+        total += bins[i];
+    testDiag("%llu of %lu samples binned",
+             (unsigned long long)total, 2ul * NPASS * NSAM);
+    testOk(prec->scnt == (epicsUInt64)NPASS * NSAM,
+           "SCNT %llu", (unsigned long long)prec->scnt);
+    dbScanUnlock((dbCommon *)prec);
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
@@ -0,0 +1,157 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+#include "dbAccess.h"
+#include "epicsMath.h"
+
+#include "histogramRecord.h"
+
+#define testDEq(A,B,D) testOk(fabs((A)-(B))<(D), #A " (%f) ~= " #B " (%f)", A, B)
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+static
+void testScalarBins(void)
+{
+    static const epicsUInt32 expect[10] = {2, 1, 2, 0, 0, 0, 0, 0, 0, 1};
+    static const double sgnl[] = {0.0, 1.0, 1.5, 2.5, 3.0, 9.99, 10.0, -1.0};
+    unsigned i;
+
+    testDiag("Bin edges of single values written to SGNL");
+
+    for (i = 0; i < NELEMENTS(sgnl); i++)
+        testdbPutFieldOk("scalar.SGNL", DBR_DOUBLE, sgnl[i]);
+
+    testdbGetArrFieldEqual("scalar", DBF_ULONG, 10, 10, expect);
+    testdbGetFieldEqual("scalar.MCNT", DBR_SHORT, 6);
+}
+
+/* Values on and either side of each bin edge, and a sweep of the range,
+ * must land where the original linear search put them.
+ */
+static
+void testBinEdges(void)
+{
+    histogramRecord *prec = (histogramRecord *)testdbRecordPtr("edges");
+    double samples[2100];
+    epicsUInt32 expect[17] = {0};
+    double llim, wdth;
+    int nelm, i, k, n = 0;
+
+    testDiag("Bin edges with an inexact bin width");
+
+    dbScanLock((dbCommon *)prec);
+    llim = prec->llim;
+    wdth = prec->wdth;
+    nelm = prec->nelm;
+    dbScanUnlock((dbCommon *)prec);
+
+    for (k = 0; k <= nelm; k++) {
+        double edge = llim + k * wdth;
+
+        samples[n++] = edge;
+        samples[n++] = nextafter(edge, edge - 1.0);
+        samples[n++] = nextafter(edge, edge + 1.0);
+    }
+    while (n < NELEMENTS(samples)) {
+        samples[n] = llim + (n - 3 * (nelm + 1)) * (wdth * nelm / 2000.0);
+        n++;
+    }
+
+    for (i = 0; i < n; i++) {
+        double temp = samples[i] - llim;
+
+        if (samples[i] < llim || samples[i] >= prec->ulim)
+            continue;
+        for (k = 1; k < nelm; k++)
+            if (temp <= k * wdth)
+                break;
+        expect[k - 1]++;
+    }
+
+    testdbPutArrFieldOk("esrc", DBR_DOUBLE, n, samples);
+    testdbPutFieldOk("edges.PROC", DBR_LONG, 0);
+    testdbGetArrFieldEqual("edges", DBF_ULONG, 17, 17, expect);
+}
+
+static
+void testArrayInput(void)
+{
+    static const epicsUInt32 expect[10] = {2, 1, 0, 0, 0, 1, 0, 0, 0, 1};
+    static const epicsUInt32 zeros[10];
+    double samples[8];
+    histogramRecord *prec = (histogramRecord *)testdbRecordPtr("hist");
+
+    testDiag("Array input with running statistics");
+
+    samples[0] = 0.5;
+    samples[1] = 1.0;
+    samples[2] = 1.5;
+    samples[3] = epicsNAN;
+    samples[4] = 9.5;
+    samples[5] = 10.0;
+    samples[6] = -1.0;
+    samples[7] = 5.5;
+
+    testdbPutArrFieldOk("src", DBR_DOUBLE, NELEMENTS(samples), samples);
+    testdbPutFieldOk("hist.PROC", DBR_LONG, 0);
+
+    testdbGetArrFieldEqual("hist", DBF_ULONG, 10, 10, expect);
+    testdbGetFieldEqual("hist.NORD", DBR_ULONG, 8);
+    testdbGetFieldEqual("hist.SGNL", DBR_DOUBLE, 5.5);
+    testdbGetFieldEqual("hist.SCNT", DBR_ULONG, 7);
+
+    dbScanLock((dbCommon *)prec);
+    testDEq(prec->mean, 27.0 / 7, 1e-9);
+    testDEq(prec->rms, sqrt(225.0 / 7), 1e-9);
+    testDEq(prec->smin, -1.0, 1e-9);
+    testDEq(prec->smax, 10.0, 1e-9);
+    dbScanUnlock((dbCommon *)prec);
+
+    testDiag("Stopped collection ignores input");
+    testdbPutFieldOk("hist.CMD", DBR_STRING, "Stop");
+    testdbPutFieldOk("hist.PROC", DBR_LONG, 0);
+    testdbGetArrFieldEqual("hist", DBF_ULONG, 10, 10, expect);
+    testdbGetFieldEqual("hist.SCNT", DBR_ULONG, 7);
+
+    testDiag("Clear resets the statistics");
+    testdbPutFieldOk("hist.CMD", DBR_STRING, "Clear");
+    testdbGetArrFieldEqual("hist", DBF_ULONG, 10, 10, zeros);
+    testdbGetFieldEqual("hist.SCNT", DBR_ULONG, 0);
+    testdbGetFieldEqual("hist.MEAN", DBR_DOUBLE, 0.0);
+
+    testDiag("Partial array");
+    testdbPutFieldOk("hist.CMD", DBR_STRING, "Start");
+    testdbPutArrFieldOk("src", DBR_DOUBLE, 2, samples);
+    testdbPutFieldOk("hist.PROC", DBR_LONG, 0);
+    testdbGetFieldEqual("hist.NORD", DBR_ULONG, 2);
+    testdbGetFieldEqual("hist.SCNT", DBR_ULONG, 2);
+    testdbGetFieldEqual("hist.MEAN", DBR_DOUBLE, 0.75);
+    testdbGetFieldEqual("hist.SMAX", DBR_DOUBLE, 1.0);
+}
+
+MAIN(histogramTest)
+{
+    testPlan(38);
+
+    testdbPrepare();
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+    testdbReadDatabase("histogramTest.db", NULL, NULL);
+
+    testIocInitOk();
+
+    testScalarBins();
+    testBinEdges();
+    testArrayInput();
+
+    testIocShutdownOk();
+    testdbCleanup();
+
+    return testDone();
+}
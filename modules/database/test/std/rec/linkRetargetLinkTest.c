@@ -14,6 +14,7 @@
 
 #include <string.h>
 
+#include "alarm.h"
 #include "dbAccess.h"
 
 #include "dbUnitTest.h"
@@ -89,9 +90,45 @@ static void testRetargetJLink(void)
     testLongStrEq("rec:j1.INP$", "{calc:{expr:'A+5',args:[{const:7}]}}");
 }
 
+/* DB link fetch plans must follow changes of link target */
+static void testRetargetCalc(void)
+{
+    testDiag("In testRetargetCalc");
+
+    /* A + B + C = 1 + 5 + 2 */
+    testdbPutFieldOk("rec:calc.PROC", DBF_LONG, 1);
+    testdbGetFieldEqual("rec:calc", DBF_DOUBLE, 8.0);
+
+    /* scalar to scalar */
+    testdbPutFieldOk("rec:calc.INPA", DBF_STRING, "rec:src2 NPP");
+    testdbPutFieldOk("rec:calc.PROC", DBF_LONG, 1);
+    testdbGetFieldEqual("rec:calc", DBF_DOUBLE, 9.0);
+
+    /* DBF_MENU field, read as its index */
+    testdbPutFieldOk("rec:calc.INPA", DBF_STRING, "rec:src2.SCAN NPP");
+    testdbPutFieldOk("rec:calc.PROC", DBF_LONG, 1);
+    testdbGetFieldEqual("rec:calc", DBF_DOUBLE, 7.0);
+
+    /* scalar read through a filter */
+    testdbPutFieldOk("rec:calc.INPA", DBF_STRING, "rec:src1.{\"dbnd\":{\"d\":0}} NPP");
+    testdbPutFieldOk("rec:calc.PROC", DBF_LONG, 1);
+    testdbGetFieldEqual("rec:calc", DBF_DOUBLE, 8.0);
+
+    /* failed conversion raises a link alarm */
+    testdbPutFieldOk("rec:calc.INPA", DBF_STRING, "rec:src1.DESC NPP");
+    testdbPutFieldOk("rec:calc.PROC", DBF_LONG, 1);
+    testdbGetFieldEqual("rec:calc.STAT", DBF_LONG, LINK_ALARM);
+    testdbGetFieldEqual("rec:calc.SEVR", DBF_LONG, INVALID_ALARM);
+
+    testdbPutFieldOk("rec:calc.INPA", DBF_STRING, "rec:src1 NPP");
+    testdbPutFieldOk("rec:calc.PROC", DBF_LONG, 1);
+    testdbGetFieldEqual("rec:calc", DBF_DOUBLE, 8.0);
+    testdbGetFieldEqual("rec:calc.SEVR", DBF_LONG, NO_ALARM);
+}
+
 MAIN(linkRetargetLinkTest)
 {
-    testPlan(18);
+    testPlan(37);
 
     testdbPrepare();
 
@@ -114,6 +151,7 @@ MAIN(linkRetargetLinkTest)
 
     testRetarget();
     testRetargetJLink();
+    testRetargetCalc();
 
     testIocShutdownOk();
 
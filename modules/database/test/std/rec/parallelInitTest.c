@@ -0,0 +1,115 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Records initialized by a pool of worker threads must end up the same as
+ * records initialized serially, whether or not their record and device
+ * support are declared thread-safe.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dbDefs.h"
+#include "epicsStdio.h"
+#include "epicsTempFile.h"
+#include "dbAccess.h"
+#include "dbStaticLib.h"
+#include "iocInit.h"
+#include "errlog.h"
+
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+#define NREC 500
+
+static void loadRecords(void)
+{
+    FILE *fp = epicsTempFile();
+    int i;
+
+    if (!fp)
+        testAbort("Can't create temporary file");
+
+    for (i = 0; i < NREC; i++) {
+        /* thread-safe types and device support */
+        fprintf(fp, "record(ai, \"ai%d\") {field(INP, \"%d.5\")}\n", i, i);
+        fprintf(fp, "record(longout, \"lo%d\") {field(DOL, \"%d\")"
+                    " field(OUT, \"ai%d PP\")}\n", i, i, i);
+        fprintf(fp, "record(stringin, \"si%d\") {field(INP, \"%d\")}\n", i, i);
+        /* not thread-safe */
+        fprintf(fp, "record(ai, \"raw%d\") {field(DTYP, \"Raw Soft Channel\")"
+                    " field(INP, \"%d\") field(ASLO, \"2\")}\n", i, i);
+        fprintf(fp, "record(calc, \"calc%d\") {field(CALC, \"A*2\")"
+                    " field(INPA, \"%d\")}\n", i, i);
+    }
+    rewind(fp);
+    if (dbReadDatabaseFP(&pdbbase, fp, NULL, NULL))
+        testAbort("Failed to load records");
+}
+
+static long getField(const char *fmt, int i, short dbrType, void *pbuffer)
+{
+    char name[40];
+    DBADDR addr;
+
+    epicsSnprintf(name, sizeof(name), fmt, i);
+    return dbNameToAddr(name, &addr) ||
+        dbGetField(&addr, dbrType, pbuffer, NULL, NULL, NULL);
+}
+
+static void checkRecords(void)
+{
+    int i, ok = 1;
+
+    for (i = 0; i < NREC && ok; i++) {
+        char sval[MAX_STRING_SIZE], expect[MAX_STRING_SIZE];
+        double dval;
+        epicsInt32 lval;
+
+        ok &= !getField("ai%d", i, DBR_DOUBLE, &dval) && dval == i + 0.5;
+        ok &= !getField("lo%d", i, DBR_LONG, &lval) && lval == i;
+        epicsSnprintf(expect, sizeof(expect), "%d", i);
+        ok &= !getField("si%d", i, DBR_STRING, sval) && !strcmp(sval, expect);
+        ok &= !getField("raw%d.RVAL", i, DBR_LONG, &lval) && lval == i;
+        ok &= !getField("calc%d.A", i, DBR_DOUBLE, &dval) && dval == i;
+        if (!ok)
+            testDiag("Records number %d not initialized correctly", i);
+    }
+    testOk(ok, "All %d sets of records initialized", NREC);
+}
+
+static void testInit(int nthreads)
+{
+    testDiag("dbInitRecordThreads = %d", nthreads);
+
+    testdbPrepare();
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+    loadRecords();
+
+    dbInitRecordThreads = nthreads;
+    dbInitRecordTiming = nthreads != 0;
+    testIocInitOk();
+    dbInitRecordThreads = 0;
+    dbInitRecordTiming = 0;
+
+    checkRecords();
+
+    testIocShutdownOk();
+    testdbCleanup();
+}
+
+MAIN(parallelInitTest)
+{
+    testPlan(3);
+    testInit(0);
+    testInit(4);
+    testInit(-1);
+    return testDone();
+}
@@ -478,6 +478,57 @@ static void test_sizv(void){
     // number of tests = 6
 }
 
+static void test_star_width(void){
+
+    const char format_string[] = "Width %*d!";
+    const char result_string[] = "Width    42!";
+
+    /* set format string */
+    testdbPutFieldOk("test_printf_rec.FMT", DBF_STRING, format_string);
+
+    /* set width on inp0 */
+    testdbPutFieldOk("test_printf_inp0_rec.VAL", DBF_SHORT, 5);
+
+    /* set value on inp1 */
+    testdbPutFieldOk("test_printf_inp1_rec.VAL", DBF_STRING, "42");
+
+    /* verify that string is formatted as expected */
+    testdbGetFieldEqual("test_printf_rec.VAL", DBF_STRING, result_string);
+
+    // number of tests = 4
+}
+
+static void test_s_width(void){
+
+    const char format_string[] = "%d %-12s|";
+    const char result_string[] = "5 Molly III   |";
+
+    /* set format string */
+    testdbPutFieldOk("test_printf_rec.FMT", DBF_STRING, format_string);
+
+    /* set value on inp1 */
+    testdbPutFieldOk("test_printf_inp1_rec.VAL", DBF_STRING, "Molly III");
+
+    /* verify that string is formatted as expected */
+    testdbGetFieldEqual("test_printf_rec.VAL", DBF_STRING, result_string);
+
+    // number of tests = 3
+}
+
+static void test_bad_format(void){
+
+    const char format_string[] = "Bad %q format";
+    const char result_string[] = "Bad %q format";
+
+    /* set format string, the record processes */
+    testdbPutFieldOk("test_printf_rec.FMT", DBF_STRING, format_string);
+
+    /* verify that the bad directive is copied */
+    testdbGetFieldEqual("test_printf_rec.VAL", DBF_STRING, result_string);
+
+    // number of tests = 2
+}
+
 static void test_all_inputs(void){
 
     const char format_string[] = "%d %s %i %i %i %i %i %i %i %i";
@@ -530,7 +581,7 @@ MAIN(printfTest) {
 #endif
 #endif
 
-    testPlan(3+3+3+3+3+3+3+3+4+3+3+3+3+3+3+3+3+3+3+3+3+3+3+3+6+6+12);
+    testPlan(3+3+3+3+3+3+3+3+4+3+3+3+3+3+3+3+3+3+3+3+3+3+3+3+6+6+4+3+2+12);
 
     testdbPrepare();   
     testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
@@ -568,6 +619,9 @@ MAIN(printfTest) {
     test_l_flag();
     test_ll_flag();
     test_sizv();
+    test_star_width();
+    test_s_width();
+    test_bad_format();
     test_all_inputs();
 
     testIocShutdownOk();
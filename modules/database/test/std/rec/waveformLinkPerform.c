@@ -0,0 +1,113 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Waveform to waveform DB link throughput.
+ *
+ * A waveform record reads another waveform of NELM elements through its
+ * INP link on every process.  Each case is timed with the source and
+ * destination FTVL the same, when dbGet() copies the array unconverted,
+ * and with different FTVLs, when every element is converted.
+ */
+
+#include <stdlib.h>
+
+#include "dbDefs.h"
+#include "epicsStdio.h"
+#include "epicsTime.h"
+#include "dbAccess.h"
+#include "dbUnitTest.h"
+#include "testMain.h"
+
+#include "waveformRecord.h"
+
+void recTestIoc_registerRecordDeviceDriver(struct dbBase *);
+
+/* Elements copied per case */
+#define NTOTAL 100000000ul
+
+static const unsigned long sizes[] = {16, 1024, 65536};
+
+static const struct {
+    const char *stype, *dtype;
+} types[] = {
+    {"DOUBLE", "DOUBLE"},
+    {"LONG",   "LONG"},
+    {"CHAR",   "CHAR"},
+    {"DOUBLE", "FLOAT"},
+    {"LONG",   "DOUBLE"},
+    {"SHORT",  "LONG"},
+};
+
+static void loadCase(unsigned i, unsigned long nelm)
+{
+    char macros[80];
+
+    epicsSnprintf(macros, sizeof(macros), "P=c%u:%lu:,STYPE=%s,DTYPE=%s,NELM=%lu",
+                  i, nelm, types[i].stype, types[i].dtype, nelm);
+    testdbReadDatabase("waveformLinkPerform.db", NULL, macros);
+}
+
+static void timeCase(unsigned i, unsigned long nelm, const double *values)
+{
+    char name[40];
+    waveformRecord *prec;
+    epicsTimeStamp t0, t1;
+    unsigned long pass, npass = NTOTAL / nelm;
+    double elapsed;
+
+    epicsSnprintf(name, sizeof(name), "c%u:%lu:src", i, nelm);
+    testdbPutArrFieldOk(name, DBR_DOUBLE, nelm, values);
+
+    epicsSnprintf(name, sizeof(name), "c%u:%lu:dst", i, nelm);
+    prec = (waveformRecord *) testdbRecordPtr(name);
+
+    dbScanLock((dbCommon *) prec);
+    epicsTimeGetCurrent(&t0);
+    for (pass = 0; pass < npass; pass++)
+        dbProcess((dbCommon *) prec);
+    epicsTimeGetCurrent(&t1);
+    dbScanUnlock((dbCommon *) prec);
+
+    elapsed = epicsTimeDiffInSeconds(&t1, &t0);
+    testOk(prec->nord == nelm, "%s NORD %lu", name, (unsigned long) prec->nord);
+    testDiag("%6s -> %-6s %6lu elements: %8.3f usec/process, %7.1f Melements/s",
+             types[i].stype, types[i].dtype, nelm, elapsed * 1e6 / npass,
+             npass * nelm / elapsed / 1e6);
+}
+
+MAIN(waveformLinkPerform)
+{
+    unsigned long maxelm = sizes[NELEMENTS(sizes) - 1];
+    double *values = calloc(maxelm, sizeof(double));
+    unsigned i, j;
+
+    testPlan(2 * NELEMENTS(types) * NELEMENTS(sizes));
+
+    if (!values)
+        testAbort("Can't allocate %lu values", maxelm);
+    for (i = 0; i < maxelm; i++)
+        values[i] = i % 100;
+
+    testdbPrepare();
+    testdbReadDatabase("recTestIoc.dbd", NULL, NULL);
+    recTestIoc_registerRecordDeviceDriver(pdbbase);
+    for (i = 0; i < NELEMENTS(types); i++)
+        for (j = 0; j < NELEMENTS(sizes); j++)
+            loadCase(i, sizes[j]);
+
+    testIocInitOk();
+
+    for (i = 0; i < NELEMENTS(types); i++)
+        for (j = 0; j < NELEMENTS(sizes); j++)
+            timeCase(i, sizes[j], values);
+
+    testIocShutdownOk();
+    testdbCleanup();
+    free(values);
+
+    return testDone();
+}
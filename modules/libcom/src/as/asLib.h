@@ -218,7 +218,22 @@ typedef struct asg{
     double          *pavalue;   /*pointer to array of input values*/
     unsigned long   inpBad;     /*bitmap of which inputs are bad*/
     unsigned long   inpChanged; /*bitmap of inputs that changed*/
+    ELLLIST         classList;  /*list of ASGCLASS*/
+    unsigned long   inpBadSeen; /*inpBad when the classes were last updated*/
 } ASG;
+/*Clients of an ASG with the same user, host and level share a class*/
+typedef struct asgClass {
+    ELLNODE         node;
+    struct asg      *pasg;
+    ELLLIST         clientList; /*list of ASGCLIENT, linked by classNode*/
+    char            *user;
+    char            *host;
+    int             level;
+    asAccessRights  access;
+    int             trapMask;
+    char            *ruleMatch; /*per rule, TRUE if level, UAG and HAG match*/
+    unsigned long   inpUsed;    /*inputs used by the CALCs of matching rules*/
+} ASGCLASS;
 typedef struct asgMember {
     ELLNODE         node;
     ASG             *pasg;
@@ -237,6 +252,8 @@ typedef struct asgClient {
     int             level;
     asAccessRights  access;
     int             trapMask;
+    ASGCLASS        *pclass;
+    ELLNODE         classNode;
 } ASGCLIENT;
 
 LIBCOM_API long epicsStdCall asComputeAsg(ASG *pasg);
@@ -53,8 +53,13 @@ static int myParse(ASINPUTFUNCPTR inputfunction);
 /*private routines */
 static long asAddMemberPvt(ASMEMBERPVT *pasMemberPvt,const char *asgName);
 static long asComputeAllAsgPvt(void);
-static long asComputeAsgPvt(ASG *pasg);
+static long asComputeAsgPvt(ASG *pasg,int all);
 static long asComputePvt(ASCLIENTPVT asClientPvt);
+static void asClassAttach(ASGCLIENT *pasgclient,ASG *pasg);
+static void asClassDetach(ASGCLIENT *pasgclient);
+static void asClassUpdate(ASGCLASS *pclass);
+static void asClassAccess(ASGCLASS *pclass,
+    asAccessRights *paccess,int *ptrapMask);
 static UAG *asUagAdd(const char *uagName);
 static long asUagAddUser(UAG *puag,const char *user);
 static HAG *asHagAdd(const char *hagName);
@@ -403,6 +408,7 @@ long epicsStdCall asChangeClient(
         host[i] = (char)tolower((int)host[i]);
     }
     LOCK;
+    asClassDetach(pasgclient);
     pasgclient->level = asl;
     pasgclient->user = user;
     pasgclient->host = host;
@@ -426,6 +432,7 @@ long epicsStdCall asRemoveClient(ASCLIENTPVT *asClientPvt)
         return(-1);
     }
     ellDelete(&pasgMember->clientList,&pasgclient->node);
+    asClassDetach(pasgclient);
     UNLOCK;
     freeListFree(freeListPvt,pasgclient);
     *asClientPvt = NULL;
@@ -482,7 +489,7 @@ long epicsStdCall asComputeAsg(ASG *pasg)
 
     if(!asActive) return(S_asLib_asNotActive);
     LOCK;
-    status = asComputeAsgPvt(pasg);
+    status = asComputeAsgPvt(pasg,FALSE);
     UNLOCK;
     return(status);
 }
@@ -825,6 +832,19 @@ int epicsStdCall asDumpMemFP(FILE *fp,const char *asgname,
             continue;
         }
         fprintf(fp,"ASG(%s)\n",pasg->name);
+        if(clients && ellCount(&pasg->classList)>0) {
+            ASGCLASS *pclass = (ASGCLASS *)ellFirst(&pasg->classList);
+
+            fprintf(fp,"\tCLIENTCLASSES\n");
+            while(pclass) {
+                fprintf(fp,"\t\t %s %s ASL%d %s %s clients %d\n",
+                    pclass->user,pclass->host,pclass->level,
+                    asAccessName[pclass->access],
+                    asTrapOption[pclass->trapMask],
+                    ellCount(&pclass->clientList));
+                pclass = (ASGCLASS *)ellNext(&pclass->node);
+            }
+        }
         pasgmember = (ASGMEMBER *)ellFirst(&pasg->memberList);
         if(pasgmember) fprintf(fp,"\tMEMBERLIST\n");
         while(pasgmember) {
@@ -920,6 +940,8 @@ got_it:
     ellAdd(&pgroup->memberList,&pasgmember->node);
     pasgclient = (ASGCLIENT *)ellFirst(&pasgmember->clientList);
     while(pasgclient) {
+        /*The old class may belong to a configuration about to be freed*/
+        asClassDetach(pasgclient);
         asComputePvt((ASCLIENTPVT)pasgclient);
         pasgclient = (ASGCLIENT *)ellNext(&pasgclient->node);
     }
@@ -933,17 +955,19 @@ static long asComputeAllAsgPvt(void)
     if(!asActive) return(S_asLib_asNotActive);
     pasg = (ASG *)ellFirst(&pasbase->asgList);
     while(pasg) {
-        asComputeAsgPvt(pasg);
+        asComputeAsgPvt(pasg,TRUE);
         pasg = (ASG *)ellNext(&pasg->node);
     }
     return(0);
 }
 
-static long asComputeAsgPvt(ASG *pasg)
+/*Only the rules and classes which use a changed input are recomputed,
+ *unless all is set*/
+static long asComputeAsgPvt(ASG *pasg,int all)
 {
     ASGRULE     *pasgrule;
-    ASGMEMBER   *pasgmember;
-    ASGCLIENT   *pasgclient;
+    ASGCLASS    *pclass;
+    unsigned long changed;
 
     if(!asActive) return(S_asLib_asNotActive);
     pasgrule = (ASGRULE *)ellFirst(&pasg->ruleList);
@@ -962,29 +986,172 @@ static long asComputeAsgPvt(ASG *pasg)
         }
         pasgrule = (ASGRULE *)ellNext(&pasgrule->node);
     }
+    /*An input going bad or good also changes the rules using it*/
+    changed = pasg->inpChanged | (pasg->inpBad ^ pasg->inpBadSeen);
     pasg->inpChanged = FALSE;
-    pasgmember = (ASGMEMBER *)ellFirst(&pasg->memberList);
-    while(pasgmember) {
-        pasgclient = (ASGCLIENT *)ellFirst(&pasgmember->clientList);
-        while(pasgclient) {
-            asComputePvt((ASCLIENTPVT)pasgclient);
-            pasgclient = (ASGCLIENT *)ellNext(&pasgclient->node);
-        }
-        pasgmember = (ASGMEMBER *)ellNext(&pasgmember->node);
+    pasg->inpBadSeen = pasg->inpBad;
+    if(!changed && !all) return(0);
+    /*Only the clients of classes whose access has changed are visited*/
+    pclass = (ASGCLASS *)ellFirst(&pasg->classList);
+    while(pclass) {
+        if(all || (pclass->inpUsed & changed))
+            asClassUpdate(pclass);
+        pclass = (ASGCLASS *)ellNext(&pclass->node);
     }
     return(0);
 }
-
-static long asComputePvt(ASCLIENTPVT asClientPvt)
+
+/*Check the parts of a rule which depend only on the client*/
+static int asRuleMatch(ASGRULE *pasgrule,const char *user,const char *host,
+    int level)
 {
+    if(level > pasgrule->level) return(FALSE);
+    /*if uagList is empty then no need to check uag*/
+    if(ellCount(&pasgrule->uagList)>0){
+        ASGUAG      *pasguag;
+        UAG         *puag;
+
+        pasguag = (ASGUAG *)ellFirst(&pasgrule->uagList);
+        while(pasguag) {
+            if((puag = pasguag->puag)) {
+                if(gphFind(pasbase->phash,user,puag)) break;
+            }
+            pasguag = (ASGUAG *)ellNext(&pasguag->node);
+        }
+        if(!pasguag) return(FALSE);
+    }
+    /*if hagList is empty then no need to check hag*/
+    if(ellCount(&pasgrule->hagList)>0) {
+        ASGHAG      *pasghag;
+        HAG         *phag;
+
+        pasghag = (ASGHAG *)ellFirst(&pasgrule->hagList);
+        while(pasghag) {
+            if((phag = pasghag->phag)) {
+                if(gphFind(pasbase->phash,host,phag)) break;
+            }
+            pasghag = (ASGHAG *)ellNext(&pasghag->node);
+        }
+        if(!pasghag) return(FALSE);
+    }
+    return(TRUE);
+}
+
+static void asClassAccess(ASGCLASS *pclass,
+    asAccessRights *paccess,int *ptrapMask)
+{
+    ASG                 *pasg = pclass->pasg;
+    ASGRULE             *pasgrule;
     asAccessRights      access=asNOACCESS;
     int                 trapMask=0;
+    int                 i = 0;
+
+    pasgrule = (ASGRULE *)ellFirst(&pasg->ruleList);
+    while(pasgrule) {
+        if(access == asWRITE) break;
+        if(access<pasgrule->access && pclass->ruleMatch[i]
+        && (!pasgrule->calc
+           || (!(pasg->inpBad & pasgrule->inpUsed) && (pasgrule->result==1)))) {
+            access = pasgrule->access;
+            trapMask = pasgrule->trapMask;
+        }
+        pasgrule = (ASGRULE *)ellNext(&pasgrule->node);
+        i++;
+    }
+    *paccess = access;
+    *ptrapMask = trapMask;
+}
+
+/*Recompute a class, passing any change on to its clients*/
+static void asClassUpdate(ASGCLASS *pclass)
+{
+    asAccessRights  access;
+    int             trapMask;
+    ELLNODE         *pnode;
+
+    asClassAccess(pclass,&access,&trapMask);
+    if(access==pclass->access && trapMask==pclass->trapMask) return;
+    pclass->access = access;
+    pclass->trapMask = trapMask;
+    pnode = ellFirst(&pclass->clientList);
+    while(pnode) {
+        ASGCLIENT       *pasgclient = CONTAINER(pnode,ASGCLIENT,classNode);
+        asAccessRights  oldaccess = pasgclient->access;
+
+        pnode = ellNext(pnode);
+        pasgclient->access = access;
+        pasgclient->trapMask = trapMask;
+        if(pasgclient->pcallback && oldaccess!=access) {
+            (*pasgclient->pcallback)(pasgclient,asClientCOAR);
+        }
+    }
+}
+
+/*Find or create the class for the client's user, host and level*/
+static void asClassAttach(ASGCLIENT *pasgclient,ASG *pasg)
+{
+    const char  *user = pasgclient->user ? pasgclient->user : "";
+    const char  *host = pasgclient->host ? pasgclient->host : "";
+    ASGCLASS    *pclass;
+
+    pclass = (ASGCLASS *)ellFirst(&pasg->classList);
+    while(pclass) {
+        if(pclass->level==pasgclient->level
+        && strcmp(pclass->user,user)==0
+        && strcmp(pclass->host,host)==0) break;
+        pclass = (ASGCLASS *)ellNext(&pclass->node);
+    }
+    if(!pclass) {
+        int         nrules = ellCount(&pasg->ruleList);
+        ASGRULE     *pasgrule;
+        int         i = 0;
+
+        pclass = asCalloc(1,sizeof(ASGCLASS) + nrules
+            + strlen(user) + 1 + strlen(host) + 1);
+        pclass->pasg = pasg;
+        ellInit(&pclass->clientList);
+        pclass->level = pasgclient->level;
+        pclass->ruleMatch = (char *)(pclass+1);
+        pclass->user = pclass->ruleMatch + nrules;
+        strcpy(pclass->user,user);
+        pclass->host = pclass->user + strlen(user) + 1;
+        strcpy(pclass->host,host);
+        pasgrule = (ASGRULE *)ellFirst(&pasg->ruleList);
+        while(pasgrule) {
+            pclass->ruleMatch[i] = (char)asRuleMatch(pasgrule,user,host,
+                pclass->level);
+            if(pclass->ruleMatch[i] && pasgrule->calc)
+                pclass->inpUsed |= pasgrule->inpUsed;
+            pasgrule = (ASGRULE *)ellNext(&pasgrule->node);
+            i++;
+        }
+        asClassAccess(pclass,&pclass->access,&pclass->trapMask);
+        ellAdd(&pasg->classList,&pclass->node);
+    }
+    ellAdd(&pclass->clientList,&pasgclient->classNode);
+    pasgclient->pclass = pclass;
+}
+
+static void asClassDetach(ASGCLIENT *pasgclient)
+{
+    ASGCLASS    *pclass = pasgclient->pclass;
+
+    if(!pclass) return;
+    ellDelete(&pclass->clientList,&pasgclient->classNode);
+    pasgclient->pclass = NULL;
+    if(ellCount(&pclass->clientList)==0) {
+        ellDelete(&pclass->pasg->classList,&pclass->node);
+        free(pclass);
+    }
+}
+
+static long asComputePvt(ASCLIENTPVT asClientPvt)
+{
     ASGCLIENT           *pasgclient = asClientPvt;
     ASGMEMBER           *pasgMember;
     ASG                 *pasg;
-    ASGRULE             *pasgrule;
+    ASGCLASS            *pclass;
     asAccessRights      oldaccess;
-    GPHENTRY            *pgphentry;
 
     if(!asActive) return(S_asLib_asNotActive);
     if(!pasgclient) return(S_asLib_badClient);
@@ -992,60 +1159,22 @@ static long asComputePvt(ASCLIENTPVT asClientPvt)
     if(!pasgMember) return(S_asLib_badMember);
     pasg = pasgMember->pasg;
     if(!pasg) return(S_asLib_badAsg);
-    oldaccess=pasgclient->access;
-    pasgrule = (ASGRULE *)ellFirst(&pasg->ruleList);
-    while(pasgrule) {
-        if(access == asWRITE) break;
-        if(access>=pasgrule->access) goto next_rule;
-        if(pasgclient->level > pasgrule->level) goto next_rule;
-        /*if uagList is empty then no need to check uag*/
-        if(ellCount(&pasgrule->uagList)>0){
-            ASGUAG      *pasguag;
-            UAG         *puag;
-
-            pasguag = (ASGUAG *)ellFirst(&pasgrule->uagList);
-            while(pasguag) {
-                if((puag = pasguag->puag)) {
-                    pgphentry = gphFind(pasbase->phash,pasgclient->user,puag);
-                    if(pgphentry) goto check_hag;
-                }
-                pasguag = (ASGUAG *)ellNext(&pasguag->node);
-            }
-            goto next_rule;
-        }
-check_hag:
-        /*if hagList is empty then no need to check hag*/
-        if(ellCount(&pasgrule->hagList)>0) {
-            ASGHAG      *pasghag;
-            HAG         *phag;
-
-            pasghag = (ASGHAG *)ellFirst(&pasgrule->hagList);
-            while(pasghag) {
-                if((phag = pasghag->phag)) {
-                    pgphentry=gphFind(pasbase->phash,pasgclient->host,phag);
-                    if(pgphentry) goto check_calc;
-                }
-                pasghag = (ASGHAG *)ellNext(&pasghag->node);
-            }
-            goto next_rule;
-        }
-check_calc:
-        if(!pasgrule->calc
-        || (!(pasg->inpBad & pasgrule->inpUsed) && (pasgrule->result==1))) {
-            access = pasgrule->access;
-            trapMask = pasgrule->trapMask;
-        }
-next_rule:
-        pasgrule = (ASGRULE *)ellNext(&pasgrule->node);
-    }
-    pasgclient->access = access;
-    pasgclient->trapMask = trapMask;
-    if(pasgclient->pcallback && oldaccess!=access) {
+    if(pasgclient->pclass && pasgclient->pclass->pasg!=pasg)
+        asClassDetach(pasgclient);
+    if(!pasgclient->pclass)
+        asClassAttach(pasgclient,pasg);
+    pclass = pasgclient->pclass;
+    /*May update this client along with the rest of its class*/
+    asClassUpdate(pclass);
+    oldaccess = pasgclient->access;
+    pasgclient->access = pclass->access;
+    pasgclient->trapMask = pclass->trapMask;
+    if(pasgclient->pcallback && oldaccess!=pclass->access) {
         (*pasgclient->pcallback)(pasgclient,asClientCOAR);
     }
     return(0);
 }
-
+
 void asFreeAll(ASBASE *pasbase)
 {
     UAG         *puag;
@@ -1057,6 +1186,7 @@ void asFreeAll(ASBASE *pasbase)
     ASGRULE     *pasgrule;
     ASGHAG      *pasghag;
     ASGUAG      *pasguag;
+    ASGCLASS    *pclass;
     void        *pnext;
 
     puag = (UAG *)ellFirst(&pasbase->uagList);
@@ -1120,6 +1250,13 @@ void asFreeAll(ASBASE *pasbase)
             free(pasgrule);
             pasgrule = pnext;
         }
+        pclass = (ASGCLASS *)ellFirst(&pasg->classList);
+        while(pclass) {
+            pnext = ellNext(&pclass->node);
+            ellDelete(&pasg->classList,&pclass->node);
+            free(pclass);
+            pclass = pnext;
+        }
         pnext = ellNext(&pasg->node);
         ellDelete(&pasbase->asgList,&pasg->node);
         free(pasg);
@@ -1274,6 +1411,7 @@ static ASG *asAsgAdd(const char *asgName)
     ellInit(&pasg->inpList);
     ellInit(&pasg->ruleList);
     ellInit(&pasg->memberList);
+    ellInit(&pasg->classList);
     pasg->name = (char *)(pasg+1);
     strcpy(pasg->name,asgName);
     if(pnext==NULL) { /*Add to end of list*/
@@ -33,6 +33,20 @@ static int cond_search(const char **ppinst, int match);
 #define PI 3.14159265358979323
 #endif
 
+/* With GNU C compilers the opcodes are dispatched through a table of label
+ * addresses, jumping directly from the end of one instruction to the code
+ * for the next instead of going back through the switch statement. This
+ * gives the branch predictor one indirect jump per opcode to learn.
+ */
+#if defined(__GNUC__) && !defined(CALC_NO_THREADED_DISPATCH)
+#  define THREADED_DISPATCH
+#  define OP(code) case code: L_##code
+#  define NEXT goto *dispatch[(unsigned char) (op = *pinst++)]
+#else
+#  define OP(code) case code
+#  define NEXT break
+#endif
+
 /* Turn off global optimization for 64-bit MSVC builds */
 #if defined(_WIN32) && defined(_M_X64) && !defined(_MINGW)
 #  pragma optimize("g", off)
@@ -52,29 +66,99 @@ LIBCOM_API long
     int op;
     int nargs;
 
+#ifdef THREADED_DISPATCH
+    static const void * const dispatch[256] = {
+        [END_EXPRESSION] = &&L_END_EXPRESSION,
+        [LITERAL_DOUBLE] = &&L_LITERAL_DOUBLE,
+        [LITERAL_INT] = &&L_LITERAL_INT,
+        [FETCH_VAL] = &&L_FETCH_VAL,
+        [FETCH_A ... FETCH_L] = &&L_FETCH_A,
+        [STORE_A ... STORE_L] = &&L_STORE_A,
+        [CONST_PI] = &&L_CONST_PI,
+        [CONST_D2R] = &&L_CONST_D2R,
+        [CONST_R2D] = &&L_CONST_R2D,
+        [UNARY_NEG] = &&L_UNARY_NEG,
+        [ADD] = &&L_ADD,
+        [SUB] = &&L_SUB,
+        [MULT] = &&L_MULT,
+        [DIV] = &&L_DIV,
+        [MODULO] = &&L_MODULO,
+        [POWER] = &&L_POWER,
+        [ABS_VAL] = &&L_ABS_VAL,
+        [EXP] = &&L_EXP,
+        [LOG_10] = &&L_LOG_10,
+        [LOG_E] = &&L_LOG_E,
+        [MAX] = &&L_MAX,
+        [MIN] = &&L_MIN,
+        [SQU_RT] = &&L_SQU_RT,
+        [ACOS] = &&L_ACOS,
+        [ASIN] = &&L_ASIN,
+        [ATAN] = &&L_ATAN,
+        [ATAN2] = &&L_ATAN2,
+        [COS] = &&L_COS,
+        [SIN] = &&L_SIN,
+        [TAN] = &&L_TAN,
+        [COSH] = &&L_COSH,
+        [SINH] = &&L_SINH,
+        [TANH] = &&L_TANH,
+        [CEIL] = &&L_CEIL,
+        [FLOOR] = &&L_FLOOR,
+        [FMOD] = &&L_FMOD,
+        [FINITE] = &&L_FINITE,
+        [ISINF] = &&L_ISINF,
+        [ISNAN] = &&L_ISNAN,
+        [NINT] = &&L_NINT,
+        [RANDOM] = &&L_RANDOM,
+        [REL_OR] = &&L_REL_OR,
+        [REL_AND] = &&L_REL_AND,
+        [REL_NOT] = &&L_REL_NOT,
+        [BIT_OR] = &&L_BIT_OR,
+        [BIT_AND] = &&L_BIT_AND,
+        [BIT_EXCL_OR] = &&L_BIT_EXCL_OR,
+        [BIT_NOT] = &&L_BIT_NOT,
+        [RIGHT_SHIFT_ARITH] = &&L_RIGHT_SHIFT_ARITH,
+        [LEFT_SHIFT_ARITH] = &&L_LEFT_SHIFT_ARITH,
+        [RIGHT_SHIFT_LOGIC] = &&L_RIGHT_SHIFT_LOGIC,
+        [NOT_EQ] = &&L_NOT_EQ,
+        [LESS_THAN] = &&L_LESS_THAN,
+        [LESS_OR_EQ] = &&L_LESS_OR_EQ,
+        [EQUAL] = &&L_EQUAL,
+        [GR_OR_EQ] = &&L_GR_OR_EQ,
+        [GR_THAN] = &&L_GR_THAN,
+        [COND_IF] = &&L_COND_IF,
+        [COND_ELSE] = &&L_COND_ELSE,
+        [COND_END] = &&L_COND_END,
+        [NOT_GENERATED ... 255] = &&L_BAD_OPCODE
+    };
+#endif
+
     /* initialize */
     ptop = stack;
 
+#ifdef THREADED_DISPATCH
+    NEXT;
+#endif
+
     /* RPN evaluation loop */
     while ((op = *pinst++) != END_EXPRESSION){
         switch (op){
 
-        case LITERAL_DOUBLE:
+        OP(LITERAL_DOUBLE):
             memcpy(++ptop, pinst, sizeof(double));
             pinst += sizeof(double);
-            break;
+            NEXT;
 
-        case LITERAL_INT:
+        OP(LITERAL_INT):
             memcpy(&itop, pinst, sizeof(epicsInt32));
             *++ptop = itop;
             pinst += sizeof(epicsInt32);
-            break;
+            NEXT;
 
-        case FETCH_VAL:
+        OP(FETCH_VAL):
             *++ptop = *presult;
-            break;
+            NEXT;
 
-        case FETCH_A:
+        OP(FETCH_A):
         case FETCH_B:
         case FETCH_C:
         case FETCH_D:
@@ -87,9 +171,9 @@ LIBCOM_API long
         case FETCH_K:
         case FETCH_L:
             *++ptop = parg[op - FETCH_A];
-            break;
+            NEXT;
 
-        case STORE_A:
+        OP(STORE_A):
         case STORE_B:
         case STORE_C:
         case STORE_D:
@@ -102,150 +186,150 @@ LIBCOM_API long
         case STORE_K:
         case STORE_L:
             parg[op - STORE_A] = *ptop--;
-            break;
+            NEXT;
 
-        case CONST_PI:
+        OP(CONST_PI):
             *++ptop = PI;
-            break;
+            NEXT;
 
-        case CONST_D2R:
+        OP(CONST_D2R):
             *++ptop = PI/180.;
-            break;
+            NEXT;
 
-        case CONST_R2D:
+        OP(CONST_R2D):
             *++ptop = 180./PI;
-            break;
+            NEXT;
 
-        case UNARY_NEG:
+        OP(UNARY_NEG):
             *ptop = - *ptop;
-            break;
+            NEXT;
 
-        case ADD:
+        OP(ADD):
             top = *ptop--;
             *ptop += top;
-            break;
+            NEXT;
 
-        case SUB:
+        OP(SUB):
             top = *ptop--;
             *ptop -= top;
-            break;
+            NEXT;
 
-        case MULT:
+        OP(MULT):
             top = *ptop--;
             *ptop *= top;
-            break;
+            NEXT;
 
-        case DIV:
+        OP(DIV):
             top = *ptop--;
             *ptop /= top;
-            break;
+            NEXT;
 
-        case MODULO:
+        OP(MODULO):
             itop = (epicsInt32) *ptop--;
             if (itop)
                 *ptop = (epicsInt32) *ptop % itop;
             else
                 *ptop = epicsNAN;
-            break;
+            NEXT;
 
-        case POWER:
+        OP(POWER):
             top = *ptop--;
             *ptop = pow(*ptop, top);
-            break;
+            NEXT;
 
-        case ABS_VAL:
+        OP(ABS_VAL):
             *ptop = fabs(*ptop);
-            break;
+            NEXT;
 
-        case EXP:
+        OP(EXP):
             *ptop = exp(*ptop);
-            break;
+            NEXT;
 
-        case LOG_10:
+        OP(LOG_10):
             *ptop = log10(*ptop);
-            break;
+            NEXT;
 
-        case LOG_E:
+        OP(LOG_E):
             *ptop = log(*ptop);
-            break;
+            NEXT;
 
-        case MAX:
+        OP(MAX):
             nargs = *pinst++;
             while (--nargs) {
                 top = *ptop--;
                 if (*ptop < top || isnan(top))
                     *ptop = top;
             }
-            break;
+            NEXT;
 
-        case MIN:
+        OP(MIN):
             nargs = *pinst++;
             while (--nargs) {
                 top = *ptop--;
                 if (*ptop > top || isnan(top))
                     *ptop = top;
             }
-            break;
+            NEXT;
 
-        case SQU_RT:
+        OP(SQU_RT):
             *ptop = sqrt(*ptop);
-            break;
+            NEXT;
 
-        case ACOS:
+        OP(ACOS):
             *ptop = acos(*ptop);
-            break;
+            NEXT;
 
-        case ASIN:
+        OP(ASIN):
             *ptop = asin(*ptop);
-            break;
+            NEXT;
 
-        case ATAN:
+        OP(ATAN):
             *ptop = atan(*ptop);
-            break;
+            NEXT;
 
-        case ATAN2:
+        OP(ATAN2):
             top = *ptop--;
             *ptop = atan2(top, *ptop);  /* Ouch!: Args backwards! */
-            break;
+            NEXT;
 
-        case COS:
+        OP(COS):
             *ptop = cos(*ptop);
-            break;
+            NEXT;
 
-        case SIN:
+        OP(SIN):
             *ptop = sin(*ptop);
-            break;
+            NEXT;
 
-        case TAN:
+        OP(TAN):
             *ptop = tan(*ptop);
-            break;
+            NEXT;
 
-        case COSH:
+        OP(COSH):
             *ptop = cosh(*ptop);
-            break;
+            NEXT;
 
-        case SINH:
+        OP(SINH):
             *ptop = sinh(*ptop);
-            break;
+            NEXT;
 
-        case TANH:
+        OP(TANH):
             *ptop = tanh(*ptop);
-            break;
+            NEXT;
 
-        case CEIL:
+        OP(CEIL):
             *ptop = ceil(*ptop);
-            break;
+            NEXT;
 
-        case FLOOR:
+        OP(FLOOR):
             *ptop = floor(*ptop);
-            break;
+            NEXT;
 
-        case FMOD:
+        OP(FMOD):
             top = *ptop--;
             *ptop = fmod(*ptop, top);
-            break;
+            NEXT;
 
-        case FINITE:
+        OP(FINITE):
             nargs = *pinst++;
             top = finite(*ptop);
             while (--nargs) {
@@ -253,13 +337,13 @@ LIBCOM_API long
                 top = top && finite(*ptop);
             }
             *ptop = top;
-            break;
+            NEXT;
 
-        case ISINF:
+        OP(ISINF):
             *ptop = isinf(*ptop);
-            break;
+            NEXT;
 
-        case ISNAN:
+        OP(ISNAN):
             nargs = *pinst++;
             top = isnan(*ptop);
             while (--nargs) {
@@ -267,30 +351,30 @@ LIBCOM_API long
                 top = top || isnan(*ptop);
             }
             *ptop = top;
-            break;
+            NEXT;
 
-        case NINT:
+        OP(NINT):
             top = *ptop;
             *ptop = (epicsInt32) (top >= 0 ? top + 0.5 : top - 0.5);
-            break;
+            NEXT;
 
-        case RANDOM:
+        OP(RANDOM):
             *++ptop = calcRandom();
-            break;
+            NEXT;
 
-        case REL_OR:
+        OP(REL_OR):
             top = *ptop--;
             *ptop = *ptop || top;
-            break;
+            NEXT;
 
-        case REL_AND:
+        OP(REL_AND):
             top = *ptop--;
             *ptop = *ptop && top;
-            break;
+            NEXT;
 
-        case REL_NOT:
+        OP(REL_NOT):
             *ptop = ! *ptop;
-            break;
+            NEXT;
 
         /* Be VERY careful converting double to int in case bit 31 is set!
          * Out-of-range errors give very different results on different systems.
@@ -306,24 +390,24 @@ LIBCOM_API long
         #define d2i(x) ((x)<0?(epicsInt32)(x):(epicsInt32)(epicsUInt32)(x))
         #define d2ui(x) ((x)<0?(epicsUInt32)(epicsInt32)(x):(epicsUInt32)(x))
 
-        case BIT_OR:
+        OP(BIT_OR):
             top = *ptop--;
             *ptop = (double)(d2i(*ptop) | d2i(top));
-            break;
+            NEXT;
 
-        case BIT_AND:
+        OP(BIT_AND):
             top = *ptop--;
             *ptop = (double)(d2i(*ptop) & d2i(top));
-            break;
+            NEXT;
 
-        case BIT_EXCL_OR:
+        OP(BIT_EXCL_OR):
             top = *ptop--;
             *ptop = (double)(d2i(*ptop) ^ d2i(top));
-            break;
+            NEXT;
 
-        case BIT_NOT:
+        OP(BIT_NOT):
             *ptop = (double)~d2i(*ptop);
-            break;
+            NEXT;
 
         /* In C the shift operators decide on an arithmetic or logical shift
          * based on whether the integer is signed or unsigned.
@@ -333,68 +417,74 @@ LIBCOM_API long
          * double-casting through signed/unsigned here is important, see above.
          */
 
-        case RIGHT_SHIFT_ARITH:
+        OP(RIGHT_SHIFT_ARITH):
             top = *ptop--;
             *ptop = (double)(d2i(*ptop) >> (d2i(top) & 31));
-            break;
+            NEXT;
 
-        case LEFT_SHIFT_ARITH:
+        OP(LEFT_SHIFT_ARITH):
             top = *ptop--;
             *ptop = (double)(d2i(*ptop) << (d2i(top) & 31));
-            break;
+            NEXT;
 
-        case RIGHT_SHIFT_LOGIC:
+        OP(RIGHT_SHIFT_LOGIC):
             top = *ptop--;
             *ptop = (double)(d2ui(*ptop) >> (d2ui(top) & 31u));
-            break;
+            NEXT;
 
-        case NOT_EQ:
+        OP(NOT_EQ):
             top = *ptop--;
             *ptop = *ptop != top;
-            break;
+            NEXT;
 
-        case LESS_THAN:
+        OP(LESS_THAN):
             top = *ptop--;
             *ptop = *ptop < top;
-            break;
+            NEXT;
 
-        case LESS_OR_EQ:
+        OP(LESS_OR_EQ):
             top = *ptop--;
             *ptop = *ptop <= top;
-            break;
+            NEXT;
 
-        case EQUAL:
+        OP(EQUAL):
             top = *ptop--;
             *ptop = *ptop == top;
-            break;
+            NEXT;
 
-        case GR_OR_EQ:
+        OP(GR_OR_EQ):
             top = *ptop--;
             *ptop = *ptop >= top;
-            break;
+            NEXT;
 
-        case GR_THAN:
+        OP(GR_THAN):
             top = *ptop--;
             *ptop = *ptop > top;
-            break;
+            NEXT;
 
-        case COND_IF:
+        OP(COND_IF):
             if (*ptop-- == 0.0 &&
                 cond_search(&pinst, COND_ELSE)) return -1;
-            break;
+            NEXT;
 
-        case COND_ELSE:
+        OP(COND_ELSE):
             if (cond_search(&pinst, COND_END)) return -1;
-            break;
+            NEXT;
 
-        case COND_END:
-            break;
+        OP(COND_END):
+            NEXT;
 
         default:
+#ifdef THREADED_DISPATCH
+        L_BAD_OPCODE:
+#endif
             errlogPrintf("calcPerform: Bad Opcode %d at %p\n", op, pinst-1);
             return -1;
         }
     }
+#ifdef THREADED_DISPATCH
+L_END_EXPRESSION:
+#endif
 
     /* The stack should now have one item on it, the expression value */
     if (ptop != stack + 1)
@@ -407,6 +497,328 @@ LIBCOM_API long
 #  pragma optimize("", on)
 #endif
 
+/* calcPerformArray
+ *
+ * Evaluate the postfix expression element-wise over arrays. The program
+ * is run over blocks of CALC_BLOCK elements at a time, so the stack
+ * holds a block of partial results per entry and each opcode is a short
+ * loop that the compiler can vectorize. Both branches of a conditional
+ * are evaluated and the results selected element by element, which is
+ * why the condition stays on the stack until the COND_END.
+ */
+
+#define CALC_BLOCK 64
+
+/* Work out the stack depth needed for block evaluation. The postfix()
+ * parser only accepts assignments at the outer level of an expression,
+ * so evaluating both branches of a conditional has no side effects.
+ */
+static int block_depth(const char *pinst)
+{
+    int depth = 0, maxDepth = 0;
+    int op;
+
+    while ((op = *pinst++) != END_EXPRESSION) {
+        switch (op) {
+        case LITERAL_DOUBLE:
+            pinst += sizeof(double);
+            depth++;
+            break;
+        case LITERAL_INT:
+            pinst += sizeof(epicsInt32);
+            depth++;
+            break;
+        case FETCH_VAL:
+        case FETCH_A: case FETCH_B: case FETCH_C: case FETCH_D:
+        case FETCH_E: case FETCH_F: case FETCH_G: case FETCH_H:
+        case FETCH_I: case FETCH_J: case FETCH_K: case FETCH_L:
+        case CONST_PI: case CONST_D2R: case CONST_R2D:
+        case RANDOM:
+            depth++;
+            break;
+        case STORE_A: case STORE_B: case STORE_C: case STORE_D:
+        case STORE_E: case STORE_F: case STORE_G: case STORE_H:
+        case STORE_I: case STORE_J: case STORE_K: case STORE_L:
+            depth--;
+            break;
+        case MIN: case MAX: case FINITE: case ISNAN:
+            depth -= *pinst++ - 1;
+            break;
+        case ADD: case SUB: case MULT: case DIV: case MODULO: case POWER:
+        case ATAN2: case FMOD: case REL_OR: case REL_AND:
+        case BIT_OR: case BIT_AND: case BIT_EXCL_OR:
+        case RIGHT_SHIFT_ARITH: case LEFT_SHIFT_ARITH: case RIGHT_SHIFT_LOGIC:
+        case NOT_EQ: case LESS_THAN: case LESS_OR_EQ:
+        case EQUAL: case GR_OR_EQ: case GR_THAN:
+            depth--;
+            break;
+        case COND_END:
+            depth -= 2;
+            break;
+        default:
+            break;
+        }
+        if (depth > maxDepth)
+            maxDepth = depth;
+    }
+    return maxDepth;
+}
+
+LIBCOM_API long
+    calcPerformArray(const double * const *pargs, const epicsUInt32 *pcounts,
+        double *presult, epicsUInt32 nelem, const char *pinst)
+{
+    int depth = block_depth(pinst);
+    double *stack, *vars, *ptop;
+    unsigned stored;
+    epicsUInt32 base;
+    long status = 0;
+
+    if (nelem == 0)
+        return 0;
+
+    /* zero'th entry not used */
+    stack = malloc((depth + 1 + CALCPERFORM_NARGS) *
+        CALC_BLOCK * sizeof(double));
+    if (!stack)
+        return -1;
+    vars = stack + (depth + 1) * CALC_BLOCK;
+
+    for (base = 0; base < nelem && !status; base += CALC_BLOCK) {
+        const int n = nelem - base < CALC_BLOCK ? nelem - base : CALC_BLOCK;
+        const char *pc = pinst;
+        double *pnext;
+        epicsInt32 itop;
+        double top;
+        int op, nargs, j;
+
+        ptop = stack;
+        stored = 0;
+
+#define PUSH (ptop += CALC_BLOCK)
+#define POP  (pnext = ptop, ptop -= CALC_BLOCK)
+#define UNARY(expr) \
+        for (j = 0; j < n; j++) { double x = ptop[j]; ptop[j] = (expr); }
+#define BINARY(expr) \
+        POP; \
+        for (j = 0; j < n; j++) { \
+            double x = ptop[j], y = pnext[j]; ptop[j] = (expr); \
+        }
+
+        while ((op = *pc++) != END_EXPRESSION) {
+            switch (op) {
+
+            case LITERAL_DOUBLE:
+                memcpy(&top, pc, sizeof(double));
+                pc += sizeof(double);
+                PUSH;
+                for (j = 0; j < n; j++) ptop[j] = top;
+                break;
+
+            case LITERAL_INT:
+                memcpy(&itop, pc, sizeof(epicsInt32));
+                pc += sizeof(epicsInt32);
+                PUSH;
+                for (j = 0; j < n; j++) ptop[j] = itop;
+                break;
+
+            case FETCH_VAL:
+                PUSH;
+                memcpy(ptop, presult + base, n * sizeof(double));
+                break;
+
+            case FETCH_A: case FETCH_B: case FETCH_C: case FETCH_D:
+            case FETCH_E: case FETCH_F: case FETCH_G: case FETCH_H:
+            case FETCH_I: case FETCH_J: case FETCH_K: case FETCH_L: {
+                int arg = op - FETCH_A;
+
+                PUSH;
+                if (stored & (1u << arg))
+                    memcpy(ptop, vars + arg * CALC_BLOCK, n * sizeof(double));
+                else if (!pargs[arg])
+                    for (j = 0; j < n; j++) ptop[j] = 0.0;
+                else if (pcounts[arg] > 1)
+                    memcpy(ptop, pargs[arg] + base, n * sizeof(double));
+                else {
+                    top = pargs[arg][0];
+                    for (j = 0; j < n; j++) ptop[j] = top;
+                }
+                break;
+            }
+
+            case STORE_A: case STORE_B: case STORE_C: case STORE_D:
+            case STORE_E: case STORE_F: case STORE_G: case STORE_H:
+            case STORE_I: case STORE_J: case STORE_K: case STORE_L: {
+                int arg = op - STORE_A;
+
+                memcpy(vars + arg * CALC_BLOCK, ptop, n * sizeof(double));
+                stored |= 1u << arg;
+                POP;
+                break;
+            }
+
+            case CONST_PI:
+                PUSH;
+                for (j = 0; j < n; j++) ptop[j] = PI;
+                break;
+
+            case CONST_D2R:
+                PUSH;
+                for (j = 0; j < n; j++) ptop[j] = PI/180.;
+                break;
+
+            case CONST_R2D:
+                PUSH;
+                for (j = 0; j < n; j++) ptop[j] = 180./PI;
+                break;
+
+            case UNARY_NEG: UNARY(-x); break;
+            case ADD:       BINARY(x + y); break;
+            case SUB:       BINARY(x - y); break;
+            case MULT:      BINARY(x * y); break;
+            case DIV:       BINARY(x / y); break;
+
+            case MODULO:
+                POP;
+                for (j = 0; j < n; j++) {
+                    itop = (epicsInt32) pnext[j];
+                    if (itop)
+                        ptop[j] = (epicsInt32) ptop[j] % itop;
+                    else
+                        ptop[j] = epicsNAN;
+                }
+                break;
+
+            case POWER:     BINARY(pow(x, y)); break;
+            case ABS_VAL:   UNARY(fabs(x)); break;
+            case EXP:       UNARY(exp(x)); break;
+            case LOG_10:    UNARY(log10(x)); break;
+            case LOG_E:     UNARY(log(x)); break;
+
+            case MAX:
+                nargs = *pc++;
+                while (--nargs) {
+                    BINARY(x < y || isnan(y) ? y : x);
+                }
+                break;
+
+            case MIN:
+                nargs = *pc++;
+                while (--nargs) {
+                    BINARY(x > y || isnan(y) ? y : x);
+                }
+                break;
+
+            case SQU_RT:    UNARY(sqrt(x)); break;
+            case ACOS:      UNARY(acos(x)); break;
+            case ASIN:      UNARY(asin(x)); break;
+            case ATAN:      UNARY(atan(x)); break;
+            case ATAN2:     BINARY(atan2(y, x)); break;  /* Args backwards */
+            case COS:       UNARY(cos(x)); break;
+            case SIN:       UNARY(sin(x)); break;
+            case TAN:       UNARY(tan(x)); break;
+            case COSH:      UNARY(cosh(x)); break;
+            case SINH:      UNARY(sinh(x)); break;
+            case TANH:      UNARY(tanh(x)); break;
+            case CEIL:      UNARY(ceil(x)); break;
+            case FLOOR:     UNARY(floor(x)); break;
+            case FMOD:      BINARY(fmod(x, y)); break;
+
+            case FINITE:
+                nargs = *pc++;
+                UNARY(finite(x));
+                while (--nargs) {
+                    BINARY(finite(x) && y);
+                }
+                break;
+
+            case ISINF:     UNARY(isinf(x)); break;
+
+            case ISNAN:
+                nargs = *pc++;
+                UNARY(isnan(x));
+                while (--nargs) {
+                    BINARY(isnan(x) || y);
+                }
+                break;
+
+            case NINT:
+                UNARY((epicsInt32) (x >= 0 ? x + 0.5 : x - 0.5));
+                break;
+
+            case RANDOM:
+                PUSH;
+                for (j = 0; j < n; j++) ptop[j] = calcRandom();
+                break;
+
+            case REL_OR:    BINARY(x || y); break;
+            case REL_AND:   BINARY(x && y); break;
+            case REL_NOT:   UNARY(!x); break;
+
+            case BIT_OR:    BINARY((double)(d2i(x) | d2i(y))); break;
+            case BIT_AND:   BINARY((double)(d2i(x) & d2i(y))); break;
+            case BIT_EXCL_OR: BINARY((double)(d2i(x) ^ d2i(y))); break;
+            case BIT_NOT:   UNARY((double)~d2i(x)); break;
+
+            case RIGHT_SHIFT_ARITH:
+                BINARY((double)(d2i(x) >> (d2i(y) & 31)));
+                break;
+            case LEFT_SHIFT_ARITH:
+                BINARY((double)(d2i(x) << (d2i(y) & 31)));
+                break;
+            case RIGHT_SHIFT_LOGIC:
+                BINARY((double)(d2ui(x) >> (d2ui(y) & 31u)));
+                break;
+
+            case NOT_EQ:     BINARY(x != y); break;
+            case LESS_THAN:  BINARY(x < y); break;
+            case LESS_OR_EQ: BINARY(x <= y); break;
+            case EQUAL:      BINARY(x == y); break;
+            case GR_OR_EQ:   BINARY(x >= y); break;
+            case GR_THAN:    BINARY(x > y); break;
+
+            case COND_IF:
+            case COND_ELSE:
+                /* Keep the condition and the true result on the stack */
+                break;
+
+            case COND_END: {
+                /* stack holds condition, true result, false result */
+                double *pfalse = ptop;
+                double *ptrue = ptop - CALC_BLOCK;
+
+                ptop -= 2 * CALC_BLOCK;
+                for (j = 0; j < n; j++)
+                    ptop[j] = ptop[j] != 0.0 ? ptrue[j] : pfalse[j];
+                break;
+            }
+
+            default:
+                errlogPrintf("calcPerformArray: Bad Opcode %d at %p\n",
+                    op, pc-1);
+                status = -1;
+                goto done;
+            }
+        }
+
+#undef PUSH
+#undef POP
+#undef UNARY
+#undef BINARY
+
+        /* The stack should now have one item on it, the expression value */
+        if (ptop != stack + CALC_BLOCK) {
+            status = -1;
+            break;
+        }
+        memcpy(presult + base, ptop, n * sizeof(double));
+    }
+
+done:
+    free(stack);
+    return status;
+}
+
 LIBCOM_API long
 calcArgUsage(const char *pinst, unsigned long *pinputs, unsigned long *pstores)
 {
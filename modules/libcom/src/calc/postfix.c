@@ -207,6 +207,292 @@ static int
 }
 
 
+/* Postfix optimizer
+ *
+ * After a successful translation the postfix buffer is rewritten in place:
+ * operators whose operands are all literals are evaluated and replaced by
+ * a literal of the result, and conditionals with a literal condition are
+ * replaced by the branch that would be taken. The output never grows, so
+ * INFIX_TO_POSTFIX_SIZE() still gives a big enough buffer.
+ */
+
+/* Size of the instruction at pinst, including any inline operand */
+static size_t
+    inst_size(const char *pinst)
+{
+    switch (*pinst) {
+    case LITERAL_DOUBLE:
+        return 1 + sizeof(double);
+    case LITERAL_INT:
+        return 1 + sizeof(epicsInt32);
+    case MIN:
+    case MAX:
+    case FINITE:
+    case ISNAN:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+/* Find the END_EXPRESSION that terminates the postfix buffer */
+static char *
+    rpn_end(char *pinst)
+{
+    while (*pinst != END_EXPRESSION)
+        pinst += inst_size(pinst);
+    return pinst;
+}
+
+/* Number of stack values consumed by a pure operator, or 0 if the
+ * instruction cannot be evaluated at compile time.
+ */
+static int
+    pure_nargs(const char *pinst)
+{
+    switch (*pinst) {
+    case UNARY_NEG:     case ABS_VAL:       case EXP:
+    case LOG_10:        case LOG_E:         case SQU_RT:
+    case ACOS:          case ASIN:          case ATAN:
+    case COS:           case COSH:          case SIN:
+    case SINH:          case TAN:           case TANH:
+    case CEIL:          case FLOOR:         case ISINF:
+    case NINT:          case REL_NOT:       case BIT_NOT:
+        return 1;
+    case ADD:           case SUB:           case MULT:
+    case DIV:           case MODULO:        case POWER:
+    case ATAN2:         case FMOD:          case REL_OR:
+    case REL_AND:       case BIT_OR:        case BIT_AND:
+    case BIT_EXCL_OR:   case RIGHT_SHIFT_ARITH:
+    case LEFT_SHIFT_ARITH:                  case RIGHT_SHIFT_LOGIC:
+    case NOT_EQ:        case LESS_THAN:     case LESS_OR_EQ:
+    case EQUAL:         case GR_OR_EQ:      case GR_THAN:
+        return 2;
+    case MIN:
+    case MAX:
+    case FINITE:
+    case ISNAN:
+        return pinst[1];
+    default:
+        return 0;
+    }
+}
+
+/* Is the instruction a push of a value known at compile time? */
+static int
+    is_constant(const char *pinst)
+{
+    switch (*pinst) {
+    case LITERAL_DOUBLE:
+    case LITERAL_INT:
+    case CONST_PI:
+    case CONST_D2R:
+    case CONST_R2D:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/* Evaluate a constant instruction sequence using calcPerform() itself,
+ * so the folded result is exactly what would be calculated at runtime.
+ */
+static int
+    evaluate(const char *pinst, size_t len, double *presult)
+{
+    char rpn[CALCPERFORM_STACK * (1 + sizeof(double)) + 3];
+    double args[CALCPERFORM_NARGS] = {0};
+
+    if (len >= sizeof(rpn))
+        return -1;
+    memcpy(rpn, pinst, len);
+    rpn[len] = END_EXPRESSION;
+    *presult = 0;
+    return calcPerform(args, presult, rpn) ? -1 : 0;
+}
+
+/* Write a literal for value, returning its size if it fits in maxlen */
+static size_t
+    put_literal(char *pout, double value, size_t maxlen)
+{
+    if (value >= -2147483648.0 && value <= 2147483647.0) {
+        epicsInt32 lit_i = (epicsInt32) value;
+        double back = lit_i;
+
+        /* Bitwise compare preserves -0.0 */
+        if (memcmp(&back, &value, sizeof(double)) == 0) {
+            if (maxlen < 1 + sizeof(epicsInt32))
+                return 0;
+            *pout++ = LITERAL_INT;
+            memcpy(pout, &lit_i, sizeof(epicsInt32));
+            return 1 + sizeof(epicsInt32);
+        }
+    }
+    if (maxlen < 1 + sizeof(double))
+        return 0;
+    *pout++ = LITERAL_DOUBLE;
+    memcpy(pout, &value, sizeof(double));
+    return 1 + sizeof(double);
+}
+
+/* Replace operators that have only constant operands with their result.
+ * Runs a simulation of the runtime stack that records where each value
+ * was pushed in the output and whether it's a known constant.
+ */
+static void
+    fold_constants(char *prpn)
+{
+    struct {
+        char *pos;
+        int constant;
+    } stack[CALCPERFORM_STACK + 1];
+    int depth = 0;
+    const char *pin = prpn;
+    char *pout = prpn;
+    int i;
+
+    while (*pin != END_EXPRESSION) {
+        size_t size = inst_size(pin);
+        int nargs = pure_nargs(pin);
+        char op = *pin;
+
+        memmove(pout, pin, size);
+        pin += size;
+
+        if (nargs > 0) {
+            int folded = FALSE;
+
+            depth -= nargs;
+            for (i = depth; i < depth + nargs; i++)
+                if (!stack[i].constant)
+                    break;
+            if (i == depth + nargs) {
+                char *start = stack[depth].pos;
+                size_t len = pout + size - start;
+                double value;
+                size_t newlen;
+
+                if (!evaluate(start, len, &value) &&
+                    (newlen = put_literal(start, value, len))) {
+                    pout = start + newlen;
+                    folded = TRUE;
+                }
+            }
+            if (!folded)
+                pout += size;
+            stack[depth++].constant = folded;
+            continue;
+        }
+
+        switch (op) {
+        case STORE_A: case STORE_B: case STORE_C: case STORE_D:
+        case STORE_E: case STORE_F: case STORE_G: case STORE_H:
+        case STORE_I: case STORE_J: case STORE_K: case STORE_L:
+        case COND_IF:
+        case COND_ELSE:
+            /* Values pushed before these instructions can't be folded
+             * with anything that follows them */
+            depth--;
+            for (i = 0; i < depth; i++)
+                stack[i].constant = FALSE;
+            break;
+        case COND_END:
+            stack[depth - 1].constant = FALSE;
+            break;
+        default:
+            stack[depth].pos = pout;
+            stack[depth++].constant = is_constant(pout);
+        }
+        pout += size;
+    }
+    *pout = END_EXPRESSION;
+}
+
+/* Search for the conditional instruction matching match, skipping any
+ * nested conditionals, as calcPerform() does at runtime.
+ */
+static char *
+    cond_find(char *pinst, int match)
+{
+    int count = 1;
+
+    while (*pinst != END_EXPRESSION) {
+        if (*pinst == match && --count == 0)
+            return pinst;
+        if (*pinst == COND_IF)
+            count++;
+        pinst += inst_size(pinst);
+    }
+    return NULL;
+}
+
+/* Does the code between pinst and pend read or write any arguments? */
+static int
+    uses_args(const char *pinst, const char *pend)
+{
+    while (pinst < pend) {
+        if ((*pinst >= FETCH_A && *pinst <= FETCH_L) ||
+            (*pinst >= STORE_A && *pinst <= STORE_L))
+            return TRUE;
+        pinst += inst_size(pinst);
+    }
+    return FALSE;
+}
+
+/* Remove the untaken branch of the first conditional that has a constant
+ * condition, returning TRUE if anything was changed. Branches that use any
+ * arguments are kept, so calcArgUsage() reports the same inputs and stores
+ * as it did for the unoptimized expression.
+ */
+static int
+    prune_conditional(char *prpn)
+{
+    char *prev = NULL;
+    char *pinst = prpn;
+
+    while (*pinst != END_EXPRESSION) {
+        if (*pinst == COND_IF && prev && is_constant(prev)) {
+            char *pelse = cond_find(pinst + 1, COND_ELSE);
+            char *pend = pelse ? cond_find(pelse + 1, COND_END) : NULL;
+            double cond;
+
+            if (pend && !evaluate(prev, pinst - prev, &cond) &&
+                !(cond != 0.0 ? uses_args(pelse, pend) :
+                                uses_args(pinst, pelse))) {
+                char *pafter = pend + 1;
+                size_t tail = rpn_end(pafter) - pafter + 1;
+                char *pout = prev;
+
+                if (cond != 0.0) {
+                    size_t len = pelse - (pinst + 1);
+
+                    memmove(pout, pinst + 1, len);
+                    pout += len;
+                } else {
+                    size_t len = pend - (pelse + 1);
+
+                    memmove(pout, pelse + 1, len);
+                    pout += len;
+                }
+                memmove(pout, pafter, tail);
+                return TRUE;
+            }
+        }
+        prev = pinst;
+        pinst += inst_size(pinst);
+    }
+    return FALSE;
+}
+
+static void
+    optimize(char *prpn)
+{
+    do {
+        fold_constants(prpn);
+    } while (prune_conditional(prpn));
+}
+
+
 /* postfix
  *
  * convert an infix expression to a postfix expression
@@ -491,6 +777,7 @@ LIBCOM_API long
         *perror = CALC_ERR_INCOMPLETE;
         goto bad;
     }
+    optimize(pdest);
     return 0;
 
 bad:
@@ -579,6 +866,7 @@ LIBCOM_API void
     /* Numeric */
         "CEIL",
         "FLOOR",
+        "FMOD",
         "FINITE",
         "ISINF",
         "ISNAN",
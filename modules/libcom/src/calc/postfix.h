@@ -21,6 +21,7 @@
 #define INCpostfixh
 
 #include "libComAPI.h"
+#include "epicsTypes.h"
 
 /** \brief Number of input arguments to a calc expression (A-L) */
 #define CALCPERFORM_NARGS 12
@@ -129,6 +130,11 @@ extern "C" {
  *
  * \note "n" must count the terminating nil byte too.
  *
+ * The generated postfix code is optimized: operators whose operands are all
+ * constants are replaced by their result, and conditionals with a constant
+ * condition are replaced by the branch that would be taken at runtime if
+ * the other branch doesn't use any arguments, so calcArgUsage() is unchanged.
+ *
  * -# The **infix expressions** that can be used are very similar
  * to the C expression syntax, but with some additions and subtle
  * differences in operator meaning and precedence. The string may
@@ -321,6 +327,32 @@ LIBCOM_API long
 LIBCOM_API long
     calcPerform(double *parg, double *presult, const char *ppostfix);
 
+/** \brief Run the calculation engine element-wise over arrays
+ *
+ * Evaluates the postfix expression once for each of \p nelem elements.
+ * Arguments given as arrays supply a different value for each element,
+ * scalar arguments are used for every element (broadcast). VAL fetches the
+ * previous value of the same element of \p presult. An assignment only
+ * affects the element being calculated, the argument arrays are not
+ * modified. Most expressions are evaluated a block of elements at a time
+ * using loops that compilers can vectorize.
+ *
+ * \param pargs Array of CALCPERFORM_NARGS pointers to the values of the
+ * arguments A-L. A NULL pointer gives an argument the value 0.
+ * \param pcounts Array of CALCPERFORM_NARGS element counts. An argument
+ * with a count of 0 or 1 is a scalar, otherwise its array must have at
+ * least \p nelem elements.
+ * \param presult Array of \p nelem elements for the results.
+ * \param nelem Number of elements to calculate.
+ * \param ppostfix The postfix expression created by postfix().
+ * \return Status value 0 for OK, or non-zero if an error is discovered
+ * during the evaluation process.
+ * \since UNRELEASED
+ */
+LIBCOM_API long
+    calcPerformArray(const double * const *pargs, const epicsUInt32 *pcounts,
+        double *presult, epicsUInt32 nelem, const char *ppostfix);
+
 /** \brief Find the inputs and outputs of an expression
  *
  * Software using the calc subsystem may need to know what expression
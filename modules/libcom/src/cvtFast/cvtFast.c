@@ -14,32 +14,126 @@
  *    Date:            12 January 1993
  */
 
+#include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#include <math.h>
 
 #include "cvtFast.h"
 #include "epicsMath.h"
 #include "epicsStdio.h"
 
 /*
- * These routines convert numbers up to +/- 10,000,000.
- * They defer to sprintf() for numbers requiring more than
- * 8 places of precision.
+ * These routines convert numbers up to +/- 10,000,000 in fixed-point
+ * notation, or up to +/- 1e16 with at most 3 places of precision.  The
+ * result is correctly rounded, the same as sprintf() "%.*f" gives.
+ * They defer to sprintf() for numbers requiring more than 8 places of
+ * precision.
  */
-static epicsInt32 frac_multiplier[] =
+static const epicsUInt32 frac_multiplier[] =
     {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
 
+/* Round value * 10^precision to the nearest integer, ties to even.
+ * value is split into its 53 bit mantissa and binary exponent, and the
+ * scaling and rounding are done in exact integer arithmetic.  Returns
+ * 0 if the result does not fit in 64 bits.
+ */
+static int scaleRound(double value, int precision, epicsUInt64 *pn)
+{
+    int exp;
+    epicsUInt64 m = (epicsUInt64) ldexp(frexp(value, &exp), 53);
+    epicsUInt64 p = frac_multiplier[precision];
+    epicsUInt64 a = (m & 0xffffffffu) * p;
+    epicsUInt64 b = (m >> 32) * p;
+    epicsUInt64 lo = a + (b << 32);
+    epicsUInt64 hi = (b >> 32) + (lo < a);
+    epicsUInt64 n, rem, half;
+    int shift = 53 - exp;
+
+    /* value * 10^precision == (hi:lo) / 2^shift, and hi:lo < 2^80 */
+    if (shift <= 0) {
+        if (hi || shift < -63 || (shift < 0 && lo >> (64 + shift)))
+            return 0;
+        *pn = lo << -shift;
+        return 1;
+    }
+    if (shift > 81) {
+        *pn = 0;
+        return 1;
+    }
+    if (shift < 64) {
+        if (hi >> shift)
+            return 0;
+        n = (lo >> shift) | (hi << (64 - shift));
+        rem = lo & (((epicsUInt64) 1 << shift) - 1);
+        half = (epicsUInt64) 1 << (shift - 1);
+        if (rem > half || (rem == half && (n & 1)))
+            n++;
+    }
+    else if (shift == 64) {
+        n = hi;
+        half = (epicsUInt64) 1 << 63;
+        if (lo > half || (lo == half && (n & 1)))
+            n++;
+    }
+    else {
+        shift -= 64;
+        n = hi >> shift;
+        rem = hi & (((epicsUInt64) 1 << shift) - 1);
+        half = (epicsUInt64) 1 << (shift - 1);
+        if (rem > half || (rem == half && (lo || (n & 1))))
+            n++;
+    }
+    *pn = n;
+    return 1;
+}
+
+static int fixedToString(double value, char *pdest, int precision)
+{
+    char digits[32];
+    char *pd = digits + sizeof(digits);
+    char *startAddr = pdest;
+    epicsUInt64 n;
+    size_t len;
+    int i;
+
+    /* determine the sign */
+    if (value < 0) {
+        *pdest++ = '-';
+        value = -value;
+    }
+
+    if (!scaleRound(value, precision, &n)) {
+        sprintf(startAddr, "%.*f", precision, value);
+        return (int)strlen(startAddr);
+    }
+
+    /* digits from the right, fraction first */
+    for (i = 0; i < precision; i++) {
+        *--pd = (char)(n % 10) + '0';
+        n /= 10;
+    }
+    if (precision > 0)
+        *--pd = '.';
+    do {
+        *--pd = (char)(n % 10) + '0';
+        n /= 10;
+    } while (n);
+
+    len = digits + sizeof(digits) - pd;
+    memcpy(pdest, pd, len);
+    pdest += len;
+    *pdest = 0;
+
+    return((int)(pdest - startAddr));
+}
+
 int cvtFloatToString(float flt_value, char *pdest,
     epicsUInt16 precision)
 {
-    int got_one, i;
-    epicsInt32  whole, iplace, number, fraction, fplace;
-    float       ftemp;
-    char        *startAddr;
-
     /* can this routine handle this conversion */
     if (isnan(flt_value) || precision > 8 ||
-        flt_value > 10000000.0 || flt_value < -10000000.0) {
+        flt_value >= 1e8 || flt_value <= -1e8) {
         if (precision > 8 || flt_value >= 1e8 || flt_value <= -1e8) {
             if (precision > 12) precision = 12; /* FIXME */
             sprintf(pdest, "%*.*e", precision+6, precision, (double) flt_value);
@@ -49,63 +143,10 @@ int cvtFloatToString(float flt_value, char *pdest,
         }
         return((int)strlen(pdest));
     }
-    startAddr = pdest;
+    if ((flt_value > 10000000.0 || flt_value < -10000000.0) && precision > 3)
+        precision = 3; /* FIXME */
 
-    /* determine the sign */
-    if (flt_value < 0){
-        *pdest++ = '-';
-        flt_value = -flt_value;
-    };
-
-    /* remove the whole number portion */
-    whole = (epicsInt32)flt_value;
-    ftemp = flt_value - whole;
-
-    /* multiplier to convert fractional portion to integer */
-    fplace = frac_multiplier[precision];
-    fraction = (epicsInt32)(ftemp * fplace * 10);
-    fraction = (fraction + 5) / 10;     /* round up */
-
-    /* determine rounding into the whole number portion */
-    if ((fraction / fplace) >= 1){
-        whole++;
-        fraction -= fplace;
-    }
-
-    /* whole numbers */
-    got_one = 0;
-    for (iplace = 10000000; iplace >= 1; iplace /= 10){
-        if (whole >= iplace){
-            got_one = 1;
-            number = whole / iplace;
-            whole = whole - (number * iplace);
-            *pdest = number + '0';
-            pdest++;
-        }else if (got_one){
-            *pdest = '0';
-            pdest++;
-        }
-    }
-    if (!got_one){
-        *pdest = '0';
-        pdest++;
-    }
-
-    /* fraction */
-    if (precision > 0){
-    /* convert fractional portion to ASCII */
-        *pdest = '.';
-        pdest++;
-        for (fplace /= 10, i = precision; i > 0; fplace /= 10,i--){
-            number = fraction / fplace;
-            fraction -= number * fplace;
-            *pdest = number + '0';
-            pdest++;
-        }
-    }
-    *pdest = 0;
-
-    return((int)(pdest - startAddr));
+    return fixedToString(flt_value, pdest, precision);
 }
 
 int cvtDoubleToString(
@@ -113,13 +154,9 @@ int cvtDoubleToString(
     char  *pdest,
     epicsUInt16 precision)
 {
-    epicsUInt16 got_one,i;
-    epicsInt32  whole,iplace,number,fraction,fplace;
-    double      ftemp;
-    char        *startAddr;
-
     /* can this routine handle this conversion */
-    if (isnan(flt_value) || precision > 8 || flt_value > 10000000.0 || flt_value < -10000000.0) {
+    if (isnan(flt_value) || precision > 8 ||
+        flt_value > 1e16 || flt_value < -1e16) {
         if (precision > 8 || flt_value > 1e16 || flt_value < -1e16) {
             if(precision>17) precision=17;
             sprintf(pdest,"%*.*e",precision+7,precision,
@@ -130,65 +167,12 @@ int cvtDoubleToString(
         }
         return((int)strlen(pdest));
     }
-    startAddr = pdest;
+    if ((flt_value > 10000000.0 || flt_value < -10000000.0) && precision > 3)
+        precision = 3;
 
-    /* determine the sign */
-    if (flt_value < 0){
-        *pdest++ = '-';
-        flt_value = -flt_value;
-    };
-
-    /* remove the whole number portion */
-    whole = (epicsInt32)flt_value;
-    ftemp = flt_value - whole;
-
-    /* multiplier to convert fractional portion to integer */
-    fplace = frac_multiplier[precision];
-    fraction = (epicsInt32)(ftemp * fplace * 10);
-    fraction = (fraction + 5) / 10;     /* round up */
-
-    /* determine rounding into the whole number portion */
-    if ((fraction / fplace) >= 1){
-        whole++;
-        fraction -= fplace;
-    }
-
-    /* whole numbers */
-    got_one = 0;
-    for (iplace = 10000000; iplace >= 1; iplace /= 10){
-        if (whole >= iplace){
-            got_one = 1;
-            number = whole / iplace;
-            whole = whole - (number * iplace);
-            *pdest = number + '0';
-            pdest++;
-        }else if (got_one){
-            *pdest = '0';
-            pdest++;
-        }
-    }
-    if (!got_one){
-        *pdest = '0';
-        pdest++;
-    }
-
-    /* fraction */
-    if (precision > 0){
-    /* convert fractional portion to ASCII */
-        *pdest = '.';
-        pdest++;
-        for (fplace /= 10, i = precision; i > 0; fplace /= 10,i--){
-            number = fraction / fplace;
-            fraction -= number * fplace;
-            *pdest = number + '0';
-            pdest++;
-        }
-    }
-    *pdest = 0;
-
-    return((int)(pdest - startAddr));
+    return fixedToString(flt_value, pdest, precision);
 }
-
+
 /*
  * These routines are provided for backwards compatibility,
  * extensions such as MEDM, edm and histtool use them.
@@ -11,8 +11,9 @@
  * Implementation of core macro substitution library (macLib)
  *
  * The implementation is fairly unsophisticated and linked lists are
- * used to store macro values. Typically there will will be only a
- * small number of macros and performance won't be a problem. Special
+ * used to store macro values. A hash index keyed on the macro name
+ * points into the list so that looking up a name does not require a
+ * walk of every definition in every scope. Special
  * measures are taken to avoid unnecessary expansion of macros whose
  * definitions reference other macros. Whenever a macro is created,
  * modified or deleted, a "dirty" flag is set; this causes a full
@@ -29,6 +30,7 @@
 #include "dbDefs.h"
 #include "errlog.h"
 #include "dbmf.h"
+#include "epicsString.h"
 #include "macLib.h"
 
 
@@ -39,6 +41,8 @@
  */
 typedef struct mac_entry {
     ELLNODE     node;           /* prev and next pointers */
+    struct mac_entry *hnext;    /* next entry in same index bucket */
+    unsigned    hash;           /* hash of entry name */
     char        *name;          /* entry name */
     char        *type;          /* entry type */
     char        *rawval;        /* raw (unexpanded) value */
@@ -50,6 +54,26 @@ typedef struct mac_entry {
     int         level;          /* scoping level */
 } MAC_ENTRY;
 
+/*
+ * Segment of a compiled template; either literal text which is copied
+ * verbatim, or a complete macro reference "$(...)" or "${...}"
+ */
+typedef struct mac_segment {
+    size_t      offset;         /* start of segment in template text */
+    size_t      length;         /* length of segment */
+    int         isRef;          /* segment is a macro reference? */
+} MAC_SEGMENT;
+
+/*
+ * Compiled template; segments and text are allocated with the structure
+ */
+struct mac_template {
+    char        *text;          /* copy of the source string */
+    size_t      nseg;           /* number of segments */
+    int         fallback;       /* couldn't be split, use macExpandString() */
+    MAC_SEGMENT seg[1];         /* segments (actually nseg of them) */
+};
+
 
 /*** Local function prototypes ***/
 
@@ -57,9 +81,7 @@ typedef struct mac_entry {
  * These static functions perform low-level operations on macro entries
  */
 static MAC_ENTRY *first   ( MAC_HANDLE *handle );
-static MAC_ENTRY *last    ( MAC_HANDLE *handle );
 static MAC_ENTRY *next    ( MAC_ENTRY  *entry );
-static MAC_ENTRY *previous( MAC_ENTRY  *entry );
 
 static MAC_ENTRY *create( MAC_HANDLE *handle, const char *name, int special );
 static MAC_ENTRY *lookup( MAC_HANDLE *handle, const char *name, int special );
@@ -72,6 +94,13 @@ static void       trans ( MAC_HANDLE *handle, MAC_ENTRY *entry, int level,
 static void       refer ( MAC_HANDLE *handle, MAC_ENTRY *entry, int level,
                           const char **rawval, char **value, char *valend );
 
+static int        indexInit  ( MAC_HANDLE *handle, unsigned size );
+static void       indexAdd   ( MAC_HANDLE *handle, MAC_ENTRY *entry );
+static void       indexRemove( MAC_HANDLE *handle, MAC_ENTRY *entry );
+
+static const char *skipTrans( const char *rawval, const char *term );
+static const char *skipRef  ( const char *rawval );
+
 static void cpy2val( const char *src, char **value, const char *valend );
 static char *Strdup( const char *string );
 
@@ -89,6 +118,12 @@ static char *Strdup( const char *string );
 #define FLAG_SUPPRESS_WARNINGS  0x1
 #define FLAG_USE_ENVIRONMENT    0x80
 
+/*
+ * Initial number of hash index buckets (must be a power of 2). The index
+ * is doubled whenever the number of entries exceeds twice its size.
+ */
+#define INDEX_INITIAL_SIZE      16
+
 
 /*** Library routines ***/
 
@@ -126,6 +161,13 @@ epicsStdCall macCreateHandle(
     handle->debug = 0;
     handle->flags = 0;
     ellInit( &handle->list );
+    handle->index = NULL;
+    handle->indexSize = 0;
+    if ( indexInit( handle, INDEX_INITIAL_SIZE ) < 0 ) {
+        errlogPrintf( "macCreateHandle: failed to allocate index\n" );
+        dbmfFree( handle );
+        return -1;
+    }
 
     /* use environment variables if so specified */
     if (pairs && pairs[0] && !strcmp(pairs[0],"") && pairs[1] && !strcmp(pairs[1],"environ") && !pairs[3]) {
@@ -135,7 +177,7 @@ epicsStdCall macCreateHandle(
         /* if supplied, load macro definitions */
         for ( ; pairs && pairs[0]; pairs += 2 ) {
             if ( macPutValue( handle, pairs[0], pairs[1] ) < 0 ) {
-                dbmfFree( handle );
+                macDeleteHandle( handle );
                 return -1;
             }
         }
@@ -226,6 +268,195 @@ epicsStdCall macExpandString(
     return length;
 }
 
+/*
+ * Split a string into literal text and macro references so that it can
+ * be expanded repeatedly without re-scanning the literal text
+ *
+ * The scan mirrors what trans() does at level 0, where quotes and
+ * escapes are retained: literal text is copied verbatim, and macro
+ * references (not inside single quotes) are handed to refer() whole.
+ * Strings with an unterminated reference are not split but are simply
+ * expanded by macExpandString()
+ */
+MAC_TEMPLATE *                  /* NULL = ERROR */
+epicsStdCall macCompileTemplate(
+    const char  *src )          /* source string */
+{
+    MAC_TEMPLATE *tmpl;
+    size_t length = strlen( src );
+    size_t nseg = 0;
+    int pass;
+
+    /* first pass counts segments, second pass fills them in */
+    for ( pass = 0, tmpl = NULL; pass < 2; pass++ ) {
+        const char *r, *start;
+        int fallback = FALSE;
+        char quote = 0;
+
+        if ( pass == 1 ) {
+            tmpl = malloc( sizeof( MAC_TEMPLATE ) +
+                           ( nseg ? nseg - 1 : 0 ) * sizeof( MAC_SEGMENT ) +
+                           length + 1 );
+            if ( tmpl == NULL ) {
+                errlogPrintf( "macCompileTemplate: failed to allocate\n" );
+                return NULL;
+            }
+            tmpl->text = ( char * ) &tmpl->seg[nseg ? nseg : 1];
+            memcpy( tmpl->text, src, length + 1 );
+            tmpl->nseg = 0;
+            tmpl->fallback = FALSE;
+        }
+        nseg = 0;
+
+        for ( r = start = src; *r; r++ ) {
+            if ( quote ) {
+                if ( *r == quote )
+                    quote = 0;
+            }
+            else if ( *r == '"' || *r == '\'' ) {
+                quote = *r;
+            }
+
+            if ( *r == '$' && *( r + 1 ) != '\0' &&
+                 strchr( "({", *( r + 1 ) ) != NULL && quote != '\'' ) {
+                const char *end = skipRef( r );
+
+                if ( end == NULL ) {
+                    fallback = TRUE;
+                    break;
+                }
+                if ( r > start ) {
+                    if ( tmpl ) {
+                        tmpl->seg[nseg].offset = start - src;
+                        tmpl->seg[nseg].length = r - start;
+                        tmpl->seg[nseg].isRef  = FALSE;
+                    }
+                    nseg++;
+                }
+                if ( tmpl ) {
+                    tmpl->seg[nseg].offset = r - src;
+                    tmpl->seg[nseg].length = end + 1 - r;
+                    tmpl->seg[nseg].isRef  = TRUE;
+                }
+                nseg++;
+                r = end;
+                start = r + 1;
+            }
+            else if ( *r == '\\' && *( r + 1 ) != '\0' ) {
+                r++;
+            }
+        }
+
+        if ( fallback ) {
+            nseg = 0;
+            if ( tmpl ) {
+                tmpl->fallback = TRUE;
+                break;
+            }
+            continue;
+        }
+        if ( r > start ) {
+            if ( tmpl ) {
+                tmpl->seg[nseg].offset = start - src;
+                tmpl->seg[nseg].length = r - start;
+                tmpl->seg[nseg].isRef  = FALSE;
+            }
+            nseg++;
+        }
+    }
+
+    tmpl->nseg = nseg;
+    return tmpl;
+}
+
+/*
+ * Expand a compiled template; equivalent to calling macExpandString()
+ * on the string the template was compiled from
+ */
+long                            /* strlen(dest), <0 if any macros are */
+                                /* undefined */
+epicsStdCall macExpandTemplate(
+    MAC_HANDLE  *handle,        /* opaque handle */
+
+    const MAC_TEMPLATE *tmpl,   /* compiled template */
+
+    char        *dest,          /* destination string */
+
+    long        capacity )      /* capacity of destination buffer (dest) */
+{
+    MAC_ENTRY entry;
+    char *d, *valend;
+    size_t i;
+    long length;
+
+    /* check handle */
+    if ( handle == NULL || handle->magic != MAC_MAGIC ) {
+        errlogPrintf( "macExpandTemplate: NULL or invalid handle\n" );
+        return -1;
+    }
+
+    if ( tmpl == NULL || capacity <= 1 )
+        return -1;
+
+    if ( tmpl->fallback )
+        return macExpandString( handle, tmpl->text, dest, capacity );
+
+    /* debug output */
+    if ( handle->debug & 1 )
+        printf( "macExpandTemplate( %s, capacity = %ld )\n",
+                tmpl->text, capacity );
+
+    /* expand raw values if necessary */
+    if ( expand( handle ) < 0 )
+        errlogPrintf( "macExpandTemplate: failed to expand raw values\n" );
+
+    /* fill in necessary fields in fake macro entry structure */
+    entry.name  = tmpl->text;
+    entry.type  = "string";
+    entry.error = FALSE;
+
+    d  = dest;
+    *d = '\0';
+    valend = d + capacity - 1;
+    for ( i = 0; i < tmpl->nseg; i++ ) {
+        const MAC_SEGMENT *seg = &tmpl->seg[i];
+        const char *r = tmpl->text + seg->offset;
+
+        if ( seg->isRef ) {
+            refer( handle, &entry, 0, &r, &d, valend );
+        }
+        else {
+            size_t n = seg->length;
+
+            if ( n > ( size_t ) ( valend - d ) )
+                n = valend - d;
+            memcpy( d, r, n );
+            d += n;
+            *d = '\0';
+        }
+    }
+
+    /* return +/- #chars copied depending on successful expansion */
+    length = d - dest;
+    length = ( entry.error ) ? -length : length;
+
+    /* debug output */
+    if ( handle->debug & 1 )
+        printf( "macExpandTemplate() -> %ld\n", length );
+
+    return length;
+}
+
+/*
+ * Free a compiled template
+ */
+void
+epicsStdCall macDeleteTemplate(
+    MAC_TEMPLATE *tmpl )        /* compiled template */
+{
+    free( tmpl );
+}
+
 /*
  * Define the value of a macro. A NULL value deletes the macro if it
  * already existed
@@ -381,6 +612,7 @@ epicsStdCall macDeleteHandle(
 
     /* clear magic field and free context structure */
     handle->magic = 0;
+    free( handle->index );
     dbmfFree( handle );
 
     return 0;
@@ -513,14 +745,6 @@ static MAC_ENTRY *first( MAC_HANDLE *handle )
     return ( MAC_ENTRY * ) ellFirst( &handle->list );
 }
 
-/*
- * Return pointer to last macro entry (could be preprocessor macro)
- */
-static MAC_ENTRY *last( MAC_HANDLE *handle )
-{
-    return ( MAC_ENTRY * ) ellLast( &handle->list );
-}
-
 /*
  * Return pointer to next macro entry (could be preprocessor macro)
  */
@@ -529,14 +753,6 @@ static MAC_ENTRY *next( MAC_ENTRY *entry )
     return ( MAC_ENTRY * ) ellNext( ( ELLNODE * ) entry );
 }
 
-/*
- * Return pointer to previous macro entry (could be preprocessor macro)
- */
-static MAC_ENTRY *previous( MAC_ENTRY *entry )
-{
-    return ( MAC_ENTRY * ) ellPrevious( ( ELLNODE * ) entry );
-}
-
 /*
  * Create new macro entry (can assume it doesn't exist)
  */
@@ -562,6 +778,7 @@ static MAC_ENTRY *create( MAC_HANDLE *handle, const char *name, int special )
             entry->level   = handle->level;
 
             ellAdd( list, ( ELLNODE * ) entry );
+            indexAdd( handle, entry );
         }
     }
 
@@ -574,14 +791,17 @@ static MAC_ENTRY *create( MAC_HANDLE *handle, const char *name, int special )
 static MAC_ENTRY *lookup( MAC_HANDLE *handle, const char *name, int special )
 {
     MAC_ENTRY *entry;
+    unsigned hash = epicsStrHash( name, 0 );
 
     if ( handle->debug & 2 )
         printf( "lookup-> level = %d, name = %s, special = %d\n",
                 handle->level, name, special );
 
-    /* search backwards so scoping works */
-    for ( entry = last( handle ); entry != NULL; entry = previous( entry ) ) {
-        if ( entry->special != special )
+    /* index buckets hold the most recent definition first, so scoping
+       works just like searching the list backwards */
+    for ( entry = handle->index[hash & ( handle->indexSize - 1 )];
+          entry != NULL; entry = entry->hnext ) {
+        if ( entry->hash != hash || entry->special != special )
             continue;
         if ( strcmp( name, entry->name ) == 0 )
             break;
@@ -628,6 +848,7 @@ static void delete( MAC_HANDLE *handle, MAC_ENTRY *entry )
 {
     ELLLIST *list = &handle->list;
 
+    indexRemove( handle, entry );
     ellDelete( list, ( ELLNODE * ) entry );
 
     dbmfFree( entry->name );
@@ -925,6 +1146,121 @@ cleanup:
     *value = v;
 }
 
+/*
+ * Allocate a new (empty) name index of the given size, then index all
+ * existing entries in list order so the newest entries end up first
+ */
+static int indexInit( MAC_HANDLE *handle, unsigned size )
+{
+    MAC_ENTRY **index = calloc( size, sizeof( MAC_ENTRY * ) );
+    MAC_ENTRY *entry;
+
+    if ( index == NULL )
+        return -1;
+
+    free( handle->index );
+    handle->index = ( void ** ) index;
+    handle->indexSize = size;
+
+    for ( entry = first( handle ); entry != NULL; entry = next( entry ) ) {
+        MAC_ENTRY **bucket = &index[entry->hash & ( size - 1 )];
+
+        entry->hnext = *bucket;
+        *bucket = entry;
+    }
+    return 0;
+}
+
+/*
+ * Add a newly created entry (always the last in the list) to the index,
+ * growing the index if it's getting crowded. Failing to grow isn't an
+ * error, the chains just get longer
+ */
+static void indexAdd( MAC_HANDLE *handle, MAC_ENTRY *entry )
+{
+    MAC_ENTRY **bucket;
+
+    entry->hash = epicsStrHash( entry->name, 0 );
+
+    if ( ( unsigned ) ellCount( &handle->list ) > 2 * handle->indexSize &&
+         indexInit( handle, 2 * handle->indexSize ) == 0 )
+        return;     /* entry was indexed by indexInit() */
+
+    bucket = ( MAC_ENTRY ** )
+        &handle->index[entry->hash & ( handle->indexSize - 1 )];
+    entry->hnext = *bucket;
+    *bucket = entry;
+}
+
+/*
+ * Remove an entry from the index
+ */
+static void indexRemove( MAC_HANDLE *handle, MAC_ENTRY *entry )
+{
+    MAC_ENTRY **pnext = ( MAC_ENTRY ** )
+        &handle->index[entry->hash & ( handle->indexSize - 1 )];
+
+    while ( *pnext != NULL ) {
+        if ( *pnext == entry ) {
+            *pnext = entry->hnext;
+            break;
+        }
+        pnext = &( *pnext )->hnext;
+    }
+}
+
+/*
+ * Step over raw value text the same way trans() does without expanding
+ * anything. Returns a pointer to the terminator, or NULL if the end of
+ * the string was reached first
+ */
+static const char *skipTrans( const char *r, const char *term )
+{
+    char quote = 0;
+
+    for ( ; strchr( term, *r ) == NULL; r++ ) {
+        if ( quote ) {
+            if ( *r == quote )
+                quote = 0;
+        }
+        else if ( *r == '"' || *r == '\'' ) {
+            quote = *r;
+        }
+
+        if ( *r == '$' && *( r + 1 ) != '\0' &&
+             strchr( "({", *( r + 1 ) ) != NULL && quote != '\'' ) {
+            r = skipRef( r );
+            if ( r == NULL )
+                return NULL;
+        }
+        else if ( *r == '\\' && *( r + 1 ) != '\0' ) {
+            r++;
+        }
+    }
+
+    return ( *r == '\0' ) ? NULL : r;
+}
+
+/*
+ * Step over a macro reference the same way refer() does. Returns a
+ * pointer to the closing ')' or '}', or NULL if it wasn't terminated
+ */
+static const char *skipRef( const char *r )
+{
+    const char *macEnd = ( *( r + 1 ) == '(' ) ? "=,)" : "=,}";
+
+    r = skipTrans( r + 2, macEnd );
+    if ( r != NULL && *r == '=' )
+        r = skipTrans( r + 1, macEnd + 1 );
+    while ( r != NULL && *r == ',' ) {
+        r = skipTrans( r + 1, macEnd );
+        if ( r != NULL && *r == '=' )
+            r = skipTrans( r + 1, macEnd + 1 );
+    }
+
+    return r;
+}
+
 /*
  * Copy a string, honoring the 'end of destination string' pointer
  * Returns with **value pointing to the '\0' terminator
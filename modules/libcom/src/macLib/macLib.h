@@ -47,8 +47,14 @@ typedef struct {
     int         debug;          /**< \brief debugging level */
     ELLLIST     list;           /**< \brief macro name / value list */
     int         flags;          /**< \brief operating mode flags */
+    void        **index;        /**< \brief hashed name index into list */
+    unsigned    indexSize;      /**< \brief number of index buckets */
 } MAC_HANDLE;
 
+/** \brief Pre-parsed macro template, see macCompileTemplate().
+ */
+typedef struct mac_template MAC_TEMPLATE;
+
 /** \name Core Library
  *  The core library provides a minimal set of basic operations.
  *  @{
@@ -206,6 +212,52 @@ epicsStdCall macReportMacros(
 );
 /** @} */
 
+/** \name Compiled Templates
+ * A string that has to be expanded many times with different sets of
+ * macro definitions can be split into literal text and macro references
+ * just once, saving the cost of re-scanning the literal text on every
+ * expansion. Expanding a compiled template gives exactly the same result
+ * and return value as calling macExpandString() on the original string.
+ * @{
+ */
+
+/**
+ * \brief Pre-parse a string which may contain macro references.
+ * \return Compiled template, or NULL on allocation failure.
+ *
+ * The template keeps its own copy of \c src and is independent of any
+ * macro substitution context, so it may be expanded with any handle.
+ */
+LIBCOM_API MAC_TEMPLATE *
+epicsStdCall macCompileTemplate(
+    const char  *src            /**< source string */
+);
+
+/**
+ * \brief Expand a compiled template.
+ * \return Returns the length of the expanded string, <0 if any macro are
+ * undefined. See macExpandString().
+ */
+LIBCOM_API long
+epicsStdCall macExpandTemplate(
+    MAC_HANDLE  *handle,        /**< opaque handle */
+
+    const MAC_TEMPLATE *tmpl,   /**< template from macCompileTemplate() */
+
+    char        *dest,          /**< destination string */
+
+    long        capacity        /**< capacity of destination buffer (dest) */
+);
+
+/**
+ * \brief Free a compiled template.
+ */
+LIBCOM_API void
+epicsStdCall macDeleteTemplate(
+    MAC_TEMPLATE *tmpl          /**< template, may be NULL */
+);
+/** @} */
+
 /** \name Utility Library
  * These convenience functions are intended for applications to use and
  * provide a more convenient interface for some purposes.
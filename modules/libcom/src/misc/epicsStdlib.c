@@ -146,6 +146,86 @@ epicsParseULLong(const char *str, unsigned long long *to, int base, char **units
     return 0;
 }
 
+/* Convert a plain decimal number without calling strtod().
+ * With no more than 19 significant digits and a mantissa up to 2^53
+ * both the mantissa and a power of ten up to 1e22 are exact doubles,
+ * so one multiply or divide gives the correctly rounded result.  That
+ * only holds if the FPU does not keep extra precision.  Returns 0 for
+ * anything else, which strtod() must then convert.
+ */
+static int
+fastStrtod(const char *str, double *to, char **endp)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    static const double pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const char *cp = str;
+    epicsUInt64 mant = 0;
+    int ndigits = 0, exp10 = 0, negative = 0, any = 0;
+    double value;
+
+    if (*cp == '+' || *cp == '-')
+        negative = *cp++ == '-';
+    if (cp[0] == '0' && (cp[1] == 'x' || cp[1] == 'X'))
+        return 0;
+
+    for (; isdigit((int)*cp); cp++) {
+        any = 1;
+        if (mant || *cp != '0') {
+            if (++ndigits > 19)
+                return 0;
+            mant = mant * 10 + (*cp - '0');
+        }
+    }
+    if (*cp == '.') {
+        for (++cp; isdigit((int)*cp); cp++) {
+            any = 1;
+            if (mant || *cp != '0') {
+                if (++ndigits > 19)
+                    return 0;
+                mant = mant * 10 + (*cp - '0');
+            }
+            exp10--;
+        }
+    }
+    if (!any)
+        return 0;
+
+    if (*cp == 'e' || *cp == 'E') {
+        const char *ep = cp + 1;
+        int eneg = 0, e = 0;
+
+        if (*ep == '+' || *ep == '-')
+            eneg = *ep++ == '-';
+        if (isdigit((int)*ep)) {
+            for (; isdigit((int)*ep); ep++)
+                if (e < 10000)
+                    e = e * 10 + (*ep - '0');
+            exp10 += eneg ? -e : e;
+            cp = ep;
+        }
+    }
+
+    if (mant == 0)
+        value = 0;
+    else if (mant > ((epicsUInt64) 1 << 53) || exp10 < -22 || exp10 > 22)
+        return 0;
+    else if (exp10 < 0)
+        value = (double) mant / pow10[-exp10];
+    else
+        value = (double) mant * pow10[exp10];
+
+    *to = negative ? -value : value;
+    *endp = (char *) cp;
+    return 1;
+#else
+    return 0;
+#endif
+}
+
 LIBCOM_API int
 epicsParseDouble(const char *str, double *to, char **units)
 {
@@ -157,7 +237,8 @@ epicsParseDouble(const char *str, double *to, char **units)
         ++str;
 
     errno = 0;
-    value = epicsStrtod(str, &endp);
+    if (!fastStrtod(str, &value, &endp))
+        value = epicsStrtod(str, &endp);
 
     if (endp == str)
         return S_stdlib_noConversion;
@@ -144,12 +144,163 @@ static void testUseIP(void)
     testAccess("rw", 0);
 }
 
+static const char calc_config[] = ""
+        "UAG(ops) {alice}\n"
+        "ASG(DEFAULT) {RULE(0, NONE)}\n"
+        "ASG(permit) {INPA(\"x\") RULE(1, READ) RULE(1, WRITE) {UAG(ops) CALC(\"A=1\")}}\n"
+        ;
+
+static void countChange(ASCLIENTPVT client, asClientStatus status)
+{
+    int *count = (int *)asGetClientPvt(client);
+
+    if(count) (*count)++;
+}
+
+static void setInput(ASG *pasg, double value)
+{
+    pasg->pavalue[0] = value;
+    pasg->inpBad = 0;
+    pasg->inpChanged = 1;
+    asComputeAsg(pasg);
+}
+
+static void testCalcRules(void)
+{
+    static const char *users[] = {"alice", "alice", "bob"};
+    ASMEMBERPVT asp = 0;
+    ASCLIENTPVT clients[3];
+    int count[3];
+    char host[] = "localhost";
+    ASG *pasg;
+    int i;
+
+    testDiag("testCalcRules()");
+    asCheckClientIP = 0;
+
+    testOk1(asInitMem(calc_config, NULL)==0);
+    testOk1(asAddMember(&asp, "permit")==0);
+
+    pasg = (ASG *)ellFirst(&pasbase->asgList);
+    while(pasg && strcmp(pasg->name, "permit")!=0)
+        pasg = (ASG *)ellNext(&pasg->node);
+    if(!pasg)
+        testAbort("ASG permit not found");
+
+    for(i=0; i<3; i++) {
+        count[i] = 0;
+        if(asAddClient(&clients[i], asp, 0, users[i], host))
+            testAbort("asAddClient failed");
+        asPutClientPvt(clients[i], &count[i]);
+        asRegisterClientCallback(clients[i], countChange);
+        count[i] = 0;
+    }
+
+    setInput(pasg, 1.0);
+    testOk(count[0]==1 && count[1]==1 && count[2]==0,
+           "Input 1 -> callbacks %d %d %d", count[0], count[1], count[2]);
+    testOk1(asCheckPut(clients[0]) && asCheckPut(clients[1]));
+    testOk1(asCheckGet(clients[2]) && !asCheckPut(clients[2]));
+
+    setInput(pasg, 1.0);
+    testOk(count[0]==1 && count[1]==1 && count[2]==0,
+           "Unchanged -> callbacks %d %d %d", count[0], count[1], count[2]);
+
+    setInput(pasg, 0.0);
+    testOk(count[0]==2 && count[1]==2 && count[2]==0,
+           "Input 0 -> callbacks %d %d %d", count[0], count[1], count[2]);
+    testOk1(!asCheckPut(clients[0]) && asCheckGet(clients[0]));
+
+    /* Moving a client to another user re-evaluates it alone */
+    testOk1(asChangeClient(clients[2], 0, "alice", host)==0);
+    setInput(pasg, 1.0);
+    testOk(count[0]==3 && count[1]==3 && count[2]==1,
+           "Changed user -> callbacks %d %d %d", count[0], count[1], count[2]);
+    testOk1(asCheckPut(clients[2]));
+
+    for(i=0; i<3; i++)
+        asRemoveClient(&clients[i]);
+    asRemoveMember(&asp);
+}
+
+static const char inputs_config[] = ""
+        "UAG(ops) {alice}\n"
+        "UAG(eng) {bob}\n"
+        "ASG(DEFAULT) {RULE(0, NONE)}\n"
+        "ASG(two) {INPA(\"x\") INPB(\"y\")\n"
+        "    RULE(1, WRITE) {UAG(ops) CALC(\"A=1\")}\n"
+        "    RULE(1, WRITE) {UAG(eng) CALC(\"B=1\")}}\n"
+        ;
+
+static void testInputs(void)
+{
+    static const char *users[] = {"alice", "bob"};
+    ASMEMBERPVT asp = 0;
+    ASCLIENTPVT clients[2];
+    int count[2];
+    char host[] = "localhost";
+    ASG *pasg;
+    int i;
+
+    testDiag("testInputs()");
+    asCheckClientIP = 0;
+
+    testOk1(asInitMem(inputs_config, NULL)==0);
+    testOk1(asAddMember(&asp, "two")==0);
+
+    pasg = (ASG *)ellFirst(&pasbase->asgList);
+    while(pasg && strcmp(pasg->name, "two")!=0)
+        pasg = (ASG *)ellNext(&pasg->node);
+    if(!pasg)
+        testAbort("ASG two not found");
+
+    for(i=0; i<2; i++) {
+        if(asAddClient(&clients[i], asp, 0, users[i], host))
+            testAbort("asAddClient failed");
+        asPutClientPvt(clients[i], &count[i]);
+        asRegisterClientCallback(clients[i], countChange);
+        count[i] = 0;
+    }
+
+    pasg->pavalue[0] = 1.0;
+    pasg->inpBad = 0;
+    pasg->inpChanged = 1;
+    asComputeAsg(pasg);
+    testOk(count[0]==1 && count[1]==0,
+           "INPA 1 -> callbacks %d %d", count[0], count[1]);
+
+    pasg->pavalue[1] = 1.0;
+    pasg->inpChanged = 2;
+    asComputeAsg(pasg);
+    testOk(count[0]==1 && count[1]==1,
+           "INPB 1 -> callbacks %d %d", count[0], count[1]);
+    testOk1(asCheckPut(clients[0]) && asCheckPut(clients[1]));
+
+    /* Disconnects mark an input bad without setting inpChanged */
+    pasg->inpBad = 2;
+    asComputeAsg(pasg);
+    testOk(count[0]==1 && count[1]==2,
+           "INPB bad -> callbacks %d %d", count[0], count[1]);
+    testOk1(asCheckPut(clients[0]) && !asCheckPut(clients[1]));
+
+    pasg->inpBad = 0;
+    asComputeAsg(pasg);
+    testOk(count[0]==1 && count[1]==3,
+           "INPB good -> callbacks %d %d", count[0], count[1]);
+
+    for(i=0; i<2; i++)
+        asRemoveClient(&clients[i]);
+    asRemoveMember(&asp);
+}
+
 MAIN(aslibtest)
 {
-    testPlan(27);
+    testPlan(46);
     testSyntaxErrors();
     testHostNames();
     testUseIP();
+    testCalcRules();
+    testInputs();
     errlogFlush();
     return testDone();
 }
@@ -15,6 +15,7 @@
 #include <iostream>
 
 #include "epicsStdio.h"
+#include "epicsStdlib.h"
 #include "cvtFast.h"
 #include "epicsTime.h"
 #include "testMain.h"
@@ -242,6 +243,145 @@ private:
 };
 
 
+// The fixed-point conversion cvtDoubleToString() used before it was
+// made correctly rounded, for comparison.
+
+static int legacyDoubleToString(double flt_value, char *pdest, int precision)
+{
+    static const int frac_multiplier[] =
+        {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+    int got_one, i;
+    int whole, iplace, number, fraction, fplace;
+    double ftemp;
+    char *startAddr;
+
+    if (std::isnan(flt_value) || precision > 8 ||
+        flt_value > 10000000.0 || flt_value < -10000000.0) {
+        if (precision > 8 || flt_value > 1e16 || flt_value < -1e16) {
+            if (precision > 17) precision = 17;
+            sprintf(pdest, "%*.*e", precision + 7, precision, flt_value);
+        } else {
+            if (precision > 3) precision = 3;
+            sprintf(pdest, "%.*f", precision, flt_value);
+        }
+        return (int) strlen(pdest);
+    }
+    startAddr = pdest;
+
+    if (flt_value < 0) {
+        *pdest++ = '-';
+        flt_value = -flt_value;
+    }
+
+    whole = (int) flt_value;
+    ftemp = flt_value - whole;
+
+    fplace = frac_multiplier[precision];
+    fraction = (int) (ftemp * fplace * 10);
+    fraction = (fraction + 5) / 10;
+
+    if ((fraction / fplace) >= 1) {
+        whole++;
+        fraction -= fplace;
+    }
+
+    got_one = 0;
+    for (iplace = 10000000; iplace >= 1; iplace /= 10) {
+        if (whole >= iplace) {
+            got_one = 1;
+            number = whole / iplace;
+            whole = whole - (number * iplace);
+            *pdest++ = number + '0';
+        } else if (got_one) {
+            *pdest++ = '0';
+        }
+    }
+    if (!got_one)
+        *pdest++ = '0';
+
+    if (precision > 0) {
+        *pdest++ = '.';
+        for (fplace /= 10, i = precision; i > 0; fplace /= 10, i--) {
+            number = fraction / fplace;
+            fraction -= number * fplace;
+            *pdest++ = number + '0';
+        }
+    }
+    *pdest = 0;
+
+    return (int) (pdest - startAddr);
+}
+
+class PerfLegacyDouble : public PerfConverter {
+    static const int digits = 17;
+public:
+    PerfLegacyDouble ()
+    {
+        for (int i = 0; i <= digits; i++)
+            measured[i] = 0;    // Some targets seem to need this
+    }
+    int maxPrecision (void) const { return digits; }
+    const char *name (void) const { return "legacy cvtDouble"; }
+    void target (double srcD, float srcF, char *dst, size_t len, int prec) const
+    {
+        legacyDoubleToString ( srcD, dst, prec );
+        legacyDoubleToString ( srcD, dst, prec );
+        legacyDoubleToString ( srcD, dst, prec );
+        legacyDoubleToString ( srcD, dst, prec );
+        legacyDoubleToString ( srcD, dst, prec );
+
+        legacyDoubleToString ( srcD, dst, prec );
+        legacyDoubleToString ( srcD, dst, prec );
+        legacyDoubleToString ( srcD, dst, prec );
+        legacyDoubleToString ( srcD, dst, prec );
+        legacyDoubleToString ( srcD, dst, prec );
+    }
+    void add(int prec, double elapsed) { measured[prec] += elapsed; }
+    double total (int prec) {
+        double total = measured[prec];
+        measured[prec] = 0;
+        return total;
+    }
+private:
+    double measured[digits+1];
+};
+
+
+class PerfSNPrintfFixed : public PerfConverter {
+    static const int digits = 17;
+public:
+    PerfSNPrintfFixed ()
+    {
+        for (int i = 0; i <= digits; i++)
+            measured[i] = 0;    // Some targets seem to need this
+    }
+    int maxPrecision (void) const { return digits; }
+    const char *name (void) const { return "epicsSnprintf %f"; }
+    void target (double srcD, float srcF, char *dst, size_t len, int prec) const
+    {
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+        epicsSnprintf ( dst, len, "%.*f", prec, srcD );
+    }
+    void add(int prec, double elapsed) { measured[prec] += elapsed; }
+    double total (int prec) {
+        double total = measured[prec];
+        measured[prec] = 0;
+        return total;
+    }
+private:
+    double measured[digits+1];
+};
+
+
 class PerfSNPrintf : public PerfConverter {
     static const int digits = 17;
 public:
@@ -334,12 +474,54 @@ private:
 };
 
 
+// String to double conversions, epicsParseDouble() against strtod()
+
+static void parsePerform (void)
+{
+    static const unsigned nStrings = 1000;
+    static const unsigned nPasses = 100;
+    char (*strings)[32] = new char [nStrings][32];
+    double sum = 0, value;
+    unsigned i, pass;
+
+    for ( i = 0; i < nStrings; i++ ) {
+        double val = rand ();
+        val /= (RAND_MAX + 1.0);
+        val *= 20000.0;
+        val -= 10000.0;
+        epicsSnprintf ( strings[i], sizeof(strings[i]), "%.*f", i % 7, val );
+    }
+
+    epicsTime beg = epicsTime :: getMonotonic ();
+    for ( pass = 0; pass < nPasses; pass++ )
+        for ( i = 0; i < nStrings; i++ ) {
+            epicsParseDouble ( strings[i], &value, NULL );
+            sum += value;
+        }
+    epicsTime mid = epicsTime :: getMonotonic ();
+    for ( pass = 0; pass < nPasses; pass++ )
+        for ( i = 0; i < nStrings; i++ )
+            sum -= strtod ( strings[i], NULL );
+    epicsTime end = epicsTime :: getMonotonic ();
+
+    printf ( "Parsing fixed-point strings, -10000..+10000\n\n" );
+    printf ( "epicsParseDouble  %11.9f sec\n",
+        ( mid - beg ) / nPasses / nStrings );
+    printf ( "strtod            %11.9f sec\n",
+        ( end - mid ) / nPasses / nStrings );
+    printf ( "(residual %g)\n\n", sum );
+
+    delete [] strings;
+}
+
 MAIN(cvtFastPerform)
 {
-    Perf t(4);
+    Perf t(6);
 
     t.addConverter( new PerfCvtFastFloat );
     t.addConverter( new PerfCvtFastDouble );
+    t.addConverter( new PerfLegacyDouble );
+    t.addConverter( new PerfSNPrintfFixed );
     t.addConverter( new PerfSNPrintf );
     t.addConverter( new PerfStreamBuf );
 
@@ -353,5 +535,7 @@ MAIN(cvtFastPerform)
     t.execute (5, false);
 #endif
 
+    parsePerform ();
+
     return 0;
 }
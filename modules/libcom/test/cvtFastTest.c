@@ -15,6 +15,8 @@
 #include <math.h>
 #include <float.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "epicsUnitTest.h"
 #include "cvtFast.h"
@@ -35,6 +37,68 @@
     testOk(!status, "epicsParse"#typ"('%s') OK", buf); \
     testOk(fabs(val_##typ - lit) < 0.5 * pow(10, -prec), #lit " => '%s'", buf);
 
+#define tryFixed(typ, lit, prec, str) \
+    cvt##typ##ToString(lit, buf, prec); \
+    testOk(strcmp(buf, str) == 0, "cvt"#typ"ToString(" #lit ", %d) -> \"%s\" (\"%s\")", \
+        prec, buf, str);
+
+/* Random value of magnitude up to 10^maxExp with some exact ties */
+static double randomValue(int maxExp, int prec)
+{
+    double val = rand() / (RAND_MAX + 1.0) * pow(10, rand() % (maxExp + 1));
+
+    if (rand() % 4 == 0)    /* halfway between two outputs */
+        val = (floor(val * pow(10, prec)) + 0.5) / pow(10, prec);
+    return rand() % 2 ? val : -val;
+}
+
+/* Compare against sprintf("%.*f") over the fixed-point range */
+static void checkRounding(void)
+{
+    char buf[80], ref[80];
+    unsigned long i, nd = 0, nf = 0;
+
+    for (i = 0; i < 100000; i++) {
+        int prec = i % 9;
+        double dval = randomValue(7, prec);
+        float fval = (float) randomValue(7, prec);
+
+        cvtDoubleToString(dval, buf, prec);
+        sprintf(ref, "%.*f", prec, dval);
+        if (strcmp(buf, ref) && nd++ < 5)
+            testDiag("double %.17g prec %d: '%s' != '%s'", dval, prec, buf, ref);
+
+        cvtFloatToString(fval, buf, prec);
+        sprintf(ref, "%.*f", prec, (double) fval);
+        if (strcmp(buf, ref) && nf++ < 5)
+            testDiag("float %.9g prec %d: '%s' != '%s'", fval, prec, buf, ref);
+    }
+    testOk(nd == 0, "cvtDoubleToString matches sprintf, %lu differ", nd);
+    testOk(nf == 0, "cvtFloatToString matches sprintf, %lu differ", nf);
+}
+
+/* Compare epicsParseDouble() against strtod() on printed values */
+static void checkParse(void)
+{
+    char buf[80];
+    unsigned long i, nbad = 0;
+
+    for (i = 0; i < 100000; i++) {
+        double val = ldexp(rand() / (RAND_MAX + 1.0), rand() % 200 - 100);
+        double got = 0, ref;
+
+        switch (i % 3) {
+        case 0: sprintf(buf, "%.*g", (int)(i % 18), val); break;
+        case 1: sprintf(buf, "%.*e", (int)(i % 18), -val); break;
+        case 2: sprintf(buf, "%.*f", (int)(i % 10), val * 1e6); break;
+        }
+        ref = strtod(buf, NULL);
+        if ((epicsParseDouble(buf, &got, NULL) || memcmp(&got, &ref, sizeof(got)))
+            && nbad++ < 5)
+            testDiag("'%s' gives %.17g, strtod %.17g", buf, got, ref);
+    }
+    testOk(nbad == 0, "epicsParseDouble matches strtod, %lu differ", nbad);
+}
 
 MAIN(cvtFastTest)
 {
@@ -55,7 +119,7 @@ MAIN(cvtFastTest)
 #endif
 #endif
 
-    testPlan(1062);
+    testPlan(1075);
 
     /* Arguments: type, value, num chars */
     testDiag("------------------------------------------------------");
@@ -456,5 +520,34 @@ MAIN(cvtFastTest)
     tryFString(Double, 1e+17, 4, 11);
     tryFString(Double, 1e+17, 5, 12);
 
+    testDiag("------------------------------------------------------");
+    testDiag("** Correct rounding **");
+    tryFixed(Double, 0.5, 0, "0");
+    tryFixed(Double, 2.5, 0, "2");
+    tryFixed(Double, 0.125, 2, "0.12");
+    tryFixed(Double, 1.005, 2, "1.00");
+    tryFixed(Double, 1e15 + 0.5, 3, "1000000000000000.500");
+    tryFixed(Float, 0.375f, 2, "0.38");
+    checkRounding();
+
+    testDiag("------------------------------------------------------");
+    testDiag("** Parsing **");
+    {
+        char *units = "";
+
+        status = epicsParseDouble(" 1.5e ", &val_Double, &units);
+        testOk(!status && val_Double == 1.5 && strcmp(units, "e ") == 0,
+               "'1.5e' parses as 1.5, units '%s'", units);
+        status = epicsParseDouble("0x10", &val_Double, NULL);
+        testOk(!status && val_Double == 16, "'0x10' parses as %g", val_Double);
+        status = epicsParseDouble("-0", &val_Double, NULL);
+        testOk(!status && val_Double == 0 && 1 / val_Double < 0,
+               "'-0' parses as negative zero");
+        status = epicsParseDouble("1e23", &val_Double, NULL);
+        testOk(!status && val_Double == strtod("1e23", NULL),
+               "'1e23' parses as %.17g", val_Double);
+    }
+    checkParse();
+
     return testDone();
 }
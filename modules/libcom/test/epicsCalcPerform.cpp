@@ -0,0 +1,123 @@
+/*************************************************************************\
+* SPDX-License-Identifier: EPICS
+* EPICS BASE is distributed subject to a Software License Agreement found
+* in file LICENSE that is included with this distribution.
+\*************************************************************************/
+
+/*
+ * Calc expression evaluation speed.
+ *
+ * Reports the time calcPerform() takes for some typical expressions, and
+ * compares calcPerformArray() with calling calcPerform() for each element.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "epicsTypes.h"
+#include "epicsTime.h"
+#include "postfix.h"
+#include "testMain.h"
+
+#define ARRAY_ELEMENTS 150
+
+static void benchCalc(const char *expr)
+{
+    double args[CALCPERFORM_NARGS] = {
+        1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0
+    };
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    const int count = 200000;
+    short err;
+    double result = 0.0;
+    epicsUInt64 start, end;
+    double secs;
+
+    if (!rpn || postfix(expr, rpn, &err)) {
+        printf("benchCalc: Can't compile '%s'\n", expr);
+        free(rpn);
+        return;
+    }
+
+    start = epicsMonotonicGet();
+    for (int i = 0; i < count; i++)
+        calcPerform(args, &result, rpn);
+    end = epicsMonotonicGet();
+
+    secs = (end - start) * 1e-9;
+    printf("%10.0f ops/sec, %6.1f ns/op: %s\n", count / secs,
+           secs * 1e9 / count, expr);
+    free(rpn);
+}
+
+static void benchArrayCalc(const char *expr)
+{
+    static double vals[CALCPERFORM_NARGS][ARRAY_ELEMENTS];
+    double result[ARRAY_ELEMENTS];
+    const double *pargs[CALCPERFORM_NARGS];
+    epicsUInt32 counts[CALCPERFORM_NARGS];
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    const int count = 2000;
+    short err;
+    epicsUInt64 start, mid, end;
+
+    if (!rpn || postfix(expr, rpn, &err)) {
+        printf("benchArrayCalc: Can't compile '%s'\n", expr);
+        free(rpn);
+        return;
+    }
+
+    /* A and B vary, the other arguments are scalars */
+    for (int n = 0; n < ARRAY_ELEMENTS; n++) {
+        vals[0][n] = n * 0.75 - 40.0;
+        vals[1][n] = (n * 37) % 101 - 30.0;
+    }
+    for (int k = 0; k < CALCPERFORM_NARGS; k++) {
+        if (k > 1)
+            vals[k][0] = k + 1.0;
+        pargs[k] = vals[k];
+        counts[k] = k < 2 ? ARRAY_ELEMENTS : 1;
+    }
+
+    start = epicsMonotonicGet();
+    for (int i = 0; i < count; i++) {
+        for (int n = 0; n < ARRAY_ELEMENTS; n++) {
+            double args[CALCPERFORM_NARGS];
+
+            for (int k = 0; k < CALCPERFORM_NARGS; k++)
+                args[k] = vals[k][k < 2 ? n : 0];
+            calcPerform(args, &result[n], rpn);
+        }
+    }
+    mid = epicsMonotonicGet();
+    for (int i = 0; i < count; i++)
+        calcPerformArray(pargs, counts, result, ARRAY_ELEMENTS, rpn);
+    end = epicsMonotonicGet();
+
+    printf("%6.1f ns/element per element, %6.1f ns/element as array: %s\n",
+           (mid - start) / (double) count / ARRAY_ELEMENTS,
+           (end - mid) / (double) count / ARRAY_ELEMENTS, expr);
+    free(rpn);
+}
+
+MAIN(epicsCalcPerform)
+{
+    printf("calcPerform():\n");
+    benchCalc("A");
+    benchCalc("A+B");
+    benchCalc("A*B+C*D-E/F");
+    benchCalc("A<B?C:D");
+    benchCalc("SIN(A*D2R)*B+C");
+    benchCalc("MAX(A,B,C,D)");
+    benchCalc("A+(2*3+4)/(5-1)*B");
+    benchCalc("(A&1)|(B<<2)|(C>>1)");
+
+    printf("\ncalcPerformArray(), %d elements:\n", ARRAY_ELEMENTS);
+    benchArrayCalc("A-B");
+    benchArrayCalc("A*B+C*D-E/F");
+    benchArrayCalc("A<B?C:D");
+    benchArrayCalc("SIN(A*D2R)*B+C");
+
+    return 0;
+}
@@ -158,6 +158,67 @@ void testBadExpr(const char *expr, short expected_err) {
     free(rpn);
 }
 
+/* Array arguments for testArrayCalc, A and B vary */
+#define ARRAY_ELEMENTS 150
+
+static void fillArrayArgs(double (*vals)[ARRAY_ELEMENTS], epicsUInt32 nelem,
+    const double **pargs, epicsUInt32 *pcounts)
+{
+    for (epicsUInt32 n = 0; n < nelem; n++) {
+        vals[0][n] = n * 0.75 - 40.0;
+        vals[1][n] = (n * 37) % 101 - 30.0;
+    }
+    for (int k = 0; k < CALCPERFORM_NARGS; k++) {
+        if (k > 1)
+            vals[k][0] = k + 1.0;
+        pargs[k] = vals[k];
+        pcounts[k] = k < 2 ? nelem : 1;
+    }
+}
+
+void testArrayCalc(const char *expr) {
+    /* Compare calcPerformArray() with calcPerform() on each element */
+    static double vals[CALCPERFORM_NARGS][ARRAY_ELEMENTS];
+    double result[ARRAY_ELEMENTS];
+    const double *pargs[CALCPERFORM_NARGS];
+    epicsUInt32 counts[CALCPERFORM_NARGS];
+    char *rpn = (char*)malloc(INFIX_TO_POSTFIX_SIZE(strlen(expr)+1));
+    short err;
+    int bad = 0;
+
+    if (!rpn || postfix(expr, rpn, &err)) {
+        testFail("calcPerformArray: Can't compile '%s'", expr);
+        free(rpn);
+        return;
+    }
+
+    fillArrayArgs(vals, ARRAY_ELEMENTS, pargs, counts);
+    for (int n = 0; n < ARRAY_ELEMENTS; n++)
+        result[n] = n;
+    if (calcPerformArray(pargs, counts, result, ARRAY_ELEMENTS, rpn)) {
+        testFail("calcPerformArray: error evaluating '%s'", expr);
+        free(rpn);
+        return;
+    }
+
+    for (int n = 0; n < ARRAY_ELEMENTS; n++) {
+        double args[CALCPERFORM_NARGS];
+        double expected = n;
+
+        for (int k = 0; k < CALCPERFORM_NARGS; k++)
+            args[k] = vals[k][k < 2 ? n : 0];
+        calcPerform(args, &expected, rpn);
+        if (!(result[n] == expected ||
+              (isnan(result[n]) && isnan(expected)))) {
+            if (!bad++)
+                testDiag("Element %d: expected %g, got %g",
+                         n, expected, result[n]);
+        }
+    }
+    testOk(!bad, "calcPerformArray %s (%d bad elements)", expr, bad);
+    free(rpn);
+}
+
 /* Test an expression that is also valid C code */
 #define testExpr(expr) testCalc(#expr, expr);
 
@@ -298,7 +359,7 @@ MAIN(epicsCalcTest)
     const double a=1.0, b=2.0, c=3.0, d=4.0, e=5.0, f=6.0,
                  g=7.0, h=8.0, i=9.0, j=10.0, k=11.0, l=12.0;
 
-    testPlan(637);
+    testPlan(670);
 
     /* LITERAL_OPERAND elements */
     testExpr(0);
@@ -938,6 +999,27 @@ MAIN(epicsCalcTest)
     testArgs("12.1;A:=0;B:=A;C:=B;D:=C", 0, A_A|A_B|A_C|A_D);
     testArgs("13.1;B:=A;A:=B;C:=D;D:=C", A_A|A_D, A_A|A_B|A_C|A_D);
 
+    // Constant folding and conditional elimination
+    testCalc("1/(0*-1)", -Inf);
+    testCalc("(1?2:3)+A", 3);
+    testCalc("(0?2:3)+A", 4);
+    testCalc("1?(0?A:B):C", 2);
+    testCalc("NaN?A:B", 1);
+    testCalc("A:=2;(1+2)*A", 6);
+    testCalc("MAX(1,2,A)+MIN(3,4)", 5);
+    testCalc("1+2?3:4", 3);
+    testCalc("A?2+3:4*5", 5);
+    testCalc("B?(1?C:D):(0?E:F)", 3);
+    // Branches that use arguments are kept for calcArgUsage()
+    testArgs("1?A:B", A_A|A_B, 0);
+    testArgs("0?A:B", A_A|A_B, 0);
+    testArgs("1+1>2?A:B", A_A|A_B, 0);
+    testArgs("A?B:C", A_A|A_B|A_C, 0);
+    testArgs("B:=1?C:D;B", A_C|A_D, A_B);
+    testArgs("1?2:A", A_A, 0);
+    testArgs("0?A:2", A_A, 0);
+    testArgs("(1?2:3)+A", A_A, 0);
+
     // Malformed expressions
     testBadExpr("0x0.1", CALC_ERR_SYNTAX);
     testBadExpr("1*", CALC_ERR_INCOMPLETE);
@@ -1012,5 +1094,22 @@ MAIN(epicsCalcTest)
     testUInt32Calc("-1431655766.1 << 0.1", 0xaaaaaaaau);
     testUInt32Calc("2863311530.1 << 0.1", 0xaaaaaaaau);
 
+    // Element-wise evaluation of arrays
+    testArrayCalc("A");
+    testArrayCalc("C");
+    testArrayCalc("A+B*C-D/E");
+    testArrayCalc("-A**2+VAL");
+    testArrayCalc("A%7");
+    testArrayCalc("A<B?A:B");
+    testArrayCalc("A>0?(B>0?1:2):(B>0?3:C)");
+    testArrayCalc("MAX(A,B,C)");
+    testArrayCalc("MIN(A,B/0,-C)");
+    testArrayCalc("FINITE(A,LN(B))");
+    testArrayCalc("ISNAN(SQRT(A),C)");
+    testArrayCalc("(A&3)|(B<<1)^~C");
+    testArrayCalc("SIN(A*D2R)+ATAN2(A,B)+NINT(B/3)");
+    testArrayCalc("C:=A*2;A:=B;A+C");
+    testArrayCalc("A && B || !C");
+
     return testDone();
 }
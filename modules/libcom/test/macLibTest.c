@@ -22,6 +22,21 @@
 
 MAC_HANDLE *h;
 
+/* A compiled template must expand identically to macExpandString() */
+static void tcheck(const char *str, const char *expect, long expect_status)
+{
+    char output[MAC_SIZE] = {'\0'};
+    MAC_TEMPLATE *tmpl = macCompileTemplate(str);
+    long status = macExpandTemplate(h, tmpl, output, MAC_SIZE);
+
+    testOk(status == expect_status && !strcmp(output, expect),
+        "template %s => %s", str, output);
+    if (status != expect_status)
+        testDiag("Return status was %ld, expected %ld",
+                 status, expect_status);
+    macDeleteTemplate(tmpl);
+}
+
 static void check(const char *str, const char *expect)
 {
     char output[MAC_SIZE] = {'\0'};
@@ -40,6 +55,8 @@ static void check(const char *str, const char *expect)
         testDiag("Return status was %ld, expected %ld",
                  status, expect_error ? -expect_len : expect_len);
     }
+
+    tcheck(str, output, status);
 }
 
 static void ovcheck(void)
@@ -64,9 +81,81 @@ static void ovcheck(void)
     testOk(output[53] == '~', "sentinel character %x, expect 7e, (~)", output[53]);
 }
 
+static void scopecheck(void)
+{
+    char name[16], value[16], output[MAC_SIZE];
+    int i, ok;
+
+    /* Enough definitions to grow the index several times */
+    macPushScope(h);
+    for (i = 0; i < 1000; i++) {
+        sprintf(name, "S%d", i);
+        sprintf(value, "outer%d", i);
+        macPutValue(h, name, value);
+    }
+    macPushScope(h);
+    for (i = 0; i < 1000; i += 2) {
+        sprintf(name, "S%d", i);
+        sprintf(value, "inner%d", i);
+        macPutValue(h, name, value);
+    }
+
+    for (ok = 1, i = 0; i < 1000; i++) {
+        sprintf(name, "S%d", i);
+        sprintf(value, "%s%d", (i & 1) ? "outer" : "inner", i);
+        if (macGetValue(h, name, output, MAC_SIZE) < 0 ||
+            strcmp(output, value)) {
+            testDiag("%s = \"%s\", expected \"%s\"", name, output, value);
+            ok = 0;
+            break;
+        }
+    }
+    testOk(ok, "Inner scope hides outer definitions");
+
+    macPopScope(h);
+    for (ok = 1, i = 0; i < 1000; i++) {
+        sprintf(name, "S%d", i);
+        sprintf(value, "outer%d", i);
+        if (macGetValue(h, name, output, MAC_SIZE) < 0 ||
+            strcmp(output, value)) {
+            testDiag("%s = \"%s\", expected \"%s\"", name, output, value);
+            ok = 0;
+            break;
+        }
+    }
+    testOk(ok, "Outer definitions restored by macPopScope()");
+
+    macPopScope(h);
+    testOk(macGetValue(h, "S0", NULL, 0) < 0 &&
+           macGetValue(h, "S999", NULL, 0) < 0,
+        "All definitions removed by macPopScope()");
+}
+
+static void templatecheck(void)
+{
+    char output[MAC_SIZE];
+    MAC_TEMPLATE *tmpl = macCompileTemplate("record(ai, \"$(P)$(R=ai)\") '$(P)'");
+    long status;
+
+    macPushScope(h);
+    macPutValue(h, "P", "a:");
+    status = macExpandTemplate(h, tmpl, output, MAC_SIZE);
+    testOk(status > 0 && !strcmp(output, "record(ai, \"a:ai\") '$(P)'"),
+        "Template expansion 1 => %s", output);
+
+    macPutValue(h, "P", "b:");
+    macPutValue(h, "R", "bo");
+    status = macExpandTemplate(h, tmpl, output, MAC_SIZE);
+    testOk(status > 0 && !strcmp(output, "record(ai, \"b:bo\") '$(P)'"),
+        "Template expansion 2 => %s", output);
+    macPopScope(h);
+
+    macDeleteTemplate(tmpl);
+}
+
 MAIN(macLibTest)
 {
-    testPlan(93);
+    testPlan(183);
 
     if (macCreateHandle(&h, NULL))
         testAbort("macCreateHandle() failed");
@@ -221,6 +310,8 @@ MAIN(macLibTest)
     check("${FOO}", "!$(BAR)");
 
     ovcheck();
+    scopecheck();
+    templatecheck();
 
     return testDone();
 }